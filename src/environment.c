@@ -2,7 +2,9 @@
 
 // The caller should ensure that the node's symbol number in the symbol table
 //   will be unique.
-// The string name points to is copied. name must not be NULL.
+// The string name points to is not copied, and must outlive the node; outside
+//   of tests it is always a name interned by the global symbol table (see
+//   intern_symbol_name()). name must not be NULL.
 // The returned Symbol_Node is the caller's (i.e., the symbol table's)
 //   responsibility to free.
 Symbol_Node* create_symbol_node(unsigned int symbol_idx, \
@@ -15,8 +17,9 @@ Symbol_Node* create_symbol_node(unsigned int symbol_idx, \
         exit(-1);
     }
     new_node->symbol_idx = symbol_idx;
-    new_node->name = strdup(name);
+    new_node->name = name;
     new_node->type = type;
+    new_node->boxed = false;
     new_node->value = value;
     new_node->next = NULL;
     return new_node;
@@ -26,10 +29,8 @@ Symbol_Node* create_error_symbol_node(interpreter_error err_code) {
     return create_symbol_node(0, "", TYPE_ERROR, (tp_value){.idx=err_code});
 }
 
-// The offset allows a temporary symbol table (used while parsing for easy
-//   walkback if the parsing fails) to avoid symbol number collisions with the
-//   real symbol table. This makes merging the two after a successful parse much
-//   easier.
+// Symbols installed in a table with no enclosing environment are numbered
+//   consecutively from its offset.
 Symbol_Table* create_symbol_table(unsigned int offset) {
     Symbol_Table* new_st = malloc(sizeof(Symbol_Table));
     if (new_st == NULL) {
@@ -39,60 +40,393 @@ Symbol_Table* create_symbol_table(unsigned int offset) {
     new_st->head = NULL;
     new_st->length = 0;
     new_st->offset = offset;
+    new_st->name_index = NULL;
+    new_st->name_index_capacity = 0;
+    new_st->number_index = NULL;
+    new_st->number_index_capacity = 0;
+    new_st->builtin_index = NULL;
+    new_st->names = NULL;
     return new_st;
 }
 
-// Merges the second symbol table into the first; the second pointer remains
-//   valid, but its head is set to NULL and its length to zero.
-// Makes no attempt to guard against name or symbol number collisions.
-void merge_symbol_tables(Symbol_Table* first, Symbol_Table* second) {
-    if (first->head == NULL) {
-        first->head = second->head;
+#define NAME_CHUNK_CAPACITY 4096
+
+// The global symbol table keeps one copy of the name of each symbol it holds,
+//   in an append-only arena of chunks that lives as long as the table; every
+//   other table's nodes, function parameter lists, and function nodes borrow
+//   those copies rather than making their own, so binding a name never copies
+//   or frees it. As the global table holds a single node per name, a name
+//   borrowed from it also identifies its symbol: locally bound names can be
+//   compared by pointer (see install_symbol_index()).
+// Names are not reclaimed when truncate_symbol_table() removes their nodes;
+//   they are only freed with the table (see delete_environment()).
+static char* intern_symbol_name(Symbol_Table* st, const char* name) {
+    unsigned int size = strlen(name) + 1;
+    Name_Chunk* chunk = st->names;
+    if (chunk == NULL || chunk->capacity - chunk->used < size) {
+        unsigned int capacity = (size > NAME_CHUNK_CAPACITY) ? \
+                                size : \
+                                NAME_CHUNK_CAPACITY;
+        chunk = malloc(sizeof(Name_Chunk) + capacity);
+        if (chunk == NULL) {
+            fprintf(stderr, "malloc failed in intern_symbol_name()\n");
+            exit(-1);
+        }
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        chunk->next = st->names;
+        st->names = chunk;
+    }
+    char* interned = chunk->text + chunk->used;
+    memcpy(interned, name, size);
+    chunk->used += size;
+    return interned;
+}
+
+static void delete_symbol_names(Symbol_Table* st) {
+    Name_Chunk* chunk = st->names;
+    while (chunk != NULL) {
+        Name_Chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    st->names = NULL;
+    return;
+}
+
+void delete_symbol_table_indices(Symbol_Table* st) {
+    free(st->name_index);
+    free(st->number_index);
+    free(st->builtin_index);
+    return;
+}
+
+// Besides its list, a symbol table holding more than a handful of symbols keeps
+//   an open-addressing hash index of its nodes by name, so that
+//   symbol_lookup_name() (which the parser calls for every identifier) need not
+//   strcmp() its way down the list. Call frames seldom bind more than a few
+//   names, so smaller tables go without one.
+// The index is kept at most half full, and rebuilt at twice the size when it
+//   would pass that. Symbols are only removed from a table by
+//   truncate_symbol_table(), which rebuilds the index, so it never needs
+//   tombstones.
+#define SYMBOL_INDEX_MIN_LENGTH 16
+
+static unsigned long hash_symbol_name(const char* name) {
+    unsigned long hash = 14695981039346656037UL; // FNV-1a
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+static void index_symbol_node(Symbol_Table* st, Symbol_Node* sn) {
+    unsigned int mask = st->name_index_capacity - 1;
+    unsigned int slot = hash_symbol_name(sn->name) & mask;
+    while (st->name_index[slot] != NULL) {
+        slot = (slot + 1) & mask;
+    }
+    st->name_index[slot] = sn;
+    return;
+}
+
+static void rebuild_symbol_index(Symbol_Table* st) {
+    unsigned int capacity = 2 * SYMBOL_INDEX_MIN_LENGTH;
+    while (capacity < 4 * st->length) {
+        capacity *= 2;
+    }
+    free(st->name_index);
+    st->name_index = calloc(capacity, sizeof(Symbol_Node*));
+    if (st->name_index == NULL) {
+        fprintf(stderr, "calloc failed in rebuild_symbol_index()\n");
+        exit(-1);
+    }
+    st->name_index_capacity = capacity;
+    for (Symbol_Node* curr = st->head; curr != NULL; curr = curr->next) {
+        index_symbol_node(st, curr);
+    }
+    return;
+}
+
+// Brings the index up to date after the nodes from first up to (but not
+//   including) stop were added to the table's list, and counted in its length.
+static void index_new_symbols(Symbol_Table* st, \
+                              Symbol_Node* first, \
+                              Symbol_Node* stop) {
+    if (st->length < SYMBOL_INDEX_MIN_LENGTH) {
+        return;
+    } else if (st->name_index == NULL || \
+               2 * st->length > st->name_index_capacity) {
+        rebuild_symbol_index(st);
     } else {
-        Symbol_Node* curr = first->head;
-        while (curr->next != NULL) {
-            curr = curr->next;
+        for (Symbol_Node* curr = first; curr != stop; curr = curr->next) {
+            index_symbol_node(st, curr);
         }
-        curr->next = second->head;
     }
-    first->length += second->length;
-    second->head = NULL;
-    second->length = 0;
+    return;
+}
+
+// A symbol table whose symbols are numbered consecutively from its offset (a
+//   global environment's) also keeps an array of its nodes indexed by symbol
+//   number, and a map from each built-in function's code to the symbol it was
+//   first bound to, so that symbol_lookup_index() and builtin_lookup_index()
+//   need not walk the list either. Call frames bind a scattering of global
+//   symbol numbers, so their tables go without.
+static void enable_symbol_numbering(Symbol_Table* st) {
+    st->builtin_index = calloc(NUM_BUILTINS, sizeof(Symbol_Node*));
+    if (st->builtin_index == NULL) {
+        fprintf(stderr, "calloc failed in enable_symbol_numbering()\n");
+        exit(-1);
+    }
+    return;
+}
+
+static void number_symbol_node(Symbol_Table* st, Symbol_Node* sn) {
+    if (st->builtin_index == NULL || sn->symbol_idx < st->offset) {
+        return;
+    }
+    unsigned int slot = sn->symbol_idx - st->offset;
+    if (slot >= st->number_index_capacity) {
+        unsigned int capacity = (st->number_index_capacity == 0) ? \
+                                2 * SYMBOL_INDEX_MIN_LENGTH : \
+                                st->number_index_capacity;
+        while (capacity <= slot) {
+            capacity *= 2;
+        }
+        Symbol_Node** grown = realloc(st->number_index, \
+                                      capacity * sizeof(Symbol_Node*));
+        if (grown == NULL) {
+            fprintf(stderr, "realloc failed in number_symbol_node()\n");
+            exit(-1);
+        }
+        memset(grown + st->number_index_capacity, \
+               0, \
+               (capacity - st->number_index_capacity) * sizeof(Symbol_Node*));
+        st->number_index = grown;
+        st->number_index_capacity = capacity;
+    }
+    st->number_index[slot] = sn;
+    if (sn->type == TYPE_BUILTIN && \
+        sn->value.idx >= 0 && \
+        sn->value.idx < NUM_BUILTINS && \
+        st->builtin_index[sn->value.idx] == NULL) {
+        st->builtin_index[sn->value.idx] = sn;
+    }
+    return;
+}
+
+// Links a new node in at the head of the table.
+static void add_symbol_node(Symbol_Table* st, Symbol_Node* sn) {
+    sn->next = st->head;
+    st->head = sn;
+    st->length++;
+    index_new_symbols(st, sn, sn->next);
+    number_symbol_node(st, sn);
+    return;
+}
+
+// Removes the symbols added to the table since it held the given number of
+//   them, along with their values. New symbols are always linked in at the
+//   head, so the table's list doubles as a log of them, newest first; the
+//   parser uses this to undo the symbols a failed parse registered (see
+//   parse()).
+void truncate_symbol_table(Symbol_Table* st, unsigned int length) {
+    if (st->length <= length) {
+        return;
+    }
+    while (st->length > length) {
+        Symbol_Node* sn = st->head;
+        st->head = sn->next;
+        st->length--;
+        unsigned int slot = sn->symbol_idx - st->offset;
+        if (st->number_index != NULL && \
+            sn->symbol_idx >= st->offset && \
+            slot < st->number_index_capacity && \
+            st->number_index[slot] == sn) {
+            st->number_index[slot] = NULL;
+        }
+        if (st->builtin_index != NULL && \
+            sn->type == TYPE_BUILTIN && \
+            sn->value.idx >= 0 && \
+            sn->value.idx < NUM_BUILTINS && \
+            st->builtin_index[sn->value.idx] == sn) {
+            st->builtin_index[sn->value.idx] = NULL;
+        }
+        if (sn->type == TYPE_S_EXPR) {
+            delete_s_expr_recursive(sn->value.se_ptr, true);
+        } else if (sn->type == TYPE_STRING) {
+            delete_string(sn->value.string);
+        }
+        free(sn);
+    }
+    // the index has no tombstones, so it is simply built again
+    if (st->name_index != NULL) {
+        rebuild_symbol_index(st);
+    }
     return;
 }
 
 void delete_symbol_node_list(Symbol_Node* sn) {
     while (sn != NULL) {
         Symbol_Node* next = sn->next;
-        free(sn->name);
         free(sn);
         sn = next;
     }
     return;
 }
 
-// The arg list and closure environment are presumed to be unique to this
-//   function table node, but the body points to an s-expression that is
-//   represented elsewhere (and so cannot be safely freed using this pointer).
+// A function code object holds what every closure made from one lambda
+//   expression has in common: its parameter list and its body. Evaluating the
+//   expression again only creates a new function node pairing the same code
+//   with a new environment (see eval_lambda()).
+// The parameter list and body become the code object's; the body's
+//   s-expression or string, if any, is normally shared with the command it came
+//   from.
+// The code object is returned with one reference, which the caller owns.
+Function_Code* create_function_code(Symbol_Node* param_list, typed_ptr* body) {
+    Function_Code* new_code = malloc(sizeof(Function_Code));
+    if (new_code == NULL) {
+        fprintf(stderr, "malloc failed in create_function_code()\n");
+        exit(-1);
+    }
+    new_code->param_list = param_list;
+    new_code->body = body;
+    new_code->refs = 1;
+    new_code->source = NULL;
+    new_code->cache_next = NULL;
+    new_code->flat = false;
+    new_code->captures = NULL;
+    new_code->capture_count = 0;
+    new_code->assigned = NULL;
+    new_code->assigned_count = 0;
+    new_code->may_define = NULL;
+    new_code->may_define_count = 0;
+    new_code->global_cache = NULL;
+    new_code->global_cache_count = 0;
+    new_code->bytecode = NULL;
+    return new_code;
+}
+
+// Adds an owner to the code object, which is returned.
+Function_Code* share_function_code(Function_Code* code) {
+    code->refs++;
+    return code;
+}
+
+// Gives up one reference to the code object; once the last one is gone, frees
+//   it along with its parameter list and its body.
+void delete_function_code(Function_Code* code) {
+    if (--code->refs > 0) {
+        return;
+    }
+    delete_symbol_node_list(code->param_list);
+    if (code->body->type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(code->body->ptr.se_ptr, true);
+    } else if (code->body->type == TYPE_STRING) {
+        delete_string(code->body->ptr.string);
+    }
+    delete_typed_ptr(code->body);
+    free(code->captures);
+    free(code->assigned);
+    free(code->may_define);
+    free(code->global_cache);
+    delete_bytecode(code->bytecode);
+    free(code);
+    return;
+}
+
+// Frees a code object's bytecode (see Function_Code); the expressions in its
+//   pool belong to the code object's body, and are left alone.
+void delete_bytecode(Bytecode* bytecode) {
+    if (bytecode == NULL) {
+        return;
+    }
+    free(bytecode->code);
+    free(bytecode->constants);
+    free(bytecode);
+    return;
+}
+
+bool code_assigns(const Function_Code* code, long symbol_idx) {
+    for (unsigned int i = 0; i < code->assigned_count; i++) {
+        if (code->assigned[i] == symbol_idx) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void note_code_assignment(Function_Code* code, long symbol_idx) {
+    if (code_assigns(code, symbol_idx)) {
+        return;
+    }
+    long* assigned = realloc(code->assigned, \
+                             (code->assigned_count + 1) * sizeof(long));
+    if (assigned == NULL) {
+        fprintf(stderr, "realloc failed in note_code_assignment()\n");
+        exit(-1);
+    }
+    assigned[code->assigned_count++] = symbol_idx;
+    code->assigned = assigned;
+    return;
+}
+
+bool code_may_define(const Function_Code* code, long symbol_idx) {
+    for (unsigned int i = 0; i < code->may_define_count; i++) {
+        if (code->may_define[i] == symbol_idx) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void note_code_may_define(Function_Code* code, long symbol_idx) {
+    if (code_may_define(code, symbol_idx)) {
+        return;
+    }
+    long* may_define = realloc(code->may_define, \
+                               (code->may_define_count + 1) * sizeof(long));
+    if (may_define == NULL) {
+        fprintf(stderr, "realloc failed in note_code_may_define()\n");
+        exit(-1);
+    }
+    may_define[code->may_define_count++] = symbol_idx;
+    code->may_define = may_define;
+    return;
+}
+
+// The function node takes over the caller's reference to the code object.
+// Its name is borrowed, like a symbol node's (see create_symbol_node()).
+// The closure environment may be shared with other functions; it is kept alive
+//   by the collector (see collect_garbage()) for as long as any of them is.
 Function_Node* create_function_node(unsigned int function_idx, \
                                     char* name, \
-                                    Symbol_Node* param_list, \
-                                    Environment* enclosing_env, \
-                                    typed_ptr* body) {
+                                    Function_Code* code, \
+                                    Environment* enclosing_env) {
     Function_Node* new_fn = malloc(sizeof(Function_Node));
     if (new_fn == NULL) {
         fprintf(stderr, "malloc failed in create_function_node()\n");
         exit(-1);
     }
     new_fn->function_idx = function_idx;
-    new_fn->name = strdup(name);
-    new_fn->param_list = param_list;
+    new_fn->name = name;
+    new_fn->code = code;
     new_fn->enclosing_env = enclosing_env;
-    new_fn->body = body;
+    new_fn->gc_mark = 0;
+    new_fn->gc_old = false;
     new_fn->next = NULL;
     return new_fn;
 }
 
+// Frees the function node and its reference to its code, but not its enclosing
+//   environment (which may be shared with other functions).
+void delete_function_node(Function_Node* fn) {
+    delete_function_code(fn->code);
+    free(fn);
+    return;
+}
+
 Function_Table* create_function_table(unsigned int offset) {
     Function_Table* new_ft = malloc(sizeof(Function_Table));
     if (new_ft == NULL) {
@@ -102,9 +436,52 @@ Function_Table* create_function_table(unsigned int offset) {
     new_ft->head = NULL;
     new_ft->length = 0;
     new_ft->offset = offset;
+    new_ft->slots = NULL;
+    new_ft->slots_used = 0;
+    new_ft->slots_capacity = 0;
+    new_ft->free_slots = NULL;
+    new_ft->free_slots_length = 0;
+    new_ft->code_cache = NULL;
+    new_ft->code_cache_capacity = 0;
+    new_ft->code_cache_length = 0;
     return new_ft;
 }
 
+// Besides the list (kept newest first, for the collector's sake), a function
+//   table keeps its nodes in an array of slots indexed by function number, so
+//   that function_lookup_index() is a single array access. The slots of
+//   collected functions are handed out again to new ones, so the array only
+//   grows with the number of functions alive at once, not with the number ever
+//   created.
+static unsigned int claim_function_slot(Function_Table* ft) {
+    if (ft->free_slots_length > 0) {
+        return ft->free_slots[--ft->free_slots_length];
+    }
+    if (ft->slots_used == ft->slots_capacity) {
+        unsigned int capacity = (ft->slots_capacity == 0) ? \
+                                16 : \
+                                2 * ft->slots_capacity;
+        Function_Node** slots = realloc(ft->slots, \
+                                        capacity * sizeof(Function_Node*));
+        unsigned int* free_slots = realloc(ft->free_slots, \
+                                           capacity * sizeof(unsigned int));
+        if (slots == NULL || free_slots == NULL) {
+            fprintf(stderr, "realloc failed in claim_function_slot()\n");
+            exit(-1);
+        }
+        ft->slots = slots;
+        ft->free_slots = free_slots;
+        ft->slots_capacity = capacity;
+    }
+    return ft->slots_used++;
+}
+
+static void release_function_slot(Function_Table* ft, unsigned int idx) {
+    ft->slots[idx - ft->offset] = NULL;
+    ft->free_slots[ft->free_slots_length++] = idx - ft->offset;
+    return;
+}
+
 Environment* create_environment(unsigned int symbol_start, \
                                 unsigned int function_start, \
                                 Environment* enclosing_env) {
@@ -116,21 +493,225 @@ Environment* create_environment(unsigned int symbol_start, \
     new_env->symbol_table = create_symbol_table(symbol_start);
     new_env->function_table = create_function_table(function_start);
     new_env->enclosing_env = enclosing_env;
+    new_env->code = NULL;
+    new_env->slots = NULL;
+    new_env->slot_count = 0;
+    new_env->extended = false;
     new_env->env_tracker_next = NULL;
+    new_env->captured = false;
+    new_env->gc_mark = 0;
+    new_env->gc_old = false;
+    new_env->gc_remembered = false;
+    new_env->gc_remembered_next = NULL;
     if (enclosing_env == NULL) {
         new_env->global_env = new_env;
+        enable_symbol_numbering(new_env->symbol_table);
     } else {
         new_env->global_env = enclosing_env->global_env;
     }
     return new_env;
 }
 
+// A call frame is the environment a function body is evaluated in. It is
+//   allocated in one piece, together with its symbol table and a binding for
+//   each parameter; the bindings borrow their names from the code object's
+//   parameter list, which the frame holds a reference to. The bindings are
+//   linked in parameter order, and double as the frame's slots (see
+//   resolve_references()).
+// Frames have no function table of their own, since functions always live in
+//   the global environment's (see install_function()). A symbol defined in the
+//   body after the call begins is given an ordinary node, at the head of the
+//   table's list.
+typedef struct CALL_FRAME {
+    Environment env;
+    Symbol_Table symbol_table;
+    Symbol_Node bindings[];
+} Call_Frame;
+
+// Allocates a frame with the given number of bindings, linked in order and
+//   bound to undefined values; filling in their names and symbol numbers is
+//   left to the caller.
+static Environment* allocate_frame(unsigned int binding_count, \
+                                   Function_Code* code, \
+                                   Environment* enclosing_env) {
+    Call_Frame* frame = malloc(sizeof(Call_Frame) + \
+                               binding_count * sizeof(Symbol_Node));
+    if (frame == NULL) {
+        fprintf(stderr, "malloc failed in allocate_frame()\n");
+        exit(-1);
+    }
+    for (unsigned int slot = 0; slot < binding_count; slot++) {
+        frame->bindings[slot].type = TYPE_UNDEF;
+        frame->bindings[slot].boxed = false;
+        frame->bindings[slot].value = (tp_value){.idx=0};
+        frame->bindings[slot].next = (slot + 1 < binding_count) ? \
+                                     &frame->bindings[slot + 1] : \
+                                     NULL;
+    }
+    Symbol_Table* st = &frame->symbol_table;
+    st->head = (binding_count > 0) ? frame->bindings : NULL;
+    st->length = binding_count;
+    st->offset = 0;
+    st->name_index = NULL;
+    st->name_index_capacity = 0;
+    st->number_index = NULL;
+    st->number_index_capacity = 0;
+    st->builtin_index = NULL;
+    st->names = NULL;
+    Environment* env = &frame->env;
+    env->symbol_table = st;
+    env->function_table = NULL;
+    env->enclosing_env = enclosing_env;
+    env->global_env = enclosing_env->global_env;
+    env->code = share_function_code(code);
+    env->slots = frame->bindings;
+    env->slot_count = binding_count;
+    env->extended = false;
+    env->env_tracker_next = NULL;
+    env->captured = false;
+    env->gc_mark = 0;
+    env->gc_old = false;
+    env->gc_remembered = false;
+    env->gc_remembered_next = NULL;
+    return env;
+}
+
+// The parameters are bound to undefined values; see bind_args() for filling
+//   them in.
+// The returned environment is the caller's responsibility to delete.
+Environment* create_call_frame(Function_Code* code, \
+                               Environment* enclosing_env) {
+    unsigned int param_count = 0;
+    for (Symbol_Node* p = code->param_list; p != NULL; p = p->next) {
+        param_count++;
+    }
+    Environment* frame = allocate_frame(param_count, code, enclosing_env);
+    Symbol_Node* param = code->param_list;
+    for (unsigned int slot = 0; slot < param_count; slot++) {
+        frame->slots[slot].symbol_idx = param->symbol_idx;
+        frame->slots[slot].name = param->name;
+        param = param->next;
+    }
+    return frame;
+}
+
+static Symbol_Node* binding_lookup(const Environment* env, \
+                                   const typed_ptr* tp);
+static void record_box_write(void);
+
+// Returns the value of a binding, from its box if it has one. The value is not
+//   shared (see share_value()).
+typed_ptr binding_value(const Symbol_Node* sn) {
+    if (sn->boxed) {
+        return sn->value.se_ptr->car;
+    }
+    return (typed_ptr){.type=sn->type, .ptr=sn->value};
+}
+
+// Gives a binding in the given environment a new value, which it takes over
+//   the caller's reference to, freeing the old one. A boxed binding's new value
+//   goes in its box, so that every closure record sharing the box sees it.
+void set_binding_value(Environment* env, Symbol_Node* sn, typed_ptr value) {
+    typed_ptr old = binding_value(sn);
+    if (old.type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(old.ptr.se_ptr, true);
+    } else if (old.type == TYPE_STRING) {
+        delete_string(old.ptr.string);
+    }
+    if (sn->boxed) {
+        sn->value.se_ptr->car = value;
+        record_box_write();
+    } else {
+        sn->type = value.type;
+        sn->value = value.ptr;
+    }
+    record_environment_write(env);
+    return;
+}
+
+// Moves a binding's value into a box: a cell of its own, whose car holds the
+//   value from then on (see Symbol_Node).
+static void box_binding(Symbol_Node* sn) {
+    typed_ptr value = {.type=sn->type, .ptr=sn->value};
+    sn->type = TYPE_S_EXPR;
+    sn->value.se_ptr = create_s_expr(value, none_tp());
+    sn->boxed = true;
+    return;
+}
+
+// A flat closure (see Function_Code) does not keep the environment it was
+//   created in; instead, the variables it captures are put in a closure
+//   record, which takes that environment's place. The record is a frame whose
+//   bindings are the captures, in order, enclosed directly by the global
+//   environment; its names are borrowed from the global symbol table, which
+//   outlives every closure.
+// The analysis that makes code flat cannot rule out every assignment to a
+//   captured variable: a call whose operator is rebound to set! after the code
+//   is compiled makes one. So the record does not copy a captured binding, but
+//   boxes it where it was found, and shares the box; the binding, and every
+//   record made from it, then see the same value.
+// The returned environment is the caller's responsibility to delete, or to
+//   hand over to the collector.
+Environment* create_closure_record(Function_Code* code, Environment* env) {
+    Environment* record = allocate_frame(code->capture_count, \
+                                         code, \
+                                         env->global_env);
+    for (unsigned int slot = 0; slot < code->capture_count; slot++) {
+        const typed_ptr* ref = &code->captures[slot];
+        Symbol_Node* global = symbol_lookup_index(env->global_env, ref);
+        Symbol_Node* found = binding_lookup(env, ref);
+        record->slots[slot].symbol_idx = ref->ptr.idx;
+        record->slots[slot].name = global->name;
+        if (found != NULL) {
+            if (!found->boxed) {
+                box_binding(found);
+            }
+            record->slots[slot].type = TYPE_S_EXPR;
+            record->slots[slot].value.se_ptr = \
+                share_s_expr(found->value.se_ptr);
+            record->slots[slot].boxed = true;
+        }
+    }
+    return record;
+}
+
+static void release_binding_value(Symbol_Node* sn) {
+    if (sn->type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(sn->value.se_ptr, true);
+    } else if (sn->type == TYPE_STRING) {
+        delete_string(sn->value.string);
+    }
+    return;
+}
+
+static void delete_call_frame(Environment* env) {
+    // symbols defined after the call began come before the frame's bindings
+    Symbol_Node* bindings = (env->slot_count > 0) ? env->slots : NULL;
+    Symbol_Node* curr_sn = env->symbol_table->head;
+    while (curr_sn != bindings) {
+        Symbol_Node* next_sn = curr_sn->next;
+        release_binding_value(curr_sn);
+        free(curr_sn);
+        curr_sn = next_sn;
+    }
+    for (unsigned int slot = 0; slot < env->slot_count; slot++) {
+        release_binding_value(&env->slots[slot]);
+    }
+    delete_symbol_table_indices(env->symbol_table);
+    delete_function_code(env->code);
+    free(env);
+    return;
+}
+
 void delete_environment(Environment* env) {
+    if (env->function_table == NULL) {
+        delete_call_frame(env);
+        return;
+    }
     // free symbol table
     Symbol_Node* curr_sn = env->symbol_table->head;
     while (curr_sn != NULL) {
         Symbol_Node* next_sn = curr_sn->next;
-        free(curr_sn->name);
         if (curr_sn->type == TYPE_S_EXPR) {
             delete_s_expr_recursive(curr_sn->value.se_ptr, true);
         } else if (curr_sn->type == TYPE_STRING) {
@@ -139,30 +720,29 @@ void delete_environment(Environment* env) {
         free(curr_sn);
         curr_sn = next_sn;
     }
+    delete_symbol_table_indices(env->symbol_table);
+    delete_symbol_names(env->symbol_table);
     free(env->symbol_table);
     // free function table
     Function_Node* curr_fn = env->function_table->head;
     while (curr_fn != NULL) {
         Function_Node* next_fn = curr_fn->next;
-        free(curr_fn->name);
-        // free parameter list
-        Symbol_Node* curr_param_sn = curr_fn->param_list;
-        while (curr_param_sn != NULL) {
-            Symbol_Node* next_param_sn = curr_param_sn->next;
-            free(curr_param_sn->name);
-            free(curr_param_sn);
-            curr_param_sn = next_param_sn;
-        }
-        // free body s-expression
-        if (curr_fn->body->type == TYPE_S_EXPR) {
-            delete_s_expr_recursive(curr_fn->body->ptr.se_ptr, true);
-        } else if (curr_fn->body->type == TYPE_STRING) {
-            delete_string(curr_fn->body->ptr.string);
-        }
-        free(curr_fn->body);
-        free(curr_fn);
+        delete_function_node(curr_fn);
         curr_fn = next_fn;
     }
+    free(env->function_table->slots);
+    free(env->function_table->free_slots);
+    Function_Table* ft = env->function_table;
+    for (unsigned int i = 0; i < ft->code_cache_capacity; i++) {
+        Function_Code* code = ft->code_cache[i];
+        while (code != NULL) {
+            Function_Code* next_code = code->cache_next;
+            delete_s_expr_recursive(code->source, true);
+            delete_function_code(code);
+            code = next_code;
+        }
+    }
+    free(env->function_table->code_cache);
     free(env->function_table);
     // free all closure environments
     if (env->enclosing_env == NULL) {
@@ -177,77 +757,184 @@ void delete_environment(Environment* env) {
     return;
 }
 
-// The string pointed to by name is copied, and must not be NULL.
+// Looks a name interned by the global symbol table up in the immediate
+//   environment provided, comparing names by pointer.
+static Symbol_Node* interned_lookup(const Environment* env, const char* name) {
+    Symbol_Node* curr = env->symbol_table->head;
+    while (curr != NULL && curr->name != name) {
+        curr = curr->next;
+    }
+    return curr;
+}
+
+// Bumped whenever a call frame gains a binding its code was not known to
+//   define, which may shadow a global variable that a cached reference was
+//   resolved to (see cached_global_lookup()).
+static unsigned long binding_version = 1;
+
+// name must not be NULL; the node installed borrows the global symbol table's
+//   copy of it (see intern_symbol_name()), so the caller keeps ownership.
 // If a symbol already exists in the given symbol table with that name, the type
 //   and value associated with it will be updated. Otherwise, the symbol is
 //   installed into the symbol table.
-// The returned typed_ptr is the caller's responsibility to free; it can be
-//   safely (shallow) freed without harm to the symbol table or any other
-//   object.
-typed_ptr* install_symbol(Environment* env, char* name, typed_ptr* tp) {
+// Returns the symbol number of the installed symbol, or -1 if a local
+//   environment was asked to install a symbol the global environment has never
+//   seen.
+static long install_symbol_index(Environment* env, char* name, typed_ptr* tp) {
     Symbol_Node* global_found = symbol_lookup_name(env->global_env, name);
     if (global_found == NULL) {
         if (env->global_env == env) {
             unsigned int idx = env->symbol_table->offset + \
                                env->symbol_table->length;
-            Symbol_Node* sn = create_symbol_node(idx, name, tp->type, tp->ptr);
-            sn->next = env->symbol_table->head;
-            env->symbol_table->head = sn;
-            env->symbol_table->length++;
-            return create_atom_tp(TYPE_SYMBOL, idx);
+            char* interned = intern_symbol_name(env->symbol_table, name);
+            Symbol_Node* sn = create_symbol_node(idx, \
+                                                 interned, \
+                                                 tp->type, \
+                                                 tp->ptr);
+            add_symbol_node(env->symbol_table, sn);
+            return idx;
         } else {
-            return create_error_tp(EVAL_ERROR_BAD_SYMBOL);
+            return -1;
         }
     }
-    Symbol_Node* local_found = symbol_lookup_name(env, name);
+    Symbol_Node* local_found = (env->global_env == env) ? \
+                               global_found : \
+                               interned_lookup(env, global_found->name);
     if (local_found == NULL) {
         Symbol_Node* sn = create_symbol_node(global_found->symbol_idx, \
-                                             name, \
+                                             global_found->name, \
                                              tp->type, \
                                              tp->ptr);
-        sn->next = env->symbol_table->head;
-        env->symbol_table->head = sn;
-        env->symbol_table->length++;
-    } else {
-        if (local_found->type == TYPE_S_EXPR) {
-            delete_s_expr_recursive(local_found->value.se_ptr, true);
-        } else if (local_found->type == TYPE_STRING) {
-            delete_string(local_found->value.string);
+        add_symbol_node(env->symbol_table, sn);
+        env->extended = true;
+        if (env->code != NULL && \
+            !code_assigns(env->code, global_found->symbol_idx)) {
+            note_code_assignment(env->code, global_found->symbol_idx);
+            binding_version++;
         }
-        local_found->type = tp->type;
-        local_found->value = tp->ptr;
+        record_environment_write(env);
+    } else {
+        set_binding_value(env, local_found, *tp);
+        number_symbol_node(env->symbol_table, local_found);
+    }
+    return global_found->symbol_idx;
+}
+
+// All considerations attendant upon the function "install_symbol_index()"
+//   above apply here.
+// The returned typed_ptr is the caller's responsibility to free; it can be
+//   safely (shallow) freed without harm to the symbol table or any other
+//   object.
+typed_ptr* install_symbol(Environment* env, char* name, typed_ptr* tp) {
+    long idx = install_symbol_index(env, name, tp);
+    if (idx < 0) {
+        return create_error_tp(EVAL_ERROR_BAD_SYMBOL);
+    } else {
+        return create_atom_tp(TYPE_SYMBOL, idx);
     }
-    return create_atom_tp(TYPE_SYMBOL, global_found->symbol_idx);
 }
 
-// All considerations attendant upon the function "install_symbol()" above apply
-//   here.
-// This is a convenience function for use in initial symbol table setup.
+// All considerations attendant upon the function "install_symbol_index()"
+//   above apply here.
+// This is a convenience function for use in initial symbol table setup, and
+//   wherever the evaluator doesn't need the installed symbol back.
 void blind_install_symbol(Environment* env, char* name, typed_ptr* tp) {
-    typed_ptr* result = install_symbol(env, name, tp);
-    free(result);
+    install_symbol_index(env, name, tp);
     return;
 }
 
-// The arg list and closure environment are now the (general) environment's
-//   concern. The body pointed to by the typed pointer remains someone else's
-//   problem, and won't be freed by the environment.
-// The typed pointer returned is the caller's responsibility to free.
-typed_ptr* install_function(Environment* env, \
-                            char* name, \
-                            Symbol_Node* param_list, \
-                            Environment* enclosing_env, \
-                            typed_ptr* body) {
-    unsigned int idx = env->function_table->length;
+static void count_new_object(void);
+
+// The function node takes over the caller's reference to the code object.
+// Functions always live in the global environment's function table, however
+//   deeply nested the environment they were created in; the closure environment
+//   is recorded in the function node, and it and all of its enclosing
+//   environments are marked as captured, so that they outlive the function
+//   calls that created them (see eval_function()).
+// New functions take the number of a collected one where there is one; numbers
+//   freed by the collector are only reused once nothing can refer to them any
+//   more.
+typed_ptr install_function(Environment* env, \
+                           char* name, \
+                           Function_Code* code, \
+                           Environment* enclosing_env) {
+    for (Environment* curr_env = enclosing_env; \
+         curr_env != NULL && !curr_env->captured; \
+         curr_env = curr_env->enclosing_env) {
+        curr_env->captured = true;
+    }
+    Function_Table* ft = env->global_env->function_table;
+    unsigned int slot = claim_function_slot(ft);
+    unsigned int idx = ft->offset + slot;
     Function_Node* new_fn = create_function_node(idx, \
                                                  name, \
-                                                 param_list, \
-                                                 enclosing_env, \
-                                                 body);
-    new_fn->next = env->function_table->head;
-    env->function_table->head = new_fn;
-    env->function_table->length++;
-    return create_atom_tp(TYPE_FUNCTION, idx);
+                                                 code, \
+                                                 enclosing_env);
+    ft->slots[slot] = new_fn;
+    new_fn->next = ft->head;
+    ft->head = new_fn;
+    ft->length++;
+    count_new_object();
+    return atom_tp(TYPE_FUNCTION, idx);
+}
+
+// Code objects are cached in the global environment's function table, keyed by
+//   the s-expression cell they were compiled from (the argument list of the
+//   lambda or define form), so that a lambda expression evaluated over and over
+//   - in a loop, or in a recursive function's body - is compiled only once.
+// The cache owns a reference to each source cell, so a cell's address cannot be
+//   reused by a different expression while its entry is in the cache; and since
+//   s-expressions are immutable, a cached code object always still matches its
+//   source. Once the cache's reference is the only one left, the entry is
+//   dropped by the next major collection (see drop_unused_code()).
+static unsigned int code_cache_bucket(const Function_Table* ft, \
+                                      const s_expr* source) {
+    uintptr_t key = (uintptr_t)source;
+    key ^= key >> 17;
+    key *= 0x9E3779B1u;
+    return (unsigned int)(key >> 7) & (ft->code_cache_capacity - 1);
+}
+
+static void grow_code_cache(Function_Table* ft) {
+    unsigned int old_capacity = ft->code_cache_capacity;
+    Function_Code** old_cache = ft->code_cache;
+    ft->code_cache_capacity = (old_capacity == 0) ? 16 : 2 * old_capacity;
+    ft->code_cache = calloc(ft->code_cache_capacity, sizeof(Function_Code*));
+    if (ft->code_cache == NULL) {
+        fprintf(stderr, "calloc failed in grow_code_cache()\n");
+        exit(-1);
+    }
+    for (unsigned int i = 0; i < old_capacity; i++) {
+        Function_Code* code = old_cache[i];
+        while (code != NULL) {
+            Function_Code* next_code = code->cache_next;
+            unsigned int bucket = code_cache_bucket(ft, code->source);
+            code->cache_next = ft->code_cache[bucket];
+            ft->code_cache[bucket] = code;
+            code = next_code;
+        }
+    }
+    free(old_cache);
+    return;
+}
+
+// The cache takes its own references to the source cell and the code object.
+void cache_function_code(Environment* env, \
+                         s_expr* source, \
+                         Function_Code* code) {
+    Function_Table* ft = env->global_env->function_table;
+    if (code->source != NULL) {
+        return;
+    }
+    if (ft->code_cache_length >= ft->code_cache_capacity) {
+        grow_code_cache(ft);
+    }
+    unsigned int bucket = code_cache_bucket(ft, source);
+    code->source = share_s_expr(source);
+    code->cache_next = ft->code_cache[bucket];
+    ft->code_cache[bucket] = share_function_code(code);
+    ft->code_cache_length++;
+    return;
 }
 
 void setup_symbol_table(Environment* env) {
@@ -313,7 +1000,19 @@ Symbol_Node* symbol_lookup_name(const Environment* env, const char* name) {
     if (name == NULL) {
         return NULL;
     }
-    Symbol_Node* curr = env->symbol_table->head;
+    const Symbol_Table* st = env->symbol_table;
+    if (st->name_index != NULL) {
+        unsigned int mask = st->name_index_capacity - 1;
+        unsigned int slot = hash_symbol_name(name) & mask;
+        while (st->name_index[slot] != NULL) {
+            if (!strcmp(st->name_index[slot]->name, name)) {
+                return st->name_index[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+        return NULL;
+    }
+    Symbol_Node* curr = st->head;
     while (curr != NULL) {
         if (!strcmp(curr->name, name)) {
             return curr;
@@ -330,7 +1029,15 @@ Symbol_Node* symbol_lookup_index(const Environment* env, const typed_ptr* tp) {
     if (tp == NULL || tp->type != TYPE_SYMBOL) {
         return NULL;
     }
-    Symbol_Node* curr = env->symbol_table->head;
+    const Symbol_Table* st = env->symbol_table;
+    if (st->number_index != NULL) {
+        if (tp->ptr.idx < st->offset || \
+            tp->ptr.idx - st->offset >= st->number_index_capacity) {
+            return NULL;
+        }
+        return st->number_index[tp->ptr.idx - st->offset];
+    }
+    Symbol_Node* curr = st->head;
     while (curr != NULL) {
         if (curr->symbol_idx == tp->ptr.idx) {
             break;
@@ -344,7 +1051,19 @@ Symbol_Node* builtin_lookup_index(const Environment* env, const typed_ptr* tp) {
     if (tp == NULL || tp->type != TYPE_BUILTIN) {
         return NULL;
     }
-    Symbol_Node* curr = env->global_env->symbol_table->head;
+    const Symbol_Table* st = env->global_env->symbol_table;
+    if (st->builtin_index != NULL && \
+        tp->ptr.idx >= 0 && \
+        tp->ptr.idx < NUM_BUILTINS) {
+        // the symbol may since have been rebound to something else
+        Symbol_Node* first_bound = st->builtin_index[tp->ptr.idx];
+        if (first_bound != NULL && \
+            first_bound->type == TYPE_BUILTIN && \
+            first_bound->value.idx == tp->ptr.idx) {
+            return first_bound;
+        }
+    }
+    Symbol_Node* curr = st->head;
     while (curr != NULL) {
         if (curr->type == TYPE_BUILTIN && curr->value.idx == tp->ptr.idx) {
             return curr;
@@ -354,38 +1073,137 @@ Symbol_Node* builtin_lookup_index(const Environment* env, const typed_ptr* tp) {
     return curr;
 }
 
+static Symbol_Node* global_address_lookup(const Environment* env, \
+                                          const typed_ptr* tp) {
+    while (env->enclosing_env != NULL) {
+        if (env->extended) {
+            return NULL;
+        }
+        env = env->enclosing_env;
+    }
+    return symbol_lookup_index(env, tp);
+}
+
+// A global variable reference in a function body is given a site in its code
+//   object's global cache, which remembers the global binding it was last
+//   found in, so that it can be found again with a compare and a load. Global
+//   bindings are updated in place and never removed, so a define or set! of
+//   the variable leaves the entry good; what could spoil it is a frame between
+//   the body and the global environment binding the same name. A binding is
+//   only cached while none of the code objects of those frames defines or sets
+//   the name (see make_closure()), and a frame that gains a binding its code
+//   was not known to define bumps binding_version, which invalidates every
+//   entry in every cache.
+// The frames between the body and the global environment always belong to the
+//   same code objects, however the body was called, so a binding found by way
+//   of one call is good for all the others.
+static Symbol_Node* cached_global_lookup(const Environment* env, \
+                                         const typed_ptr* tp) {
+    Function_Code* code = env->code;
+    unsigned int site = ADDRESS_SLOT(tp->address);
+    if (code == NULL || site >= code->global_cache_count) {
+        return NULL;
+    }
+    Global_Cache_Entry* entry = &code->global_cache[site];
+    if (entry->version == binding_version && \
+        entry->symbol_idx == tp->ptr.idx) {
+        return entry->binding;
+    }
+    Symbol_Node* found = global_address_lookup(env, tp);
+    if (found == NULL) {
+        return NULL;
+    }
+    for (const Environment* outer = env; \
+         outer->enclosing_env != NULL; \
+         outer = outer->enclosing_env) {
+        if (outer->code == NULL || code_assigns(outer->code, tp->ptr.idx)) {
+            return found;
+        }
+    }
+    entry->symbol_idx = tp->ptr.idx;
+    entry->version = binding_version;
+    entry->binding = found;
+    return found;
+}
+
+// Finds the binding a variable reference was resolved to, without searching
+//   any symbol table: a local reference names a slot in the call frame so many
+//   enclosing environments up, and a global reference goes straight to the
+//   global environment.
+// A define in one of the frames passed over may have shadowed the binding
+//   since the reference was resolved. In that case (and if the frame found
+//   does not bind the symbol, which only an unexpected environment chain would
+//   cause) NULL is returned, and the caller should search for the symbol
+//   instead.
+static Symbol_Node* address_lookup(const Environment* env, \
+                                   const typed_ptr* tp) {
+    if (IS_GLOBAL_SITE(tp->address)) {
+        return cached_global_lookup(env, tp);
+    } else if (tp->address == ADDRESS_GLOBAL) {
+        return global_address_lookup(env, tp);
+    }
+    for (unsigned int depth = ADDRESS_DEPTH(tp->address); depth > 0; depth--) {
+        if (env->extended || env->enclosing_env == NULL) {
+            return NULL;
+        }
+        env = env->enclosing_env;
+    }
+    unsigned int slot = ADDRESS_SLOT(tp->address);
+    if (slot >= env->slot_count || \
+        env->slots[slot].symbol_idx != tp->ptr.idx) {
+        return NULL;
+    }
+    return &env->slots[slot];
+}
+
+// Finds the binding a symbol reference refers to, by its lexical address if it
+//   has a usable one, or else by searching the environment and those enclosing
+//   it. Returns NULL if there is no such binding.
+static Symbol_Node* binding_lookup(const Environment* env, \
+                                   const typed_ptr* tp) {
+    Symbol_Node* found = NULL;
+    if (tp->address != ADDRESS_UNRESOLVED) {
+        found = address_lookup(env, tp);
+    }
+    if (found == NULL) {
+        found = symbol_lookup_index(env, tp);
+        while (found == NULL && env->enclosing_env != NULL) {
+            env = env->enclosing_env;
+            found = symbol_lookup_index(env, tp);
+        }
+    }
+    return found;
+}
+
 // Primary method to look up symbol values.
-// The typed_ptr returned is the caller's responsibility to free; it may be
-//   (shallow) freed without harm to the symbol table or any other object.
+// The typed_ptr returned shares the symbol table entry's value (see
+//   share_value()), so reading a list-valued symbol never copies the list; any
+//   s-expression or string it points to is the caller's responsibility to
+//   free, and can be freed without harm to the symbol table or any other
+//   object.
 // Symbol table are searched beginning in the provided environment and marching
 //   upwards through its enclosing environments. The first symbol table
-//   containing the provided symbol contains the value returned.
+//   containing the provided symbol contains the value returned. A reference
+//   that has been given a lexical address is found by that address instead,
+//   where it can be.
 // If the given typed_ptr does not point to a valid symbol table entry in any
-//   enclosing environment, or if it is NULL, NULL is returned.
-typed_ptr* value_lookup_index(const Environment* env, const typed_ptr* tp) {
+//   enclosing environment, or if it is NULL, an EVAL_ERROR_BAD_SYMBOL error is
+//   returned.
+typed_ptr value_lookup_index(const Environment* env, const typed_ptr* tp) {
     if (tp == NULL || tp->type != TYPE_SYMBOL) {
-        return NULL;
-    }
-    Symbol_Node* found = symbol_lookup_index(env, tp);
-    while (found == NULL && env->enclosing_env != NULL) {
-        env = env->enclosing_env;
-        found = symbol_lookup_index(env, tp);
+        return error_tp(EVAL_ERROR_BAD_SYMBOL);
     }
+    Symbol_Node* found = binding_lookup(env, tp);
     if (found != NULL) {
-        switch (found->type) {
+        typed_ptr value = binding_value(found);
+        switch (value.type) {
             case TYPE_UNDEF:
-                return create_error_tp(EVAL_ERROR_UNDEF_SYM);
-            case TYPE_S_EXPR:
-                return create_s_expr_tp(copy_s_expr(found->value.se_ptr));
-            case TYPE_STRING: {
-                char* contents = found->value.string->contents;
-                return create_string_tp(create_string(contents));
-            }
+                return error_tp(EVAL_ERROR_UNDEF_SYM);
             default:
-                return create_typed_ptr(found->type, found->value);
+                return share_value(&value);
         }
     } else {
-        return NULL;
+        return error_tp(EVAL_ERROR_BAD_SYMBOL);
     }
 }
 
@@ -396,12 +1214,376 @@ Function_Node* function_lookup_index(const Environment* env, \
     if (tp == NULL || tp->type != TYPE_FUNCTION) {
         return NULL;
     }
-    Function_Node* curr = env->global_env->function_table->head;
-    while (curr != NULL) {
-        if (curr->function_idx == tp->ptr.idx) {
-            return curr;
+    const Function_Table* ft = env->global_env->function_table;
+    if (tp->ptr.idx < ft->offset || \
+        tp->ptr.idx - ft->offset >= ft->slots_used) {
+        return NULL;
+    }
+    return ft->slots[tp->ptr.idx - ft->offset];
+}
+
+// Returns the cached code object compiled from the given source cell, if there
+//   is one. The code object returned belongs to the cache.
+Function_Code* function_code_lookup(const Environment* env, \
+                                    const s_expr* source) {
+    const Function_Table* ft = env->global_env->function_table;
+    if (ft->code_cache_length == 0) {
+        return NULL;
+    }
+    Function_Code* code = ft->code_cache[code_cache_bucket(ft, source)];
+    while (code != NULL && code->source != source) {
+        code = code->cache_next;
+    }
+    return code;
+}
+
+// Environments and functions are reclaimed by a mark-and-sweep collector rather
+//   than by ownership rules: closures can make an environment reachable from a
+//   function bound inside that same environment, so neither could ever own the
+//   other. (List and string values stay reference counted; since they are
+//   immutable, they never form cycles.)
+// The collector is generational. Most environments belong to a single function
+//   call and are garbage as soon as it returns, so most collections are minor:
+//   they only trace and sweep the young objects created since the previous
+//   collection, and promote the survivors. Every few collections a major one
+//   traces the whole heap, to reclaim old objects that have died since.
+// Each collection marks with a fresh epoch, so marks left over from earlier
+//   collections never need to be cleared.
+// Collections are made between top-level evaluations, and also during one (see
+//   collect_garbage_with_roots()) once enough objects have been handed to the
+//   collector since the last: at least GC_MIN_NEW_OBJECTS, and at least as
+//   many as the last collection traced, so that the cost of tracing is spread
+//   over the objects made in between.
+#define GC_MINORS_PER_MAJOR 8
+#define GC_MIN_NEW_OBJECTS 4096
+
+static unsigned int gc_epoch = 0;
+static unsigned int gc_minors_since_major = 0;
+static unsigned int gc_new_objects = 0;
+static unsigned int gc_traced = 0;
+static unsigned int gc_new_objects_due = GC_MIN_NEW_OBJECTS;
+static bool gc_box_written = false;
+
+static void count_new_object(void) {
+    gc_new_objects++;
+    return;
+}
+
+bool garbage_collection_due(void) {
+    return gc_new_objects >= gc_new_objects_due;
+}
+
+// The write barrier, to be called whenever a binding in the given environment
+//   is added or changed.
+// Functions and closure environments are created after the environments they
+//   close over, so the only way for an old object to refer to a young one is
+//   for an old environment's binding to be overwritten. Such environments are
+//   remembered, and their bindings act as extra roots for the next minor
+//   collection. (The global environment is always a root, so it is never
+//   remembered.)
+void record_environment_write(Environment* env) {
+    if (env->gc_old && !env->gc_remembered && env != env->global_env) {
+        env->gc_remembered = true;
+        env->gc_remembered_next = env->global_env->gc_remembered_next;
+        env->global_env->gc_remembered_next = env;
+    }
+    return;
+}
+
+// A box (see Symbol_Node) may be shared by old closure records that the write
+//   barrier does not know of, so the collection after a box is written traces
+//   the whole heap.
+static void record_box_write(void) {
+    gc_box_written = true;
+    return;
+}
+
+// Hands an environment that has outlived the call that made it (a captured
+//   call frame, or a closure record) over to the collector.
+// A call frame that was traced as a root by a collection made during its call
+//   may be referred to by functions which that collection promoted, so it is
+//   remembered: its first minor collection as a young object then traces it
+//   as a root too, and promotes it in turn.
+void track_environment(Environment* env) {
+    env->env_tracker_next = env->global_env->env_tracker_next;
+    env->global_env->env_tracker_next = env;
+    if (env->gc_mark != 0 && !env->gc_remembered) {
+        env->gc_remembered = true;
+        env->gc_remembered_next = env->global_env->gc_remembered_next;
+        env->global_env->gc_remembered_next = env;
+    }
+    count_new_object();
+    return;
+}
+
+// Marking works through a list of objects still to visit, kept on the heap
+//   rather than on the C stack: chains of closures, environments and nested
+//   lists can be as long as the program cares to make them. An item is an
+//   environment (with its enclosing environments), or a value.
+typedef struct GC_WORK_ITEM {
+    Environment* env;
+    type type;
+    tp_value value;
+} Gc_Work_Item;
+
+typedef struct GC_WORKLIST {
+    Gc_Work_Item* items;
+    unsigned int length;
+    unsigned int capacity;
+    bool young_only;
+} Gc_Worklist;
+
+static Gc_Worklist gc_work = {.items=NULL, \
+                              .length=0, \
+                              .capacity=0, \
+                              .young_only=false};
+
+static void gc_push(Environment* env, type type, tp_value value) {
+    if (gc_work.length == gc_work.capacity) {
+        gc_work.capacity = (gc_work.capacity == 0) ? \
+                           64 : \
+                           2 * gc_work.capacity;
+        gc_work.items = realloc(gc_work.items, \
+                                gc_work.capacity * sizeof(Gc_Work_Item));
+        if (gc_work.items == NULL) {
+            fprintf(stderr, "realloc failed in gc_push()\n");
+            exit(-1);
         }
-        curr = curr->next;
     }
-    return curr;
+    Gc_Work_Item* item = &gc_work.items[gc_work.length++];
+    item->env = env;
+    item->type = type;
+    item->value = value;
+    return;
+}
+
+// Only functions and lists can lead to anything the collector looks after.
+static void mark_value(type type, tp_value value) {
+    if (type == TYPE_FUNCTION || type == TYPE_S_EXPR) {
+        gc_push(NULL, type, value);
+    }
+    return;
+}
+
+static void mark_bindings(Environment* env) {
+    for (Symbol_Node* curr = env->symbol_table->head; \
+         curr != NULL; \
+         curr = curr->next) {
+        mark_value(curr->type, curr->value);
+    }
+    return;
+}
+
+static void mark_environment(Environment* env) {
+    if (env != NULL) {
+        gc_push(env, TYPE_NONE, (tp_value){.idx=0});
+    }
+    return;
+}
+
+// Marks everything reachable from the items on the worklist, emptying it.
+static void trace(Environment* global_env) {
+    bool young_only = gc_work.young_only;
+    while (gc_work.length > 0) {
+        Gc_Work_Item item = gc_work.items[--gc_work.length];
+        Environment* env = item.env;
+        while (env != NULL && \
+               env->gc_mark != gc_epoch && \
+               !(young_only && env->gc_old)) {
+            env->gc_mark = gc_epoch;
+            gc_traced++;
+            mark_bindings(env);
+            env = env->enclosing_env;
+        }
+        if (item.type == TYPE_FUNCTION) {
+            typed_ptr fn_tp = {.type=TYPE_FUNCTION, .ptr=item.value};
+            Function_Node* fn = function_lookup_index(global_env, &fn_tp);
+            if (fn != NULL && \
+                fn->gc_mark != gc_epoch && \
+                !(young_only && fn->gc_old)) {
+                fn->gc_mark = gc_epoch;
+                gc_traced++;
+                mark_environment(fn->enclosing_env);
+                mark_value(fn->code->body->type, fn->code->body->ptr);
+            }
+        } else if (item.type == TYPE_S_EXPR) {
+            s_expr* se = item.value.se_ptr;
+            while (se != NULL && se->gc_mark != gc_epoch) {
+                se->gc_mark = gc_epoch;
+                mark_value(se->car.type, se->car.ptr);
+                if (se->cdr.type != TYPE_S_EXPR) {
+                    mark_value(se->cdr.type, se->cdr.ptr);
+                    break;
+                }
+                se = se->cdr.ptr.se_ptr;
+            }
+        }
+    }
+    free(gc_work.items);
+    gc_work.items = NULL;
+    gc_work.capacity = 0;
+    return;
+}
+
+// Drops the code objects whose source no command refers to any more from the
+//   cache (see cache_function_code()). This walks the whole cache, however
+//   little of it is new, so only major collections do it.
+static void drop_unused_code(Function_Table* ft) {
+    for (unsigned int i = 0; i < ft->code_cache_capacity; i++) {
+        Function_Code** code_link = &ft->code_cache[i];
+        while (*code_link != NULL) {
+            Function_Code* code = *code_link;
+            if (code->source->refs > 1) {
+                code_link = &code->cache_next;
+            } else {
+                *code_link = code->cache_next;
+                delete_s_expr_recursive(code->source, true);
+                delete_function_code(code);
+                ft->code_cache_length--;
+            }
+        }
+    }
+    return;
+}
+
+// New functions and environments are always added at the head of their lists,
+//   so a minor collection only has to sweep up to the first old one.
+static void sweep(Environment* global_env, bool young_only) {
+    // everything is old once the sweep is done, so the remembered set starts
+    //   over
+    Environment* remembered = global_env->gc_remembered_next;
+    while (remembered != NULL) {
+        Environment* next = remembered->gc_remembered_next;
+        remembered->gc_remembered = false;
+        remembered->gc_remembered_next = NULL;
+        remembered = next;
+    }
+    global_env->gc_remembered_next = NULL;
+    Function_Table* ft = global_env->function_table;
+    if (!young_only) {
+        drop_unused_code(ft);
+    }
+    Function_Node** fn_link = &ft->head;
+    while (*fn_link != NULL && !(young_only && (*fn_link)->gc_old)) {
+        Function_Node* fn = *fn_link;
+        if (fn->gc_mark == gc_epoch) {
+            fn->gc_old = true;
+            fn_link = &fn->next;
+        } else {
+            *fn_link = fn->next;
+            release_function_slot(ft, fn->function_idx);
+            delete_function_node(fn);
+            ft->length--;
+        }
+    }
+    Environment** env_link = &global_env->env_tracker_next;
+    while (*env_link != NULL && !(young_only && (*env_link)->gc_old)) {
+        Environment* curr_env = *env_link;
+        if (curr_env->gc_mark == gc_epoch) {
+            curr_env->gc_old = true;
+            env_link = &curr_env->env_tracker_next;
+        } else {
+            *env_link = curr_env->env_tracker_next;
+            delete_environment(curr_env);
+        }
+    }
+    return;
+}
+
+// Pushes what the evaluator itself holds, for a collection made during an
+//   evaluation; only to be called by the mark_roots function passed to
+//   collect_garbage_with_roots().
+void mark_root_value(const typed_ptr* value) {
+    mark_value(value->type, value->ptr);
+    return;
+}
+
+void mark_root_environment(Environment* env) {
+    mark_environment(env);
+    return;
+}
+
+static void collect_all(Environment* global_env, void (*mark_roots)(void));
+
+static void collect_young(Environment* global_env, void (*mark_roots)(void)) {
+    if (gc_box_written) {
+        collect_all(global_env, mark_roots);
+        return;
+    }
+    gc_epoch++;
+    gc_work.young_only = true;
+    mark_bindings(global_env);
+    Environment* remembered = global_env->gc_remembered_next;
+    while (remembered != NULL) {
+        if (remembered->gc_old) {
+            mark_bindings(remembered);
+        } else {
+            // a frame handed over after a collection during its call (see
+            //   track_environment())
+            mark_environment(remembered);
+        }
+        remembered = remembered->gc_remembered_next;
+    }
+    if (mark_roots != NULL) {
+        mark_roots();
+    }
+    trace(global_env);
+    sweep(global_env, true);
+    return;
+}
+
+static void collect_all(Environment* global_env, void (*mark_roots)(void)) {
+    gc_epoch++;
+    gc_work.young_only = false;
+    gc_box_written = false;
+    mark_environment(global_env);
+    if (mark_roots != NULL) {
+        mark_roots();
+    }
+    trace(global_env);
+    sweep(global_env, false);
+    return;
+}
+
+// Frees every young function and closure environment that can no longer be
+//   reached from the global environment's symbol table, and promotes the rest.
+// Old objects are neither traced nor freed.
+void collect_young_garbage(Environment* env) {
+    collect_young(env->global_env, NULL);
+    return;
+}
+
+// Frees every function and closure environment, young or old, that can no
+//   longer be reached from the global environment's symbol table.
+void collect_all_garbage(Environment* env) {
+    collect_all(env->global_env, NULL);
+    return;
+}
+
+// Runs a minor collection, or every so often a major one, with the roots
+//   mark_roots pushes (see mark_root_value()) as well as the global
+//   environment, if it is not NULL.
+// Values held only by the evaluator's C locals are not roots, so this must
+//   only be called where there are none that the collector would need to see:
+//   between top-level evaluations, once their results have been dealt with, or
+//   where the evaluator holds everything on stacks of its own, which
+//   mark_roots then pushes.
+void collect_garbage_with_roots(Environment* env, void (*mark_roots)(void)) {
+    gc_traced = 0;
+    if (++gc_minors_since_major > GC_MINORS_PER_MAJOR) {
+        gc_minors_since_major = 0;
+        collect_all(env->global_env, mark_roots);
+    } else {
+        collect_young(env->global_env, mark_roots);
+    }
+    gc_new_objects = 0;
+    gc_new_objects_due = (gc_traced > GC_MIN_NEW_OBJECTS) ? \
+                         gc_traced : \
+                         GC_MIN_NEW_OBJECTS;
+    return;
+}
+
+void collect_garbage(Environment* env) {
+    collect_garbage_with_roots(env, NULL);
+    return;
 }
@@ -4,15 +4,30 @@
 #include<stdlib.h>
 #include<stdio.h>
 #include<string.h>
+#include<stdint.h>
 
 #include "fundamentals.h"
 
+// symbol names (see intern_symbol_name())
+
+typedef struct NAME_CHUNK {
+    struct NAME_CHUNK* next;
+    unsigned int used;
+    unsigned int capacity;
+    char text[];
+} Name_Chunk;
+
 // symbol node
 
+// A binding in a call frame that a flat closure has captured is boxed (see
+//   create_closure_record()): its value is then a cell of its own, shared with
+//   the closure records, whose car holds the variable's value. Use
+//   binding_value() and set_binding_value() to get at it.
 typedef struct SYMBOL_NODE {
     unsigned int symbol_idx;
     char* name;
     type type;
+    bool boxed;
     tp_value value;
     struct SYMBOL_NODE* next;
 } Symbol_Node;
@@ -30,34 +45,105 @@ typedef struct SYMBOL_TABLE {
     Symbol_Node* head;
     unsigned int length;
     unsigned int offset;
+    Symbol_Node** name_index;
+    unsigned int name_index_capacity;
+    Symbol_Node** number_index;
+    unsigned int number_index_capacity;
+    Symbol_Node** builtin_index;
+    Name_Chunk* names;
 } Symbol_Table;
 
 Symbol_Table* create_symbol_table(unsigned int offset);
-void merge_symbol_tables(Symbol_Table* first, Symbol_Table* second);
+void delete_symbol_table_indices(Symbol_Table* st);
+void truncate_symbol_table(Symbol_Table* st, unsigned int length);
 
 // function node and function table
 
 struct ENVIRONMENT;
 
+// A flat code object's closures capture only the variables of enclosing
+//   frames that its body refers to (captures, resolved against the frame the
+//   closures are created in), sharing them with a closure record (see
+//   create_closure_record()); other code objects' closures keep the whole
+//   environment they were created in. assigned lists the symbols its body
+//   defines or sets (see make_closure()), and may_define those its body
+//   itself passes as the first argument of a form which, should the operator
+//   be rebound to define, would bind them in its frame (see
+//   find_indirect_assignments()). The global cache holds an entry for each
+//   global variable reference in the body (see cached_global_lookup()).
+typedef struct GLOBAL_CACHE_ENTRY {
+    long symbol_idx;
+    unsigned long version;
+    Symbol_Node* binding;
+} Global_Cache_Entry;
+
+// A code object's bytecode is its body compiled for the virtual machine (see
+//   compile()), the first time the code is called. It is a sequence of
+//   instruction words (an opcode followed by its operands), and a pool of the
+//   expressions in the body that instructions refer to by index.
+typedef struct BYTECODE {
+    unsigned int* code;
+    unsigned int length;
+    const typed_ptr** constants;
+    unsigned int constant_count;
+} Bytecode;
+
+void delete_bytecode(Bytecode* bytecode);
+
+typedef struct FUNCTION_CODE {
+    Symbol_Node* param_list;
+    typed_ptr* body;
+    int refs;
+    s_expr* source;
+    struct FUNCTION_CODE* cache_next;
+    bool flat;
+    typed_ptr* captures;
+    unsigned int capture_count;
+    long* assigned;
+    unsigned int assigned_count;
+    long* may_define;
+    unsigned int may_define_count;
+    Global_Cache_Entry* global_cache;
+    unsigned int global_cache_count;
+    Bytecode* bytecode;
+} Function_Code;
+
+Function_Code* create_function_code(Symbol_Node* param_list, typed_ptr* body);
+Function_Code* share_function_code(Function_Code* code);
+void delete_function_code(Function_Code* code);
+bool code_assigns(const Function_Code* code, long symbol_idx);
+void note_code_assignment(Function_Code* code, long symbol_idx);
+bool code_may_define(const Function_Code* code, long symbol_idx);
+void note_code_may_define(Function_Code* code, long symbol_idx);
+
 typedef struct FUNCTION_NODE {
     unsigned int function_idx;
     char* name;
-    Symbol_Node* param_list;
+    Function_Code* code;
     struct ENVIRONMENT* enclosing_env;
-    typed_ptr* body;
+    unsigned int gc_mark;
+    bool gc_old;
     struct FUNCTION_NODE* next;
 } Function_Node;
 
 Function_Node* create_function_node(unsigned int function_idx, \
                                     char* name, \
-                                    Symbol_Node* param_list, \
-                                    struct ENVIRONMENT* enclosing_env, \
-                                    typed_ptr* body);
+                                    Function_Code* code, \
+                                    struct ENVIRONMENT* enclosing_env);
+void delete_function_node(Function_Node* fn);
 
 typedef struct FUNCTION_TABLE {
     Function_Node* head;
     unsigned int length;
     unsigned int offset;
+    Function_Node** slots;
+    unsigned int slots_used;
+    unsigned int slots_capacity;
+    unsigned int* free_slots;
+    unsigned int free_slots_length;
+    Function_Code** code_cache;
+    unsigned int code_cache_capacity;
+    unsigned int code_cache_length;
 } Function_Table;
 
 Function_Table* create_function_table(unsigned int offset);
@@ -69,23 +155,50 @@ typedef struct ENVIRONMENT {
     Function_Table* function_table;
     struct ENVIRONMENT* enclosing_env;
     struct ENVIRONMENT* global_env;
+    Function_Code* code;
+    Symbol_Node* slots;
+    unsigned int slot_count;
+    bool extended;
     struct ENVIRONMENT* env_tracker_next;
+    bool captured;
+    unsigned int gc_mark;
+    bool gc_old;
+    bool gc_remembered;
+    struct ENVIRONMENT* gc_remembered_next;
 } Environment;
 
+// lexical addresses (see resolve_references())
+
+#define ADDRESS_UNRESOLVED 0u
+#define ADDRESS_GLOBAL 0xFFFFFFFFu
+#define ADDRESS_MAX_DEPTH 0xFFFCu
+#define ADDRESS_MAX_SLOT 0xFFFFu
+#define LOCAL_ADDRESS(depth, slot) ((((depth) + 1u) << 16) | (slot))
+#define ADDRESS_DEPTH(address) (((address) >> 16) - 1u)
+#define ADDRESS_SLOT(address) ((address) & 0xFFFFu)
+#define GLOBAL_SITE_ADDRESS(site) (0xFFFE0000u | (site))
+#define IS_GLOBAL_SITE(address) (((address) >> 16) == 0xFFFEu)
+#define ADDRESS_MAX_SITE 0xFFFFu
+
 Environment* create_environment(unsigned int symbol_start, \
                                 unsigned int function_start, \
                                 Environment* enclosing_env);
+Environment* create_call_frame(Function_Code* code, \
+                               Environment* enclosing_env);
+Environment* create_closure_record(Function_Code* code, Environment* env);
 void delete_environment(Environment* env);
 
 // adding things to an environment
 
 typed_ptr* install_symbol(Environment* env, char* name, typed_ptr* tp);
 void blind_install_symbol(Environment* env, char* name, typed_ptr* tp);
-typed_ptr* install_function(Environment* env, \
-                            char* name, \
-                            Symbol_Node* arg_list, \
-                            Environment* enclosing_env, \
-                            typed_ptr* body);
+typed_ptr install_function(Environment* env, \
+                           char* name, \
+                           Function_Code* code, \
+                           Environment* enclosing_env);
+void cache_function_code(Environment* env, \
+                         s_expr* source, \
+                         Function_Code* code);
 
 void setup_environment(Environment* env);
 void setup_symbol_table(Environment* env);
@@ -95,8 +208,24 @@ void setup_symbol_table(Environment* env);
 Symbol_Node* symbol_lookup_name(const Environment* env, const char* name);
 Symbol_Node* symbol_lookup_index(const Environment* env, const typed_ptr* tp);
 Symbol_Node* builtin_lookup_index(const Environment* env, const typed_ptr* tp);
-typed_ptr* value_lookup_index(const Environment* env, const typed_ptr* tp);
+typed_ptr value_lookup_index(const Environment* env, const typed_ptr* tp);
+typed_ptr binding_value(const Symbol_Node* sn);
+void set_binding_value(Environment* env, Symbol_Node* sn, typed_ptr value);
 Function_Node* function_lookup_index(const Environment* env, \
                                      const typed_ptr* tp);
+Function_Code* function_code_lookup(const Environment* env, \
+                                    const s_expr* source);
+
+// garbage collection
+
+void record_environment_write(Environment* env);
+void track_environment(Environment* env);
+bool garbage_collection_due(void);
+void mark_root_value(const typed_ptr* value);
+void mark_root_environment(Environment* env);
+void collect_young_garbage(Environment* env);
+void collect_all_garbage(Environment* env);
+void collect_garbage_with_roots(Environment* env, void (*mark_roots)(void));
+void collect_garbage(Environment* env);
 
 #endif
@@ -1,20 +1,67 @@
 #include "evaluate.h"
 
+// string-append results at least this long are built as ropes (see
+//   create_rope()) rather than copied into a fresh buffer
+#define STRING_ROPE_THRESHOLD 64
+
+static typed_ptr eval_and_or_tail(const s_expr* se, \
+                                  Environment* env, \
+                                  const typed_ptr** tail);
+static typed_ptr eval_cond_tail(const s_expr* se, \
+                                Environment* env, \
+                                const typed_ptr** tail);
+static typed_ptr enter_function(const s_expr* se, \
+                                Environment* env, \
+                                Environment** frame);
+static void release_frame(Environment* frame);
+static typed_ptr run_body(Environment* frame);
+
+// The number of calls of evaluate() and evaluate_cek() under way. Only where
+//   the outermost is the only one can the garbage collector run during an
+//   evaluation (see run_body()): a nested one may have been called by a
+//   built-in holding values in C locals, which the collector cannot see.
+static unsigned int evaluations = 0;
+
+static void mark_evaluator_roots(void);
+
+// Frees a value that will not be used: the result of an expression evaluated
+//   only for its effects, or a numeric built-in's argument that will not be
+//   folded in.
+static void discard_value(typed_ptr value) {
+    if (value.type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(value.ptr.se_ptr, true);
+    } else if (value.type == TYPE_STRING) {
+        delete_string(value.ptr.string);
+    }
+    return;
+}
+
 // Evaluates an s-expression of any kind within the context of the provided
 //   environment.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the result (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* evaluate(const typed_ptr* tp, Environment* env) {
-    typed_ptr* result = NULL;
-    if (tp == NULL) {
-        result = create_error_tp(EVAL_ERROR_NULL_S_EXPR);
-    } else {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+// Expressions in tail position (the last expression of the chosen cond clause,
+//   and the last argument of and/or) are evaluated by going around this loop
+//   again instead of by a nested call. A function's body is compiled, and run
+//   on the virtual machine (see run_body()), where calls in tail position take
+//   the place of the call that made them, so that tail recursion runs in
+//   constant space, and calls made from bytecode do not use the C stack. A
+//   built-in the machine hands a form to evaluates its arguments here,
+//   though, so recursion through those does, up to a bound (see Vm_Stacks).
+typed_ptr evaluate(const typed_ptr* tp, Environment* env) {
+    typed_ptr result;
+    evaluations++;
+    while (true) {
+        if (tp == NULL || tp->type == TYPE_NONE) {
+            result = error_tp(EVAL_ERROR_NULL_S_EXPR);
+            break;
+        }
         switch (tp->type) {
             case TYPE_UNDEF:
-                result = create_error_tp(EVAL_ERROR_UNDEF_SYM);
+                result = error_tp(EVAL_ERROR_UNDEF_SYM);
                 break;
             case TYPE_ERROR: // fall-through
             case TYPE_VOID: // fall-through
@@ -22,32 +69,70 @@ typed_ptr* evaluate(const typed_ptr* tp, Environment* env) {
             case TYPE_BOOL: // fall-through
             case TYPE_BUILTIN: // fall-through
             case TYPE_FUNCTION:
-                result = copy_typed_ptr(tp);
+                result = *tp;
                 break;
             case TYPE_STRING:
-                result = copy_typed_ptr(tp);
-                result->ptr.string = create_string(tp->ptr.string->contents);
-                break;
-            case TYPE_S_EXPR:
-                result = eval_s_expr(tp->ptr.se_ptr, env);
+                result = share_value(tp);
                 break;
             case TYPE_SYMBOL:
                 result = value_lookup_index(env, tp);
-                if (result == NULL) {
-                    result = create_error_tp(EVAL_ERROR_BAD_SYMBOL);
-                }
+                break;
+            case TYPE_S_EXPR:
                 break;
             default:
-                result = create_error_tp(EVAL_ERROR_UNDEF_TYPE);
+                result = error_tp(EVAL_ERROR_UNDEF_TYPE);
                 break;
         }
+        if (tp->type != TYPE_S_EXPR) {
+            break;
+        }
+        const s_expr* se = tp->ptr.se_ptr;
+        if (se == NULL) {
+            result = error_tp(EVAL_ERROR_NULL_S_EXPR);
+            break;
+        } else if (is_empty_list(se)) {
+            result = error_tp(EVAL_ERROR_MISSING_PROCEDURE);
+            break;
+        } else if (se->car.type == TYPE_NONE || se->cdr.type == TYPE_NONE) {
+            result = error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
+            break;
+        }
+        typed_ptr evaluated_car = evaluate(&se->car, env);
+        // the substituted s-expression only lives as long as this iteration,
+        //   so it can be built on the stack
+        s_expr subbed_se = {.car=evaluated_car, .cdr=se->cdr};
+        const typed_ptr* tail = NULL;
+        if (evaluated_car.type == TYPE_ERROR) {
+            result = evaluated_car;
+        } else if (evaluated_car.type == TYPE_FUNCTION) {
+            Environment* callee = NULL;
+            result = enter_function(&subbed_se, env, &callee);
+            if (result.type != TYPE_ERROR) {
+                result = run_body(callee);
+            }
+        } else if (evaluated_car.type != TYPE_BUILTIN) {
+            discard_value(evaluated_car);
+            result = error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
+        } else if (evaluated_car.ptr.idx == BUILTIN_COND) {
+            result = eval_cond_tail(&subbed_se, env, &tail);
+        } else if (evaluated_car.ptr.idx == BUILTIN_AND || \
+                   evaluated_car.ptr.idx == BUILTIN_OR) {
+            result = eval_and_or_tail(&subbed_se, env, &tail);
+        } else {
+            result = eval_builtin(&subbed_se, env);
+        }
+        if (tail == NULL) {
+            break;
+        }
+        tp = tail;
     }
+    evaluations--;
     return result;
 }
 
-typed_ptr* eval_builtin(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    switch (se->car->ptr.idx) {
+typed_ptr eval_builtin(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    switch (se->car.ptr.idx) {
         case BUILTIN_ADD: // fall-through
         case BUILTIN_MUL: // fall-through
         case BUILTIN_SUB: // fall-through
@@ -121,53 +206,19 @@ typed_ptr* eval_builtin(const s_expr* se, Environment* env) {
             result = eval_string_append(se, env);
             break;
         default:
-            result = create_error_tp(EVAL_ERROR_UNDEF_BUILTIN);
+            result = error_tp(EVAL_ERROR_UNDEF_BUILTIN);
             break;
     }
     return result;
 }
 
-typed_ptr* eval_s_expr(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
+// Evaluates an s-expression whose car is to be called; see evaluate().
+typed_ptr eval_s_expr(const s_expr* se, Environment* env) {
     if (se == NULL) {
-        return create_error_tp(EVAL_ERROR_NULL_S_EXPR);
-    } else if (is_empty_list(se)) {
-        return create_error_tp(EVAL_ERROR_MISSING_PROCEDURE);
-    } else if (se->car == NULL || se->cdr == NULL) {
-        return create_error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
-    } else {
-        typed_ptr* evaluated_car = evaluate(se->car, env);
-        switch (evaluated_car->type) {
-            case TYPE_ERROR:
-                result = copy_typed_ptr(evaluated_car);
-                break;
-            case TYPE_BUILTIN: {
-                s_expr* subbed_se = create_s_expr(evaluated_car, se->cdr);
-                result = eval_builtin(subbed_se, env);
-                free(subbed_se);
-                break;
-            }
-            case TYPE_FUNCTION: {
-                s_expr* subbed_se = create_s_expr(evaluated_car, se->cdr);
-                result = eval_function(subbed_se, env);
-                free(subbed_se);
-                break;
-            }
-            case TYPE_STRING:
-                delete_string(evaluated_car->ptr.string);
-                result = create_error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
-                break;
-            case TYPE_S_EXPR:
-                delete_s_expr_recursive(evaluated_car->ptr.se_ptr, true);
-                result = create_error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
-                break;
-            default:
-                result = create_error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
-                break;
-        }
-        free(evaluated_car);
+        return error_tp(EVAL_ERROR_NULL_S_EXPR);
     }
-    return result;
+    typed_ptr se_tp = s_expr_tp((s_expr*)se);
+    return evaluate(&se_tp, env);
 }
 
 // Evaluates an s-expression whose car has type TYPE_FUNCTION.
@@ -177,31 +228,140 @@ typed_ptr* eval_s_expr(const s_expr* se, Environment* env) {
 // Returns a typed_ptr containing an error code (if any argument evaluation
 //   failed, or if an error arising during evaluation of the function body) or
 //   the result of evaluating the function body using the provided arguments.
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_function(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    Function_Node* fn = function_lookup_index(env, se->car);
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+// The environment the body is evaluated in is released as soon as the call
+//   returns (see release_frame()).
+typed_ptr eval_function(const s_expr* se, Environment* env) {
+    Environment* frame = NULL;
+    typed_ptr result = enter_function(se, env, &frame);
+    if (result.type == TYPE_ERROR) {
+        return result;
+    }
+    return run_body(frame);
+}
+
+// Looks up the function an s-expression calls, evaluates its arguments, and
+//   binds them in a new call frame, which is returned through frame; the body
+//   is left for the caller to evaluate there (see evaluate()), and the frame
+//   for it to release with release_frame() afterwards.
+// Returns void, or the error that kept the frame from being made.
+static typed_ptr enter_function(const s_expr* se, \
+                                Environment* env, \
+                                Environment** frame) {
+    Function_Node* fn = function_lookup_index(env, &se->car);
     if (fn == NULL) {
-        return create_error_tp(EVAL_ERROR_UNDEF_FUNCTION);
+        return error_tp(EVAL_ERROR_UNDEF_FUNCTION);
     }
-    typed_ptr* args_tp = collect_arguments(se, env, 0, -1, true);
-    if (args_tp->type == TYPE_ERROR) {
-        result = args_tp;
+    typed_ptr args_tp = collect_arguments(se, env, 0, -1, true);
+    if (args_tp.type == TYPE_ERROR) {
+        return args_tp;
+    }
+    Environment* callee = create_call_frame(fn->code, fn->enclosing_env);
+    typed_ptr result = bind_args(callee, &args_tp);
+    if (result.type == TYPE_ERROR) {
+        delete_environment(callee);
     } else {
-        Symbol_Node* arg_vals = bind_args(fn, args_tp);
-        if (arg_vals != NULL && arg_vals->type == TYPE_ERROR) {
-            result = create_error_tp(arg_vals->value.idx);
-        } else {
-            Environment* bound_env = make_eval_env(fn->enclosing_env, arg_vals);
-            result = evaluate(fn->body, bound_env);
-            bound_env->env_tracker_next = env->global_env->env_tracker_next;
-            env->global_env->env_tracker_next = bound_env;
-        }
-        delete_symbol_node_list(arg_vals);
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        *frame = callee;
+    }
+    delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
+    return result;
+}
+
+// A call's frame is freed as soon as the call is done with it, unless a
+//   closure created during the call has captured it; only then is it handed
+//   over to the collector (see collect_garbage()).
+static void release_frame(Environment* frame) {
+    if (frame->captured) {
+        // a closure created during the call still refers to it
+        track_environment(frame);
+    } else {
+        delete_environment(frame);
+    }
+    return;
+}
+
+// Evaluates the argument at the head of a numeric built-in's argument list, and
+//   advances the list past it.
+// The numeric built-ins fold their arguments in as they are evaluated, instead
+//   of gathering them with collect_arguments() first, so an all-fixnum call
+//   allocates no list cells at all. Errors keep the precedence they have there:
+//   a malformed argument list or a failed evaluation beats a type error.
+static typed_ptr evaluate_next_argument(const s_expr** arg_se, \
+                                        Environment* env) {
+    if (is_pair(*arg_se)) {
+        return error_tp(EVAL_ERROR_ILLEGAL_PAIR);
+    }
+    typed_ptr arg = evaluate(&(*arg_se)->car, env);
+    *arg_se = s_expr_next(*arg_se);
+    return arg;
+}
+
+// Folds one fixnum operand into a running total, returning the new total, or
+//   the error (overflow, underflow, or division by zero) the step hit.
+static typed_ptr fixnum_step(builtin_code op, long total, long operand) {
+    typed_ptr result;
+    long out;
+    switch (op) {
+        case BUILTIN_ADD:
+            if (__builtin_add_overflow(total, operand, &out)) {
+                result = error_tp((operand < 0) ? EVAL_ERROR_FIXNUM_UNDER : \
+                                                  EVAL_ERROR_FIXNUM_OVER);
+            } else {
+                result = atom_tp(TYPE_FIXNUM, out);
+            }
+            break;
+        case BUILTIN_SUB:
+            if (__builtin_sub_overflow(total, operand, &out)) {
+                result = error_tp((operand > 0) ? EVAL_ERROR_FIXNUM_UNDER : \
+                                                  EVAL_ERROR_FIXNUM_OVER);
+            } else {
+                result = atom_tp(TYPE_FIXNUM, out);
+            }
+            break;
+        case BUILTIN_MUL:
+            if (__builtin_mul_overflow(total, operand, &out)) {
+                result = error_tp(((total < 0) != (operand < 0)) ? \
+                                  EVAL_ERROR_FIXNUM_UNDER : \
+                                  EVAL_ERROR_FIXNUM_OVER);
+            } else {
+                result = atom_tp(TYPE_FIXNUM, out);
+            }
+            break;
+        case BUILTIN_DIV:
+            if (operand == 0) {
+                result = error_tp(EVAL_ERROR_DIV_ZERO);
+            } else if (total == LONG_MIN && operand == -1) {
+                result = error_tp(EVAL_ERROR_FIXNUM_OVER);
+            } else {
+                result = atom_tp(TYPE_FIXNUM, total / operand);
+            }
+            break;
+        default:
+            result = error_tp(EVAL_ERROR_UNDEF_BUILTIN);
+            break;
+    }
+    return result;
+}
+
+// Folds an evaluated argument of an arithmetic built-in into the running
+//   result, returning the new result; an argument that seeds the total
+//   replaces it instead. Once the result is an error, later arguments are only
+//   freed.
+static typed_ptr arithmetic_step(builtin_code op, \
+                                 typed_ptr result, \
+                                 typed_ptr arg, \
+                                 bool seeds_total) {
+    if (result.type == TYPE_ERROR) {
+        discard_value(arg);
+    } else if (arg.type != TYPE_FIXNUM) {
+        discard_value(arg);
+        result = error_tp(EVAL_ERROR_NEED_NUM);
+    } else if (seeds_total) {
+        result.ptr.idx = arg.ptr.idx;
+    } else {
+        result = fixnum_step(op, result.ptr.idx, arg.ptr.idx);
     }
     return result;
 }
@@ -214,104 +374,77 @@ typed_ptr* eval_function(const s_expr* se, Environment* env) {
 // Every argument to the built-in function is evaluated.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the resulting number (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_arithmetic(const s_expr* se, Environment* env) {
-    builtin_code op = se->car->ptr.idx;
-    int min_args = (op == BUILTIN_ADD || op == BUILTIN_MUL) ? 0 : 1;
-    typed_ptr* args_tp = collect_arguments(se, env, min_args, -1, true);
-    if (args_tp->type == TYPE_ERROR) {
-        return args_tp;
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_arithmetic(const s_expr* se, Environment* env) {
+    builtin_code op = se->car.ptr.idx;
+    if (is_pair(se)) {
+        return error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     }
+    bool inverse_op = (op == BUILTIN_SUB || op == BUILTIN_DIV);
     long initial = (op == BUILTIN_ADD || op == BUILTIN_SUB) ? 0 : 1;
-    typed_ptr* result = create_atom_tp(TYPE_FIXNUM, initial);
-    s_expr* arg = args_tp->ptr.se_ptr;
-    if ((op == BUILTIN_SUB || op == BUILTIN_DIV) && \
-        !is_empty_list(s_expr_next(arg))) {
-        if (arg->car->type != TYPE_FIXNUM) {
-            free(result);
-            result = create_error_tp(EVAL_ERROR_NEED_NUM);
-        } else {
-            result->ptr.idx = arg->car->ptr.idx;
-            arg = s_expr_next(arg);
+    typed_ptr result = atom_tp(TYPE_FIXNUM, initial);
+    const s_expr* arg_se = s_expr_next(se);
+    bool first = true;
+    while (!is_empty_list(arg_se)) {
+        // the first of several arguments to BUILTIN_SUB or BUILTIN_DIV is the
+        //   starting total; a lone one is applied to the initial value
+        bool seeds_total = first && \
+                           inverse_op && \
+                           !is_pair(arg_se) && \
+                           !is_empty_list(s_expr_next(arg_se));
+        typed_ptr arg = evaluate_next_argument(&arg_se, env);
+        if (arg.type == TYPE_ERROR) {
+            return arg;
         }
+        result = arithmetic_step(op, result, arg, seeds_total);
+        first = false;
     }
-    while (result->type != TYPE_ERROR && !is_empty_list(arg)) {
-        if (arg->car->type != TYPE_FIXNUM) {
-            free(result);
-            result = create_error_tp(EVAL_ERROR_NEED_NUM);
-            break;
-        }
+    if (first && inverse_op) {
+        result = error_tp(EVAL_ERROR_FEW_ARGS);
+    }
+    return result;
+}
+
+// Compares the seen-th evaluated argument of a numeric comparison with the one
+//   before it (kept in last_num), returning the running result.
+static typed_ptr comparison_step(builtin_code op, \
+                                 typed_ptr result, \
+                                 typed_ptr arg, \
+                                 long* last_num, \
+                                 int seen) {
+    // once the answer is settled, the rest are only evaluated
+    if (result.type != TYPE_BOOL || result.ptr.idx == false) {
+        discard_value(arg);
+        return result;
+    } else if (arg.type != TYPE_FIXNUM) {
+        discard_value(arg);
+        return error_tp(EVAL_ERROR_NEED_NUM);
+    }
+    if (seen > 1) {
         switch (op) {
-            case BUILTIN_ADD:
-                if (arg->car->ptr.idx < 0 && \
-                    result->ptr.idx < (LONG_MIN - arg->car->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_UNDER);
-                } else if (arg->car->ptr.idx > 0 && \
-                           result->ptr.idx > (LONG_MAX - arg->car->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_OVER);
-                } else {
-                    result->ptr.idx += arg->car->ptr.idx;
-                }
+            case BUILTIN_NUMBEREQ:
+                result.ptr.idx = *last_num == arg.ptr.idx;
                 break;
-            case BUILTIN_SUB:
-                if (arg->car->ptr.idx > 0 && \
-                    result->ptr.idx < (LONG_MIN + arg->car->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_UNDER);
-                } else if (arg->car->ptr.idx < 0 && \
-                           result->ptr.idx > (LONG_MAX + arg->car->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_OVER);
-                } else {
-                    result->ptr.idx -= arg->car->ptr.idx;
-                }
+            case BUILTIN_NUMBERGT:
+                result.ptr.idx = *last_num > arg.ptr.idx;
                 break;
-            case BUILTIN_MUL:
-                if ((result->ptr.idx < 0 && \
-                     arg->car->ptr.idx > 0 && \
-                     result->ptr.idx < LONG_MIN / arg->car->ptr.idx) || \
-                    (result->ptr.idx > 0 && \
-                     arg->car->ptr.idx < 0 && \
-                     arg->car->ptr.idx < LONG_MIN / result->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_UNDER);
-                } else if ((result->ptr.idx < 0 && \
-                            arg->car->ptr.idx < 0 && \
-                            arg->car->ptr.idx < LONG_MAX / result->ptr.idx) || \
-                           (result->ptr.idx > 0 && \
-                            arg->car->ptr.idx > 0 && \
-                            result->ptr.idx > LONG_MAX / arg->car->ptr.idx)) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_OVER);
-                } else {
-                    result->ptr.idx *= arg->car->ptr.idx;
-                }
+            case BUILTIN_NUMBERLT:
+                result.ptr.idx = *last_num < arg.ptr.idx;
                 break;
-            case BUILTIN_DIV:
-                if (arg->car->ptr.idx == 0) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_DIV_ZERO);
-                } else if (result->ptr.idx == LONG_MIN && \
-                           arg->car->ptr.idx == -1) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_FIXNUM_OVER);
-                } else {
-                    result->ptr.idx /= arg->car->ptr.idx;
-                }
+            case BUILTIN_NUMBERGE:
+                result.ptr.idx = *last_num >= arg.ptr.idx;
+                break;
+            case BUILTIN_NUMBERLE:
+                result.ptr.idx = *last_num <= arg.ptr.idx;
                 break;
             default:
-                free(result);
-                result = create_error_tp(EVAL_ERROR_UNDEF_BUILTIN);
+                result = error_tp(EVAL_ERROR_UNDEF_BUILTIN);
                 break;
         }
-        arg = s_expr_next(arg);
     }
-    delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-    free(args_tp);
+    *last_num = arg.ptr.idx;
     return result;
 }
 
@@ -322,62 +455,449 @@ typed_ptr* eval_arithmetic(const s_expr* se, Environment* env) {
 // Every argument to the built-in function is evaluated.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the (boolean) truth value of the expression (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_comparison(const s_expr* se, Environment* env) {
-    builtin_code op = se->car->ptr.idx;
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, -1, true);
-    if (args_tp->type == TYPE_ERROR) {
-        result = args_tp;
-    } else {
-        s_expr* arg_se = args_tp->ptr.se_ptr;
-        if (arg_se->car->type != TYPE_FIXNUM) {
-            result = create_error_tp(EVAL_ERROR_NEED_NUM);
-        } else {
-            long truth = true;
-            long last_num = arg_se->car->ptr.idx;
-            arg_se = s_expr_next(arg_se);
-            while (!is_empty_list(arg_se) && truth == true) {
-                if (arg_se->car->type != TYPE_FIXNUM) {
-                    result = create_error_tp(EVAL_ERROR_NEED_NUM);
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_comparison(const s_expr* se, Environment* env) {
+    builtin_code op = se->car.ptr.idx;
+    if (is_pair(se)) {
+        return error_tp(EVAL_ERROR_ILLEGAL_PAIR);
+    }
+    typed_ptr result = atom_tp(TYPE_BOOL, true);
+    long last_num = 0;
+    int seen = 0;
+    const s_expr* arg_se = s_expr_next(se);
+    while (!is_empty_list(arg_se)) {
+        typed_ptr arg = evaluate_next_argument(&arg_se, env);
+        if (arg.type == TYPE_ERROR) {
+            return arg;
+        }
+        seen++;
+        result = comparison_step(op, result, arg, &last_num, seen);
+    }
+    if (seen < 2) {
+        result = error_tp(EVAL_ERROR_FEW_ARGS);
+    }
+    return result;
+}
+
+// Finds the lexical address of a reference to the given symbol made in the
+//   body of a function with the given parameters, whose closures are created
+//   in env (see resolve_references()).
+static unsigned int lexical_address(const Symbol_Node* params, \
+                                    const Environment* env, \
+                                    long symbol_idx) {
+    unsigned int slot = 0;
+    for (const Symbol_Node* param = params; \
+         param != NULL && slot <= ADDRESS_MAX_SLOT; \
+         param = param->next, slot++) {
+        if (param->symbol_idx == symbol_idx) {
+            return LOCAL_ADDRESS(0, slot);
+        }
+    }
+    for (unsigned int depth = 1; depth <= ADDRESS_MAX_DEPTH; depth++) {
+        if (env->enclosing_env == NULL) {
+            return ADDRESS_GLOBAL;
+        } else if (env->code == NULL) {
+            // not a call frame, so nothing is known about its bindings
+            return ADDRESS_UNRESOLVED;
+        }
+        for (slot = 0; \
+             slot < env->slot_count && slot <= ADDRESS_MAX_SLOT; \
+             slot++) {
+            if (env->slots[slot].symbol_idx == symbol_idx) {
+                return LOCAL_ADDRESS(depth, slot);
+            }
+        }
+        env = env->enclosing_env;
+    }
+    return ADDRESS_UNRESOLVED;
+}
+
+// Returns the slot the symbol is captured in by the flat code object's
+//   closure records, or the code's capture count if it is not captured.
+static unsigned int capture_slot(const Function_Code* code, long symbol_idx) {
+    unsigned int slot = 0;
+    while (slot < code->capture_count && \
+           code->captures[slot].ptr.idx != symbol_idx) {
+        slot++;
+    }
+    return slot;
+}
+
+static void add_capture(Function_Code* code, long symbol_idx, \
+                        unsigned int address) {
+    typed_ptr* captures = realloc(code->captures, \
+                                  (code->capture_count + 1) * \
+                                  sizeof(typed_ptr));
+    if (captures == NULL) {
+        fprintf(stderr, "realloc failed in add_capture()\n");
+        exit(-1);
+    }
+    captures[code->capture_count] = atom_tp(TYPE_SYMBOL, symbol_idx);
+    captures[code->capture_count].address = address;
+    code->captures = captures;
+    code->capture_count++;
+    return;
+}
+
+// Walks the whole of a body, nested lambdas included, noting the symbols it
+//   defines or sets, and the variables of enclosing frames it refers to. The
+//   code stops being flat if any reference might be to a binding that a define
+//   or set! in one of the enclosing functions could change or shadow after the
+//   closure is made, or if the bindings of some enclosing environment are not
+//   known.
+// Special forms are recognized by their global bindings when the code is
+//   compiled. Anything else that looks like a reference counts as one, which
+//   at worst captures a variable that is never used.
+static void find_free_variables(const typed_ptr* tp, \
+                                Function_Code* code, \
+                                const Environment* env) {
+    if (tp->type == TYPE_SYMBOL) {
+        unsigned int address = lexical_address(code->param_list, \
+                                               env, \
+                                               tp->ptr.idx);
+        if (address == ADDRESS_UNRESOLVED) {
+            code->flat = false;
+        } else if (address != ADDRESS_GLOBAL && \
+                   ADDRESS_DEPTH(address) > 0 && \
+                   capture_slot(code, tp->ptr.idx) == code->capture_count) {
+            add_capture(code, \
+                        tp->ptr.idx, \
+                        LOCAL_ADDRESS(ADDRESS_DEPTH(address) - 1, \
+                                      ADDRESS_SLOT(address)));
+        }
+        // a frame the reference passes over on its way to its binding could
+        //   also gain a binding that shadows it
+        unsigned int depth = 1;
+        for (const Environment* outer = env; \
+             outer->enclosing_env != NULL; \
+             outer = outer->enclosing_env, depth++) {
+            if (code_assigns(outer->code, tp->ptr.idx) || \
+                ((address == ADDRESS_GLOBAL || \
+                  depth < ADDRESS_DEPTH(address)) && \
+                 code_may_define(outer->code, tp->ptr.idx))) {
+                code->flat = false;
+            }
+        }
+        return;
+    } else if (tp->type != TYPE_S_EXPR || is_empty_list(tp->ptr.se_ptr)) {
+        return;
+    }
+    s_expr* se = tp->ptr.se_ptr;
+    if (se->car.type == TYPE_SYMBOL && \
+        se->cdr.type == TYPE_S_EXPR && \
+        !is_empty_list(s_expr_next(se))) {
+        Symbol_Node* global = symbol_lookup_index(env->global_env, &se->car);
+        if (global != NULL && \
+            global->type == TYPE_BUILTIN && \
+            (global->value.idx == BUILTIN_DEFINE || \
+             global->value.idx == BUILTIN_SETVAR)) {
+            const typed_ptr* target = &s_expr_next(se)->car;
+            if (target->type == TYPE_S_EXPR && \
+                !is_empty_list(target->ptr.se_ptr)) {
+                target = &target->ptr.se_ptr->car;
+            }
+            if (target->type == TYPE_SYMBOL) {
+                note_code_assignment(code, target->ptr.idx);
+            }
+        }
+    }
+    while (!is_empty_list(se)) {
+        find_free_variables(&se->car, code, env);
+        if (se->cdr.type != TYPE_S_EXPR) {
+            break;
+        }
+        se = s_expr_next(se);
+    }
+    return;
+}
+
+// The parameter lists of the lambdas a walk of a body has entered, innermost
+//   first (see find_indirect_assignments()).
+typedef struct SHADOWED_PARAMS {
+    const s_expr* params;
+    const struct SHADOWED_PARAMS* next;
+} Shadowed_Params;
+
+static bool is_shadowed(const Shadowed_Params* shadowed, long symbol_idx) {
+    for (; shadowed != NULL; shadowed = shadowed->next) {
+        for (const s_expr* param = shadowed->params; \
+             !is_empty_list(param); \
+             param = s_expr_next(param)) {
+            if (param->car.type == TYPE_SYMBOL && \
+                param->car.ptr.idx == symbol_idx) {
+                return true;
+            }
+            if (param->cdr.type != TYPE_S_EXPR) {
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+// Returns the global binding of the operator of a form in a body, if the
+//   operator is a symbol that can only refer to it: one that is neither a
+//   parameter of the code or of a lambda in it, nor defined or set anywhere
+//   in it, nor bound in an enclosing frame. Returns NULL otherwise.
+static Symbol_Node* global_operator(const typed_ptr* op, \
+                                    const Function_Code* code, \
+                                    const Environment* env, \
+                                    const Shadowed_Params* shadowed) {
+    if (op->type != TYPE_SYMBOL || \
+        is_shadowed(shadowed, op->ptr.idx) || \
+        code_assigns(code, op->ptr.idx) || \
+        lexical_address(code->param_list, env, op->ptr.idx) != \
+        ADDRESS_GLOBAL) {
+        return NULL;
+    }
+    return symbol_lookup_index(env->global_env, op);
+}
+
+// Walks a body after find_free_variables() has, noting as assigned the first
+//   argument of any form whose operator might be define or set! when it is
+//   evaluated, though it is not recognized as one when the code is compiled:
+//   a parameter, say, or an expression, could evaluate to either. A symbol
+//   globally bound to some other built-in or to a function is assumed not to
+//   assign anything, as when special forms are recognized.
+// That binding may still change before the form is evaluated. A set! the
+//   form then makes is seen by closures all the same, since captured bindings
+//   are boxed (see create_closure_record()); but a define outside any nested
+//   lambda would bind a new variable in the code's frame, so the first
+//   arguments of such forms are noted as ones the code may define.
+static void find_indirect_assignments(const typed_ptr* tp, \
+                                      Function_Code* code, \
+                                      const Environment* env, \
+                                      const Shadowed_Params* shadowed) {
+    if (tp->type != TYPE_S_EXPR || is_empty_list(tp->ptr.se_ptr)) {
+        return;
+    }
+    const s_expr* se = tp->ptr.se_ptr;
+    Symbol_Node* global = global_operator(&se->car, code, env, shadowed);
+    bool has_args = se->cdr.type == TYPE_S_EXPR && \
+                    !is_empty_list(s_expr_next(se));
+    if (global != NULL && global->type == TYPE_BUILTIN) {
+        if (global->value.idx == BUILTIN_QUOTE) {
+            return;
+        } else if (has_args && \
+                   (global->value.idx == BUILTIN_LAMBDA || \
+                    global->value.idx == BUILTIN_DEFINE || \
+                    global->value.idx == BUILTIN_SETVAR)) {
+            // the first argument is a target or parameter list, and the
+            //   parameters in it shadow anything outside in the rest
+            const s_expr* first = s_expr_next(se);
+            Shadowed_Params inner = {NULL, shadowed};
+            if (first->car.type == TYPE_S_EXPR) {
+                inner.params = first->car.ptr.se_ptr;
+            }
+            const Shadowed_Params* rest_shadowed = \
+                (inner.params == NULL) ? shadowed : &inner;
+            for (const s_expr* rest = first; \
+                 rest->cdr.type == TYPE_S_EXPR && \
+                 !is_empty_list(s_expr_next(rest)); \
+                 rest = s_expr_next(rest)) {
+                find_indirect_assignments(&s_expr_next(rest)->car, \
+                                          code, \
+                                          env, \
+                                          rest_shadowed);
+            }
+            return;
+        }
+    }
+    if (has_args) {
+        const typed_ptr* target = &s_expr_next(se)->car;
+        if (target->type == TYPE_S_EXPR && \
+            !is_empty_list(target->ptr.se_ptr)) {
+            target = &target->ptr.se_ptr->car;
+        }
+        if (target->type == TYPE_SYMBOL && \
+            (global == NULL || \
+             (global->type != TYPE_BUILTIN && \
+              global->type != TYPE_FUNCTION))) {
+            note_code_assignment(code, target->ptr.idx);
+        } else if (target->type == TYPE_SYMBOL && shadowed == NULL) {
+            note_code_may_define(code, target->ptr.idx);
+        }
+    }
+    while (!is_empty_list(se)) {
+        find_indirect_assignments(&se->car, code, env, shadowed);
+        if (se->cdr.type != TYPE_S_EXPR) {
+            break;
+        }
+        se = s_expr_next(se);
+    }
+    return;
+}
+
+// Decides whether a newly compiled code object, whose closures are created in
+//   env, can be flat, and if so which variables its closures capture.
+static void analyze_captures(Function_Code* code, const Environment* env) {
+    code->flat = true;
+    for (const Environment* outer = env; \
+         outer->enclosing_env != NULL; \
+         outer = outer->enclosing_env) {
+        if (outer->code == NULL) {
+            code->flat = false;
+            return;
+        }
+    }
+    find_free_variables(code->body, code, env);
+    find_indirect_assignments(code->body, code, env, NULL);
+    for (unsigned int slot = 0; slot < code->capture_count; slot++) {
+        if (code_assigns(code, code->captures[slot].ptr.idx)) {
+            code->flat = false;
+        }
+    }
+    if (!code->flat || code->capture_count > ADDRESS_MAX_SLOT + 1) {
+        code->flat = false;
+        free(code->captures);
+        code->captures = NULL;
+        code->capture_count = 0;
+    }
+    return;
+}
+
+// Adds an empty entry to the code's global cache, returning its site.
+static unsigned int add_global_site(Function_Code* code) {
+    Global_Cache_Entry* cache = realloc(code->global_cache, \
+                                        (code->global_cache_count + 1) * \
+                                        sizeof(Global_Cache_Entry));
+    if (cache == NULL) {
+        fprintf(stderr, "realloc failed in add_global_site()\n");
+        exit(-1);
+    }
+    cache[code->global_cache_count].symbol_idx = 0;
+    cache[code->global_cache_count].version = 0;
+    cache[code->global_cache_count].binding = NULL;
+    code->global_cache = cache;
+    return code->global_cache_count++;
+}
+
+// Gives each variable reference in a function body the lexical address of the
+//   binding it refers to: either a parameter slot in a call frame so many
+//   levels out (one per enclosing lambda), or the global environment, by way
+//   of a site in the code's global cache. Once a reference has an address,
+//   looking it up no longer searches any symbol tables (see
+//   value_lookup_index()). In a flat code object's body, every variable of an
+//   enclosing frame is found one level out, in the closure record.
+// A body is resolved once, when its code object is compiled, using the
+//   parameter lists of the functions whose call frames the closures will be
+//   created in. Nested lambda and function definition bodies are left alone:
+//   they are resolved when their own code is compiled, with their own frame
+//   in place.
+// Only the hidden address of a symbol is ever set (see typed_ptr), so a
+//   reference that is not really a variable (because, say, a special form was
+//   bound to another name) is unharmed; and address_lookup() falls back on an
+//   ordinary search when a define has since shadowed the binding.
+static void resolve_references(typed_ptr* tp, \
+                               Function_Code* code, \
+                               const Environment* env) {
+    const Symbol_Node* params = code->param_list;
+    if (tp->type == TYPE_SYMBOL) {
+        tp->address = lexical_address(params, env, tp->ptr.idx);
+        if (tp->address == ADDRESS_GLOBAL) {
+            if (code->global_cache_count <= ADDRESS_MAX_SITE) {
+                tp->address = GLOBAL_SITE_ADDRESS(add_global_site(code));
+            }
+        } else if (code->flat && \
+                   tp->address != ADDRESS_UNRESOLVED && \
+                   ADDRESS_DEPTH(tp->address) > 0) {
+            tp->address = LOCAL_ADDRESS(1, capture_slot(code, tp->ptr.idx));
+        }
+        return;
+    } else if (tp->type != TYPE_S_EXPR || is_empty_list(tp->ptr.se_ptr)) {
+        return;
+    }
+    s_expr* se = tp->ptr.se_ptr;
+    if (se->car.type == TYPE_SYMBOL && \
+        lexical_address(params, env, se->car.ptr.idx) == ADDRESS_GLOBAL) {
+        Symbol_Node* global = symbol_lookup_index(env->global_env, &se->car);
+        if (global != NULL && global->type == TYPE_BUILTIN) {
+            switch (global->value.idx) {
+                case BUILTIN_LAMBDA: // fall-through
+                case BUILTIN_QUOTE:
+                    return;
+                case BUILTIN_DEFINE:
+                    if (se->cdr.type == TYPE_S_EXPR && \
+                        !is_empty_list(s_expr_next(se)) && \
+                        s_expr_next(se)->car.type == TYPE_S_EXPR) {
+                        return;
+                    }
                     break;
-                }
-                switch (op) {
-                    case BUILTIN_NUMBEREQ:
-                        truth = last_num == arg_se->car->ptr.idx;
-                        break;
-                    case BUILTIN_NUMBERGT:
-                        truth = last_num > arg_se->car->ptr.idx;
-                        break;
-                    case BUILTIN_NUMBERLT:
-                        truth = last_num < arg_se->car->ptr.idx;
-                        break;
-                    case BUILTIN_NUMBERGE:
-                        truth = last_num >= arg_se->car->ptr.idx;
-                        break;
-                    case BUILTIN_NUMBERLE:
-                        truth = last_num <= arg_se->car->ptr.idx;
-                        break;
-                    default:
-                        result = create_error_tp(EVAL_ERROR_UNDEF_BUILTIN);
-                        break;
-                }
-                if (result != NULL) {
+                default:
                     break;
-                }
-                last_num = arg_se->car->ptr.idx;
-                arg_se = s_expr_next(arg_se);
             }
-            if (result == NULL) {
-                result = create_atom_tp(TYPE_BOOL, truth);
-            } // otherwise it threw an error
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
     }
-    return result;
+    while (!is_empty_list(se)) {
+        resolve_references(&se->car, code, env);
+        if (se->cdr.type != TYPE_S_EXPR) {
+            break;
+        }
+        se = s_expr_next(se);
+    }
+    return;
+}
+
+// Installs a closure of the code created in env, taking over the caller's
+//   reference to the code. A flat closure is enclosed by a record of the
+//   variables it captures (or, if there are none, by the global environment
+//   itself), so that env can be freed as soon as its call returns.
+static typed_ptr close_over(Environment* env, char* name, Function_Code* code) {
+    if (!code->flat) {
+        return install_function(env, name, code, env);
+    } else if (code->capture_count == 0) {
+        return install_function(env, name, code, env->global_env);
+    }
+    Environment* record = create_closure_record(code, env);
+    track_environment(record);
+    return install_function(env, name, code, record);
+}
+
+// Creates a closure over env from a lambda's parameter list and body, compiling
+//   them into a code object unless one has already been compiled from the same
+//   source cell (see cache_function_code()); source is the cell holding the
+//   parameter list, and the body after it.
+// Returns a typed_ptr containing an error code (if the parameter list is
+//   malformed) or the installed function, which owns no storage of its own.
+static typed_ptr make_closure(Environment* env, \
+                              s_expr* source, \
+                              typed_ptr* params_tp, \
+                              char* name) {
+    Function_Code* code = function_code_lookup(env, source);
+    if (code != NULL) {
+        return close_over(env, name, share_function_code(code));
+    }
+    if (params_tp->type != TYPE_S_EXPR) {
+        return error_tp(EVAL_ERROR_BAD_SYNTAX);
+    }
+    Symbol_Node* params = collect_parameters(params_tp, env);
+    if (params != NULL && params->type == TYPE_ERROR) {
+        typed_ptr err = error_tp(params->value.idx);
+        delete_symbol_node_list(params);
+        return err;
+    }
+    typed_ptr body_value = share_value(&s_expr_next(source)->car);
+    code = create_function_code(params, copy_typed_ptr(&body_value));
+    analyze_captures(code, env);
+    resolve_references(code->body, code, env);
+    cache_function_code(env, source, code);
+    return close_over(env, name, code);
+}
+
+// Evaluates the value a define or set! binds. Nothing the collector needs to
+//   see is held while it is, so this evaluation counts as the one that called
+//   the special form (see evaluations), and a collection may be made during it
+//   wherever one could have been made there.
+static typed_ptr evaluate_bound_value(const typed_ptr* tp, Environment* env) {
+    if (evaluations == 0) {
+        return evaluate(tp, env);
+    }
+    evaluations--;
+    typed_ptr value = evaluate(tp, env);
+    evaluations++;
+    return value;
 }
 
 // Evaluates an s-expression whose car is the built-in special form
@@ -389,83 +909,59 @@ typed_ptr* eval_comparison(const s_expr* se, Environment* env) {
 //   evaluating the second argument.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the resulting symbol (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_define(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, 2, false);
-    if (args_tp->type == TYPE_ERROR) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_define(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 2, 2, false);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* first_arg = args_tp->ptr.se_ptr->car;
-        typed_ptr* second_arg = s_expr_next(args_tp->ptr.se_ptr)->car;
+        typed_ptr* first_arg = &args_tp.ptr.se_ptr->car;
+        typed_ptr* second_arg = &s_expr_next(args_tp.ptr.se_ptr)->car;
         if (first_arg->type == TYPE_SYMBOL) { // define variable
             Symbol_Node* sym_entry = symbol_lookup_index(env->global_env, \
                                                          first_arg);
             if (sym_entry == NULL) {
-                result = create_error_tp(EVAL_ERROR_BAD_SYMBOL);
+                result = error_tp(EVAL_ERROR_BAD_SYMBOL);
             } else {
-                typed_ptr* value = evaluate(second_arg, env);
-                if (value->type == TYPE_ERROR) {
+                typed_ptr value = evaluate_bound_value(second_arg, env);
+                if (value.type == TYPE_ERROR) {
                     result = value;
                 } else {
-                    blind_install_symbol(env, sym_entry->name, value);
-                    free(value);
-                    result = create_void_tp();
+                    blind_install_symbol(env, sym_entry->name, &value);
+                    result = void_tp();
                 }
             }
         } else if (first_arg->type == TYPE_S_EXPR) { // define function
             if (is_empty_list(first_arg->ptr.se_ptr)) {
-                result = create_error_tp(EVAL_ERROR_BAD_SYNTAX);
-            } else if (first_arg->ptr.se_ptr->car->type != TYPE_SYMBOL) {
-                result = create_error_tp(EVAL_ERROR_NOT_SYMBOL);
+                result = error_tp(EVAL_ERROR_BAD_SYNTAX);
+            } else if (first_arg->ptr.se_ptr->car.type != TYPE_SYMBOL) {
+                result = error_tp(EVAL_ERROR_NOT_SYMBOL);
             } else {
-                typed_ptr* fn_sym = first_arg->ptr.se_ptr->car;
+                typed_ptr* fn_sym = &first_arg->ptr.se_ptr->car;
                 Symbol_Node* sym_entry = symbol_lookup_index(env->global_env, \
                                                              fn_sym);
                 if (sym_entry == NULL) {
-                    result = create_error_tp(EVAL_ERROR_BAD_SYMBOL);
+                    result = error_tp(EVAL_ERROR_BAD_SYMBOL);
                 } else {
-                    // create a dummy (lambda param-list body) s-expression
-                    typed_ptr* param_list = first_arg->ptr.se_ptr->cdr;
-                    s_expr* empty = create_empty_s_expr();
-                    first_arg->ptr.se_ptr->cdr = create_s_expr_tp(empty);
-                    typed_ptr* fn_body = second_arg;
-                    s_expr_next(args_tp->ptr.se_ptr)->car = NULL;
-                    Symbol_Node* lam_stn = symbol_lookup_name(env->global_env, \
-                                                              "lambda");
-                    typed_ptr* lam = create_atom_tp(TYPE_SYMBOL, \
-                                                    lam_stn->symbol_idx);
-                    empty = create_empty_s_expr();
-                    s_expr* fn_body_se = create_s_expr(fn_body, \
-                                                       create_s_expr_tp(empty));
-                    typed_ptr* fn_body_tp = create_s_expr_tp(fn_body_se);
-                    s_expr* param_list_se = create_s_expr(param_list, \
-                                                          fn_body_tp);
-                    typed_ptr* param_list_tp = create_s_expr_tp(param_list_se);
-                    s_expr* dummy_lam = create_s_expr(lam, param_list_tp);
-                    typed_ptr* fn = eval_lambda(dummy_lam, env);
-                    if (fn->type == TYPE_ERROR) {
-                        delete_s_expr_recursive(dummy_lam, true);
+                    typed_ptr fn = make_closure(env, \
+                                                s_expr_next(se), \
+                                                &first_arg->ptr.se_ptr->cdr, \
+                                                sym_entry->name);
+                    if (fn.type == TYPE_ERROR) {
                         result = fn;
                     } else {
-                        delete_s_expr_recursive(param_list->ptr.se_ptr, true);
-                        delete_s_expr_recursive(dummy_lam, false);
-                        blind_install_symbol(env, sym_entry->name, fn);
-                        Function_Node* fn_fn = function_lookup_index(env, fn);
-                        free(fn_fn->name);
-                        fn_fn->name = strdup(sym_entry->name);
-                        free(fn);
-                        result = create_void_tp();
+                        blind_install_symbol(env, sym_entry->name, &fn);
+                        result = void_tp();
                     }
                 }
             }
         } else {
-            result = create_error_tp(EVAL_ERROR_BAD_SYNTAX);
+            result = error_tp(EVAL_ERROR_BAD_SYNTAX);
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     }
     return result;
 }
@@ -480,78 +976,69 @@ typed_ptr* eval_define(const s_expr* se, Environment* env) {
 //   evaluating the second argument.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the resulting symbol (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_set_variable(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, 2, false);
-    if (args_tp->type == TYPE_ERROR) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_set_variable(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 2, 2, false);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* first_arg = args_tp->ptr.se_ptr->car;
-        typed_ptr* second_arg = s_expr_next(args_tp->ptr.se_ptr)->car;
+        typed_ptr* first_arg = &args_tp.ptr.se_ptr->car;
+        typed_ptr* second_arg = &s_expr_next(args_tp.ptr.se_ptr)->car;
         if (first_arg->type != TYPE_SYMBOL) {
-            result = create_error_tp(EVAL_ERROR_NOT_SYMBOL);
+            result = error_tp(EVAL_ERROR_NOT_SYMBOL);
         } else {
-            Symbol_Node* found = symbol_lookup_index(env, first_arg);
-            while (found == NULL && env->enclosing_env != NULL) {
-                env = env->enclosing_env;
-                found = symbol_lookup_index(env, first_arg);
+            Environment* found_env = env;
+            Symbol_Node* found = symbol_lookup_index(found_env, first_arg);
+            while (found == NULL && found_env->enclosing_env != NULL) {
+                found_env = found_env->enclosing_env;
+                found = symbol_lookup_index(found_env, first_arg);
             }
             if (found == NULL) {
-                result = create_error_tp(EVAL_ERROR_BAD_SYMBOL);
-            } else if (found->type == TYPE_UNDEF) {
-                result = create_error_tp(EVAL_ERROR_UNDEF_SYM);
+                result = error_tp(EVAL_ERROR_BAD_SYMBOL);
+            } else if (binding_value(found).type == TYPE_UNDEF) {
+                result = error_tp(EVAL_ERROR_UNDEF_SYM);
             } else {
-                typed_ptr* value = evaluate(second_arg, env);
-                if (value->type == TYPE_ERROR) {
+                typed_ptr value = evaluate_bound_value(second_arg, env);
+                if (value.type == TYPE_ERROR) {
                     result = value;
                 } else {
-                    if (found->type == TYPE_S_EXPR) {
-                        delete_s_expr_recursive(found->value.se_ptr, true);
-                    } else if (found->type == TYPE_STRING) {
-                        delete_string(found->value.string);
-                    }
-                    found->type = value->type;
-                    found->value = value->ptr;
-                    free(value);
-                    result = create_void_tp();
+                    set_binding_value(found_env, found, value);
+                    result = void_tp();
                 }
             }
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     }
     return result;
 }
 
-typed_ptr* eval_exit(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 0, 0, false);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_exit(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 0, 0, false);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        result = create_error_tp(EVAL_ERROR_EXIT);
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        result = error_tp(EVAL_ERROR_EXIT);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     }
     return result;
 }
 
-typed_ptr* eval_cons(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, 2, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_cons(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 2, 2, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* first_arg = args_tp->ptr.se_ptr->car;
-        typed_ptr* second_arg = s_expr_next(args_tp->ptr.se_ptr)->car;
-        result = create_s_expr_tp(create_s_expr(first_arg, second_arg));
-        args_tp->ptr.se_ptr->car = NULL;
-        s_expr_next(args_tp->ptr.se_ptr)->car = NULL;
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        typed_ptr* first_arg = &args_tp.ptr.se_ptr->car;
+        typed_ptr* second_arg = &s_expr_next(args_tp.ptr.se_ptr)->car;
+        result = s_expr_tp(create_s_expr(*first_arg, *second_arg));
+        args_tp.ptr.se_ptr->car = none_tp();
+        s_expr_next(args_tp.ptr.se_ptr)->car = none_tp();
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -562,27 +1049,24 @@ typed_ptr* eval_cons(const s_expr* se, Environment* env) {
 // The first argument is expected to be TYPE_S_EXPR.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the resulting object (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_car_cdr(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_car_cdr(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* arg = args_tp->ptr.se_ptr->car;
+        typed_ptr* arg = &args_tp.ptr.se_ptr->car;
         if (arg->type != TYPE_S_EXPR || is_empty_list(arg->ptr.se_ptr)) {
-            result = create_error_tp(EVAL_ERROR_BAD_ARG_TYPE);
-        } else if (se->car->ptr.idx == BUILTIN_CAR) {
-            result = arg->ptr.se_ptr->car;
-            arg->ptr.se_ptr->car = NULL;
+            result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+        } else if (se->car.ptr.idx == BUILTIN_CAR) {
+            result = share_value(&arg->ptr.se_ptr->car);
         } else {
-            result = arg->ptr.se_ptr->cdr;
-            arg->ptr.se_ptr->cdr = NULL;
+            result = share_value(&arg->ptr.se_ptr->cdr);
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -594,60 +1078,63 @@ typed_ptr* eval_car_cdr(const s_expr* se, Environment* env) {
 //   the resulting s-expression (if it succeeded).
 // If no arguments are provided, the resulting typed_ptr points to the empty
 //   list.
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_list_construction(const s_expr* se, Environment* env) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_list_construction(const s_expr* se, Environment* env) {
     return collect_arguments(se, env, 0, -1, true);
 }
 
-typed_ptr* eval_and_or(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 0, -1, false);
-    if (args_tp->type == TYPE_ERROR) {
-        result = args_tp;
-    } else {
-        // the "starting" typed-pointer and the test in the while-loop are the
-        // only ways in which "and" and "or" differ
-        typed_ptr* start_tp = create_atom_tp(TYPE_BOOL, \
-                                             se->car->ptr.idx == BUILTIN_AND);
-        s_expr* arg_se = create_s_expr(start_tp, args_tp);
-        s_expr* curr_se = arg_se;
-        typed_ptr* evaluated_arg = copy_typed_ptr(start_tp);
-        while (!is_empty_list(curr_se)) {
-            if (evaluated_arg->type == TYPE_S_EXPR) {
-                delete_s_expr_recursive(evaluated_arg->ptr.se_ptr, true);
-            }
-            free(evaluated_arg);
-            evaluated_arg = evaluate(curr_se->car, env);
-            if (evaluated_arg->type == TYPE_ERROR || \
-                is_false_literal(evaluated_arg) == start_tp->ptr.idx) {
-                break;
-            }
-            curr_se = s_expr_next(curr_se);
+typed_ptr eval_and_or(const s_expr* se, Environment* env) {
+    const typed_ptr* tail = NULL;
+    typed_ptr result = eval_and_or_tail(se, env, &tail);
+    return (tail == NULL) ? result : evaluate(tail, env);
+}
+
+// Evaluates all but the last argument of an and/or, stopping early where the
+//   result is decided; the last argument, if it is reached, is returned
+//   unevaluated through tail for the caller to evaluate in tail position (see
+//   evaluate()), in which case the typed_ptr returned means nothing.
+static typed_ptr eval_and_or_tail(const s_expr* se, \
+                                  Environment* env, \
+                                  const typed_ptr** tail) {
+    typed_ptr args_tp = collect_arguments(se, env, 0, -1, false);
+    if (args_tp.type == TYPE_ERROR) {
+        return args_tp;
+    }
+    delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
+    // the starting value and the test in the loop are the only ways in which
+    //   "and" and "or" differ
+    bool is_and = (se->car.ptr.idx == BUILTIN_AND);
+    typed_ptr result = atom_tp(TYPE_BOOL, is_and);
+    s_expr* arg_se = s_expr_next(se);
+    while (!is_empty_list(arg_se)) {
+        if (is_empty_list(s_expr_next(arg_se))) {
+            *tail = &arg_se->car;
+            break;
+        }
+        result = evaluate(&arg_se->car, env);
+        if (result.type == TYPE_ERROR || is_false_literal(&result) == is_and) {
+            break;
         }
-        result = evaluated_arg;
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
-        free(arg_se->car);
-        free(arg_se);
+        discard_value(result);
+        arg_se = s_expr_next(arg_se);
     }
     return result;
 }
 
-typed_ptr* eval_not(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_not(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        if (is_false_literal(args_tp->ptr.se_ptr->car)) {
-            result = create_atom_tp(TYPE_BOOL, true);
+        if (is_false_literal(&args_tp.ptr.se_ptr->car)) {
+            result = atom_tp(TYPE_BOOL, true);
         } else {
-            result = create_atom_tp(TYPE_BOOL, false);
+            result = atom_tp(TYPE_BOOL, false);
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -668,93 +1155,97 @@ typed_ptr* eval_not(const s_expr* se, Environment* env) {
 //   the result of the last then-body evaluation.
 // If no arguments are provided, or if no argument's predicate evaluates to
 //   not-false, the resulting s-expression is a void value.
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_cond(const s_expr* se, Environment* env) {
-    typed_ptr* args_tp = collect_arguments(se, env, 0, -1, false);
-    if (args_tp->type == TYPE_ERROR) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_cond(const s_expr* se, Environment* env) {
+    const typed_ptr* tail = NULL;
+    typed_ptr result = eval_cond_tail(se, env, &tail);
+    return (tail == NULL) ? result : evaluate(tail, env);
+}
+
+// Does the work of eval_cond(), except that the last then-body of the chosen
+//   clause is returned unevaluated through tail for the caller to evaluate in
+//   tail position (see evaluate()), in which case the typed_ptr returned means
+//   nothing.
+static typed_ptr eval_cond_tail(const s_expr* se, \
+                                Environment* env, \
+                                const typed_ptr** tail) {
+    typed_ptr args_tp = collect_arguments(se, env, 0, -1, false);
+    if (args_tp.type == TYPE_ERROR) {
         return args_tp;
     }
-    s_expr* lookahead = args_tp->ptr.se_ptr;
+    s_expr* lookahead = args_tp.ptr.se_ptr;
     while (!is_empty_list(lookahead)) {
-        if (lookahead->car->type != TYPE_S_EXPR) {
-            delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-            free(args_tp);
-            return create_error_tp(EVAL_ERROR_BAD_SYNTAX);
+        if (lookahead->car.type != TYPE_S_EXPR) {
+            delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
+            return error_tp(EVAL_ERROR_BAD_SYNTAX);
         }
         lookahead = s_expr_next(lookahead);
     }
-    typed_ptr* eval_interm = create_void_tp();
+    typed_ptr eval_interm = void_tp();
     s_expr* arg_se = s_expr_next(se);
     if (is_empty_list(arg_se)) {
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
         return eval_interm;
     }
     bool pred_true = false;
     s_expr* then_bodies = NULL;
     while (!is_empty_list(arg_se)) {
-        s_expr* cond_clause = arg_se->car->ptr.se_ptr;
+        s_expr* cond_clause = arg_se->car.ptr.se_ptr;
         if (is_empty_list(cond_clause)) {
-            free(eval_interm);
-            eval_interm = create_error_tp(EVAL_ERROR_BAD_SYNTAX);
+            eval_interm = error_tp(EVAL_ERROR_BAD_SYNTAX);
             break;
         }
         Symbol_Node* else_stn = symbol_lookup_name(env->global_env, "else");
-        if (cond_clause->car->type == TYPE_SYMBOL && \
-            cond_clause->car->ptr.idx == else_stn->symbol_idx) {
+        if (cond_clause->car.type == TYPE_SYMBOL && \
+            cond_clause->car.ptr.idx == else_stn->symbol_idx) {
             s_expr* next_clause = s_expr_next(arg_se);
             if (!is_empty_list(next_clause)) {
-                free(eval_interm);
-                eval_interm = create_error_tp(EVAL_ERROR_NONTERMINAL_ELSE);
+                eval_interm = error_tp(EVAL_ERROR_NONTERMINAL_ELSE);
                 break;
             }
             then_bodies = s_expr_next(cond_clause);
             if (is_empty_list(then_bodies)) {
-                free(eval_interm);
-                eval_interm = create_error_tp(EVAL_ERROR_EMPTY_ELSE);
+                eval_interm = error_tp(EVAL_ERROR_EMPTY_ELSE);
                 break;
             }
             pred_true = true;
         }
-        free(eval_interm);
-        eval_interm = evaluate(cond_clause->car, env);
-        if (eval_interm->type == TYPE_ERROR) {
+        eval_interm = evaluate(&cond_clause->car, env);
+        if (eval_interm.type == TYPE_ERROR) {
             break;
-        } else if (!is_false_literal(eval_interm)) {
+        } else if (!is_false_literal(&eval_interm)) {
             pred_true = true;
             then_bodies = s_expr_next(cond_clause);
             break;
         }
         arg_se = s_expr_next(arg_se);
     }
-    typed_ptr* result = NULL;
+    typed_ptr result;
     if (!pred_true) { // no cond-clauses were true, or there was an error
-        if (eval_interm->type == TYPE_ERROR) {
+        if (eval_interm.type == TYPE_ERROR) {
             result = eval_interm;
         } else {
-            free(eval_interm);
-            result = create_void_tp();
+            result = void_tp();
         }
     } else {
         while (!is_empty_list(then_bodies)) {
-            if (eval_interm->type == TYPE_S_EXPR) {
-                delete_s_expr_recursive(eval_interm->ptr.se_ptr, true);
-            } else if (eval_interm->type == TYPE_STRING) {
-                delete_string(eval_interm->ptr.string);
+            discard_value(eval_interm);
+            if (is_empty_list(s_expr_next(then_bodies))) {
+                *tail = &then_bodies->car;
+                eval_interm = void_tp();
+                break;
             }
-            free(eval_interm);
-            eval_interm = evaluate(then_bodies->car, env);
-            if (eval_interm->type == TYPE_ERROR) {
+            eval_interm = evaluate(&then_bodies->car, env);
+            if (eval_interm.type == TYPE_ERROR) {
                 break;
             }
             then_bodies = s_expr_next(then_bodies);
         }
         result = eval_interm;
     }
-    delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-    free(args_tp);
+    delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     return result;
 }
 
@@ -764,31 +1255,30 @@ typed_ptr* eval_cond(const s_expr* se, Environment* env) {
 // There is no restriction on the type of the argument.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the (boolean) truth value of the predicate (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_list_pred(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_list_pred(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* arg = args_tp->ptr.se_ptr->car;
-        result = create_atom_tp(TYPE_BOOL, true);
+        typed_ptr* arg = &args_tp.ptr.se_ptr->car;
+        result = atom_tp(TYPE_BOOL, true);
         if (arg->type != TYPE_S_EXPR) {
-            result->ptr.idx = false;
+            result.ptr.idx = false;
         } else {
             s_expr* arg_se = arg->ptr.se_ptr;
             while (!is_empty_list(arg_se)) {
-                if (arg_se->cdr->type != TYPE_S_EXPR) {
-                    result->ptr.idx = false;
+                if (arg_se->cdr.type != TYPE_S_EXPR) {
+                    result.ptr.idx = false;
                     break;
                 }
                 arg_se = s_expr_next(arg_se);
             }
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -799,12 +1289,12 @@ typed_ptr* eval_list_pred(const s_expr* se, Environment* env) {
 // There is no restriction on the type of the argument.
 // Returns a typed_ptr containing an error code (if the evaluation failed) or
 //   the (boolean) truth value of the predicate (if it succeeded).
-// In either case, the returned typed_ptr is the caller's responsibility to
-//   free, and is safe to (shallow) free without harm to the symbol table, list
-//   area, or any other object.
-typed_ptr* eval_atom_pred(const s_expr* se, Environment* env) {
+// In either case, any s-expression or string the returned typed_ptr points to
+//   is the caller's responsibility to free, and is safe to free without harm to
+//   the symbol table, list area, or any other object.
+typed_ptr eval_atom_pred(const s_expr* se, Environment* env) {
     type target_type = TYPE_UNDEF;
-    switch (se->car->ptr.idx) {
+    switch (se->car.ptr.idx) {
         case BUILTIN_PAIRPRED:
             target_type = TYPE_S_EXPR;
             break;
@@ -827,43 +1317,41 @@ typed_ptr* eval_atom_pred(const s_expr* se, Environment* env) {
             target_type = TYPE_STRING;
             break;
         default:
-            return create_error_tp(EVAL_ERROR_UNDEF_BUILTIN);
+            return error_tp(EVAL_ERROR_UNDEF_BUILTIN);
     }
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* arg = args_tp->ptr.se_ptr->car;
+        typed_ptr* arg = &args_tp.ptr.se_ptr->car;
         // general case
-        result = create_atom_tp(TYPE_BOOL, arg->type == target_type);
+        result = atom_tp(TYPE_BOOL, arg->type == target_type);
         // special case: (procedure? +) -> #t AND (procedure? <user-fn>) -> #t
         if (target_type == TYPE_BUILTIN && arg->type == TYPE_FUNCTION) {
-            result->ptr.idx = true;
+            result.ptr.idx = true;
         }
         // special case: (pair? '()) -> #f
         if (arg->type == TYPE_S_EXPR && is_empty_list(arg->ptr.se_ptr)) {
-            result->ptr.idx = false;
+            result.ptr.idx = false;
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
 
-typed_ptr* eval_null_pred(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_null_pred(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* arg = args_tp->ptr.se_ptr->car;
-        result = create_atom_tp(TYPE_BOOL, false);
+        typed_ptr* arg = &args_tp.ptr.se_ptr->car;
+        result = atom_tp(TYPE_BOOL, false);
         if (arg->type == TYPE_S_EXPR && is_empty_list(arg->ptr.se_ptr)) {
-            result->ptr.idx = true;
+            result.ptr.idx = true;
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -878,129 +1366,113 @@ typed_ptr* eval_null_pred(const s_expr* se, Environment* env) {
 //   body of the lambda.
 // The function installed in the environment, and its associated data, is now
 //   the environment's responsibility.
-// The typed pointer returned is the caller's responsibility to free, and can
-//   safely be (shallow) freed.
-typed_ptr* eval_lambda(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, 2, false);
-    if (args_tp->type == TYPE_ERROR) {
+// The typed pointer returned refers to the installed function, and owns no
+//   storage of its own.
+typed_ptr eval_lambda(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 2, 2, false);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* first_arg = args_tp->ptr.se_ptr->car;
-        typed_ptr* second_arg = s_expr_next(args_tp->ptr.se_ptr)->car;
-        if (first_arg->type != TYPE_S_EXPR) {
-            result = create_error_tp(EVAL_ERROR_BAD_SYNTAX);
-        } else {
-            Symbol_Node* params = collect_parameters(first_arg, env);
-            if (params != NULL && params->type == TYPE_ERROR) {
-                result = create_error_tp(params->value.idx);
-                delete_symbol_node_list(params);
-            } else {
-                typed_ptr* body = copy_typed_ptr(second_arg);
-                if (body->type == TYPE_S_EXPR) {
-                    body->ptr.se_ptr = copy_s_expr(body->ptr.se_ptr);
-                } else if (body->type == TYPE_STRING) {
-                    char* contents = body->ptr.string->contents;
-                    body->ptr.string = create_string(contents);
-                }
-                result = install_function(env, "", params, env, body);
-            }
-        }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        typed_ptr* first_arg = &args_tp.ptr.se_ptr->car;
+        result = make_closure(env, s_expr_next(se), first_arg, "");
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     }
     return result;
 }
 
-typed_ptr* eval_quote(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, false);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_quote(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, false);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        result = copy_typed_ptr(args_tp->ptr.se_ptr->car);
-        if (result->type == TYPE_S_EXPR) {
-            result->ptr.se_ptr = copy_s_expr(result->ptr.se_ptr);
-        } else if (result->type == TYPE_STRING) {
-            char* contents = result->ptr.string->contents;
-            result->ptr.string = create_string(contents);
-        }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, false);
-        free(args_tp);
+        result = share_value(&args_tp.ptr.se_ptr->car);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
     }
     return result;
 }
 
-typed_ptr* eval_string_length(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 1, 1, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_string_length(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 1, 1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        typed_ptr* arg = args_tp->ptr.se_ptr->car;
+        typed_ptr* arg = &args_tp.ptr.se_ptr->car;
         if (arg->type != TYPE_STRING) {
-            result = create_error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+            result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
         } else {
-            result = create_atom_tp(TYPE_FIXNUM, arg->ptr.string->len);
+            result = atom_tp(TYPE_FIXNUM, arg->ptr.string->len);
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
 
-typed_ptr* eval_string_equals(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 2, -1, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_string_equals(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 2, -1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
-        s_expr* arg_se = args_tp->ptr.se_ptr;
-        typed_ptr* first_arg = arg_se->car;
+        s_expr* arg_se = args_tp.ptr.se_ptr;
+        typed_ptr* first_arg = &arg_se->car;
         arg_se = s_expr_next(arg_se);
         if (first_arg->type != TYPE_STRING) {
-            result = create_error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+            result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
         } else {
-            result = create_atom_tp(TYPE_BOOL, true);
-            while (result->ptr.idx == true && !is_empty_list(arg_se)) {
-                typed_ptr* next_arg = arg_se->car;
+            result = atom_tp(TYPE_BOOL, true);
+            while (result.ptr.idx == true && !is_empty_list(arg_se)) {
+                typed_ptr* next_arg = &arg_se->car;
                 if (next_arg->type != TYPE_STRING) {
-                    free(result);
-                    result = create_error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+                    result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
                     break;
                 }
                 if (first_arg->ptr.string->len != next_arg->ptr.string->len || \
-                    strcmp(first_arg->ptr.string->contents, \
-                            next_arg->ptr.string->contents)) {
-                    result->ptr.idx = false;
+                    strcmp(string_contents(first_arg->ptr.string), \
+                           string_contents(next_arg->ptr.string))) {
+                    result.ptr.idx = false;
                 }
                 arg_se = s_expr_next(arg_se);
             }
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
 
-typed_ptr* eval_string_append(const s_expr* se, Environment* env) {
-    typed_ptr* result = NULL;
-    typed_ptr* args_tp = collect_arguments(se, env, 0, -1, true);
-    if (args_tp->type == TYPE_ERROR) {
+typed_ptr eval_string_append(const s_expr* se, Environment* env) {
+    typed_ptr result;
+    typed_ptr args_tp = collect_arguments(se, env, 0, -1, true);
+    if (args_tp.type == TYPE_ERROR) {
         result = args_tp;
     } else {
         bool all_strings = true;
         long total_length = 0;
-        s_expr* arg_se = args_tp->ptr.se_ptr;
+        s_expr* arg_se = args_tp.ptr.se_ptr;
         for ( ; !is_empty_list(arg_se); arg_se = s_expr_next(arg_se)) {
-            if (arg_se->car->type != TYPE_STRING) {
+            if (arg_se->car.type != TYPE_STRING) {
                 all_strings = false;
                 break;
             }
-            total_length += arg_se->car->ptr.string->len;
+            total_length += arg_se->car.ptr.string->len;
         }
-        if (all_strings) {
-            result = create_string_tp(create_string(""));
+        if (all_strings && total_length >= STRING_ROPE_THRESHOLD) {
+            // appending to a long string over and over again stays linear
+            String* str = NULL;
+            arg_se = args_tp.ptr.se_ptr;
+            for ( ; !is_empty_list(arg_se); arg_se = s_expr_next(arg_se)) {
+                String* next_str = arg_se->car.ptr.string;
+                if (next_str->len == 0) {
+                    continue;
+                }
+                share_string(next_str);
+                str = (str == NULL) ? next_str : create_rope(str, next_str);
+            }
+            result = string_tp(str);
+        } else if (all_strings) {
+            result = string_tp(create_string(""));
             if (total_length > 0) {
                 char* new_str = malloc(sizeof(char) * (total_length + 1));
                 if (new_str == NULL) {
@@ -1008,23 +1480,22 @@ typed_ptr* eval_string_append(const s_expr* se, Environment* env) {
                     exit(-1);
                 }
                 char* start = new_str;
-                arg_se = args_tp->ptr.se_ptr;
+                arg_se = args_tp.ptr.se_ptr;
                 for ( ; !is_empty_list(arg_se); arg_se = s_expr_next(arg_se)) {
                     memcpy(start, \
-                           arg_se->car->ptr.string->contents, \
-                           arg_se->car->ptr.string->len);
-                    start += arg_se->car->ptr.string->len;
+                           string_contents(arg_se->car.ptr.string), \
+                           arg_se->car.ptr.string->len);
+                    start += arg_se->car.ptr.string->len;
                 }
                 new_str[total_length] = '\0';
-                free(result->ptr.string->contents);
-                result->ptr.string->contents = new_str;
-                result->ptr.string->len = total_length;
+                free(result.ptr.string->contents);
+                result.ptr.string->contents = new_str;
+                result.ptr.string->len = total_length;
             }
         } else {
-            result = create_error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+            result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
         }
-        delete_s_expr_recursive(args_tp->ptr.se_ptr, true);
-        free(args_tp);
+        delete_s_expr_recursive(args_tp.ptr.se_ptr, true);
     }
     return result;
 }
@@ -1049,39 +1520,39 @@ Symbol_Node* collect_parameters(typed_ptr* tp, Environment* env) {
     while (global_env->enclosing_env != NULL) {
         global_env = global_env->enclosing_env;
     }
-    if (se->car == NULL || se->car->type != TYPE_SYMBOL) {
+    if (se->car.type == TYPE_NONE || se->car.type != TYPE_SYMBOL) {
         params = create_error_symbol_node(EVAL_ERROR_NOT_SYMBOL);
-    } else if (se->cdr == NULL || se->cdr->type != TYPE_S_EXPR) {
+    } else if (se->cdr.type == TYPE_NONE || se->cdr.type != TYPE_S_EXPR) {
         params = create_error_symbol_node(EVAL_ERROR_BAD_ARG_TYPE);
     } else {
-        Symbol_Node* found = symbol_lookup_index(global_env, se->car);
+        Symbol_Node* found = symbol_lookup_index(global_env, &se->car);
         if (found == NULL) {
             params = create_error_symbol_node(EVAL_ERROR_BAD_SYMBOL);
         } else {
-            params = create_symbol_node(0, \
+            params = create_symbol_node(found->symbol_idx, \
                                         found->name, \
                                         TYPE_UNDEF, \
                                         (tp_value){.idx=0});
             Symbol_Node* curr = params;
             se = s_expr_next(se);
             while (!is_empty_list(se)) {
-                if (se->cdr == NULL || se->cdr->type != TYPE_S_EXPR) {
+                if (se->cdr.type == TYPE_NONE || se->cdr.type != TYPE_S_EXPR) {
                     delete_symbol_node_list(params);
                     params = create_error_symbol_node(EVAL_ERROR_BAD_ARG_TYPE);
                     break;
                 }
-                if (se->car == NULL || se->car->type != TYPE_SYMBOL) {
+                if (se->car.type == TYPE_NONE || se->car.type != TYPE_SYMBOL) {
                     delete_symbol_node_list(params);
                     params = create_error_symbol_node(EVAL_ERROR_NOT_SYMBOL);
                     break;
                 }
-                found = symbol_lookup_index(global_env, se->car);
+                found = symbol_lookup_index(global_env, &se->car);
                 if (found == NULL) {
                     delete_symbol_node_list(params);
                     params = create_error_symbol_node(EVAL_ERROR_BAD_SYMBOL);
                     break;
                 }
-                curr->next = create_symbol_node(0, \
+                curr->next = create_symbol_node(found->symbol_idx, \
                                                 found->name, \
                                                 TYPE_UNDEF, \
                                                 (tp_value){.idx=0});
@@ -1093,135 +1564,1563 @@ Symbol_Node* collect_parameters(typed_ptr* tp, Environment* env) {
     return params;
 }
 
-// If the Function_Node's arg list is of different length than the s-expression
-//   pointed to by the args typed pointer, an error is returned in the first
-//   Symbol_Node.
-// Otherwise, the parameters in the arg list are bound to the values stored in
-//   the members of the args s-expression. Any s-expressions pointed to by the
-//   typed-pointers in the arg list are now the responsibility of the
-//   Symbol_Nodes returned.
-// If no errors are encountered, the Symbol_Node list contains the bound
-//   arguments.
-// In all cases, the Symbol_Node list returned is the caller's responsibility
-//   to free, and may be safely (shallow) freed.
-Symbol_Node* bind_args(Function_Node* fn, typed_ptr* args) {
-    if (fn->param_list == NULL && is_empty_list(args->ptr.se_ptr)) {
-        return NULL;
-    } else if (is_empty_list(args->ptr.se_ptr)) {
-        return create_error_symbol_node(EVAL_ERROR_FEW_ARGS);
-    } else if (fn->param_list == NULL) {
-        return create_error_symbol_node(EVAL_ERROR_MANY_ARGS);
-    } else {
-        Symbol_Node* curr_param = fn->param_list;
-        s_expr* arg_se = args->ptr.se_ptr;
-        Symbol_Node* bound_args = NULL;
-        bound_args = create_symbol_node(0, \
-                                        curr_param->name, \
-                                        arg_se->car->type, \
-                                        arg_se->car->ptr);
-        if (bound_args->type == TYPE_S_EXPR) {
-            bound_args->value.se_ptr = copy_s_expr(bound_args->value.se_ptr);
-        } else if (bound_args->type == TYPE_STRING) {
-            char* contents = bound_args->value.string->contents;
-            bound_args->value.string = create_string(contents);
-        }
-        curr_param = curr_param->next;
-        arg_se = s_expr_next(arg_se);
-        while (!is_empty_list(arg_se)) {
-            if (curr_param == NULL) {
-                delete_symbol_node_list(bound_args);
-                bound_args = create_error_symbol_node(EVAL_ERROR_MANY_ARGS);
-                break;
-            }
-            Symbol_Node* new_arg = create_symbol_node(0, \
-                                                      curr_param->name,\
-                                                      arg_se->car->type, \
-                                                      arg_se->car->ptr);
-            if (new_arg->type == TYPE_S_EXPR) {
-                new_arg->value.se_ptr = copy_s_expr(new_arg->value.se_ptr);
-            } else if (new_arg->type == TYPE_STRING) {
-                char* contents = new_arg->value.string->contents;
-                new_arg->value.string = create_string(contents);
-            }
-            new_arg->next = bound_args;
-            bound_args = new_arg;
-            curr_param = curr_param->next;
-            arg_se = s_expr_next(arg_se);
+// Binds the frame's parameters, in order, to the members of the s-expression
+//   pointed to by the args typed pointer. Any s-expressions or strings they
+//   point to are shared (not copied) with the frame, which owns a reference to
+//   each.
+// If the frame's parameter list is of different length than the arguments, an
+//   error is returned; the frame may have been partly filled in, and should be
+//   deleted. Otherwise, a void typed_ptr is returned.
+typed_ptr bind_args(Environment* frame, typed_ptr* args) {
+    s_expr* arg_se = args->ptr.se_ptr;
+    for (unsigned int slot = 0; slot < frame->slot_count; slot++) {
+        if (is_empty_list(arg_se)) {
+            return error_tp(EVAL_ERROR_FEW_ARGS);
         }
-        if (curr_param != NULL) {
-            delete_symbol_node_list(bound_args);
-            bound_args = create_error_symbol_node(EVAL_ERROR_FEW_ARGS);
-        }
-        return bound_args;
+        typed_ptr arg_value = share_value(&arg_se->car);
+        frame->slots[slot].type = arg_value.type;
+        frame->slots[slot].value = arg_value.ptr;
+        arg_se = s_expr_next(arg_se);
     }
-}
-
-// Reads a list of bound arguments into an environment, returning the result.
-// The input environment is not modified.
-// Any s-expressions pointed to in the bound arguments now belong to the
-//   returned closure environment.
-// The returned environment is the caller's responsibility to delete.
-Environment* make_eval_env(Environment* env, Symbol_Node* bound_args) {
-    Environment* eval_env = create_environment(0, 0, env);
-    Symbol_Node* curr_arg = bound_args;
-    while (curr_arg != NULL) {
-        typed_ptr curr_value = {.type=curr_arg->type, .ptr=curr_arg->value};
-        blind_install_symbol(eval_env, curr_arg->name, &curr_value);
-        curr_arg = curr_arg->next;
+    if (!is_empty_list(arg_se)) {
+        return error_tp(EVAL_ERROR_MANY_ARGS);
     }
-    return eval_env;
+    return void_tp();
 }
 
-typed_ptr* collect_arguments(const s_expr* se, \
-                             Environment* env, \
-                             int min_args, \
-                             int max_args, \
-                             bool evaluate_all_args) {
+typed_ptr collect_arguments(const s_expr* se, \
+                            Environment* env, \
+                            int min_args, \
+                            int max_args, \
+                            bool evaluate_all_args) {
     int seen = 0;
     if (is_pair(se)) {
-        return create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
+        return error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     }
     s_expr* curr = s_expr_next(se);
     s_expr* arg_head = create_empty_s_expr();
     s_expr* arg_tail = arg_head;
-    typed_ptr* err = NULL;
+    typed_ptr err = void_tp();
     while (!is_empty_list(curr)) {
         if (is_pair(curr)) {
-            err = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
+            err = error_tp(EVAL_ERROR_ILLEGAL_PAIR);
             break;
         }
         seen++;
         if (max_args >= 0 && seen > max_args) {
-            err = create_error_tp(EVAL_ERROR_MANY_ARGS);
+            err = error_tp(EVAL_ERROR_MANY_ARGS);
             break;
         }
-        arg_tail->car = copy_typed_ptr(curr->car);
-        arg_tail->cdr = create_s_expr_tp(create_empty_s_expr());
+        arg_tail->car = curr->car;
+        arg_tail->cdr = s_expr_tp(create_empty_s_expr());
         if (evaluate_all_args && \
-            arg_tail->car->type != TYPE_BUILTIN && \
-            arg_tail->car->type != TYPE_FUNCTION) {
-            typed_ptr* temp = arg_tail->car;
-            arg_tail->car = evaluate(arg_tail->car, env);
-            free(temp);
+            arg_tail->car.type != TYPE_BUILTIN && \
+            arg_tail->car.type != TYPE_FUNCTION) {
+            arg_tail->car = evaluate(&curr->car, env);
         }
-        if (!evaluate_all_args && arg_tail->car->type == TYPE_STRING) {
-            char* contents = arg_tail->car->ptr.string->contents;
-            arg_tail->car->ptr.string = create_string(contents);
+        if (!evaluate_all_args && arg_tail->car.type == TYPE_STRING) {
+            share_string(arg_tail->car.ptr.string);
         }
-        if (arg_tail->car->type == TYPE_ERROR) {
-            err = copy_typed_ptr(arg_tail->car);
+        if (arg_tail->car.type == TYPE_ERROR) {
+            err = arg_tail->car;
             break;
         }
         arg_tail = s_expr_next(arg_tail);
         curr = s_expr_next(curr);
     }
-    if (err == NULL && seen < min_args) {
-        err = create_error_tp(EVAL_ERROR_FEW_ARGS);
+    if (err.type != TYPE_ERROR && seen < min_args) {
+        err = error_tp(EVAL_ERROR_FEW_ARGS);
     }
-    if (err != NULL) {
+    if (err.type == TYPE_ERROR) {
         delete_s_expr_recursive(arg_head, evaluate_all_args);
         return err;
     } else {
-        return create_s_expr_tp(arg_head);
+        return s_expr_tp(arg_head);
+    }
+}
+
+// compiled function bodies
+
+// A function body is run by the virtual machine from its bytecode (see
+//   Function_Code), which compile() produces from the body the first time the
+//   function is called, by way of the tree analyze() builds from it (see
+//   Tree_Node). Every form in the tree was checked for shape when its node was
+//   built, so none of that is done again when the bytecode runs.
+// Calls of the built-ins that bodies lean on most (cond, and, or, the
+//   arithmetic and numeric comparison functions, and cons, car, cdr and null?)
+//   are compiled inline. Their operator is still looked up every time the code
+//   runs (OP_GUARD); if it no longer names the same built-in (because it was
+//   redefined, say), the form is evaluated from its source instead. Any other
+//   built-in is passed its form just as evaluate() would pass it, and a form
+//   whose shape is not one analyze() checks (a malformed one, for instance) is
+//   evaluated from its source, so that errors come out as they would there.
+
+static Tree_Node* create_tree_node(tree_kind kind, \
+                                   const typed_ptr* source, \
+                                   unsigned int child_count) {
+    Tree_Node* node = malloc(sizeof(Tree_Node));
+    if (node == NULL) {
+        fprintf(stderr, "malloc failed in create_tree_node()\n");
+        exit(-1);
+    }
+    node->kind = kind;
+    node->source = source;
+    node->op = BUILTIN_ADD;
+    node->children = NULL;
+    node->child_count = child_count;
+    if (child_count > 0) {
+        node->children = calloc(child_count, sizeof(Tree_Node*));
+        if (node->children == NULL) {
+            fprintf(stderr, "calloc failed in create_tree_node()\n");
+            exit(-1);
+        }
+    }
+    return node;
+}
+
+// Frees a tree; the expression it was built from is left alone.
+void delete_tree_node(Tree_Node* node) {
+    if (node == NULL) {
+        return;
+    }
+    for (unsigned int i = 0; i < node->child_count; i++) {
+        delete_tree_node(node->children[i]);
+    }
+    free(node->children);
+    free(node);
+    return;
+}
+
+// Returns the number of members of a proper list, or -1 if se is not one.
+static int list_length(const s_expr* se) {
+    int length = 0;
+    while (se != NULL && !is_empty_list(se)) {
+        if (se->car.type == TYPE_NONE || se->cdr.type != TYPE_S_EXPR) {
+            return -1;
+        }
+        length++;
+        se = s_expr_next(se);
+    }
+    return (se == NULL) ? -1 : length;
+}
+
+// Makes a node with a child for each member of the list tp points to, which
+//   has the given length.
+static Tree_Node* analyze_members(tree_kind kind, \
+                                  const typed_ptr* tp, \
+                                  int length, \
+                                  Environment* env) {
+    Tree_Node* node = create_tree_node(kind, tp, length);
+    const s_expr* se = tp->ptr.se_ptr;
+    for (int i = 0; i < length; i++) {
+        node->children[i] = analyze(&se->car, env);
+        se = s_expr_next(se);
+    }
+    return node;
+}
+
+// Makes the node for a cond form with the given number of clauses, or returns
+//   NULL if any of them is malformed. Each child after the operator is a
+//   clause, whose first child is the predicate (NULL for else), and the rest
+//   the then-bodies.
+static Tree_Node* analyze_cond(const typed_ptr* tp, \
+                               int clause_count, \
+                               Environment* env) {
+    Symbol_Node* else_stn = symbol_lookup_name(env->global_env, "else");
+    const s_expr* clause_se = s_expr_next(tp->ptr.se_ptr);
+    for (int i = 0; i < clause_count; i++) {
+        const typed_ptr* clause_tp = &clause_se->car;
+        if (clause_tp->type != TYPE_S_EXPR) {
+            return NULL;
+        }
+        int length = list_length(clause_tp->ptr.se_ptr);
+        if (length < 1) {
+            return NULL;
+        }
+        const typed_ptr* pred = &clause_tp->ptr.se_ptr->car;
+        if (else_stn != NULL && \
+            pred->type == TYPE_SYMBOL && \
+            pred->ptr.idx == else_stn->symbol_idx && \
+            (i + 1 < clause_count || length < 2)) {
+            return NULL;
+        }
+        clause_se = s_expr_next(clause_se);
+    }
+    Tree_Node* node = create_tree_node(TREE_COND, tp, clause_count + 1);
+    node->children[0] = analyze(&tp->ptr.se_ptr->car, env);
+    clause_se = s_expr_next(tp->ptr.se_ptr);
+    for (int i = 0; i < clause_count; i++) {
+        const typed_ptr* clause_tp = &clause_se->car;
+        int length = list_length(clause_tp->ptr.se_ptr);
+        Tree_Node* clause = analyze_members(TREE_CLAUSE, \
+                                            clause_tp, \
+                                            length, \
+                                            env);
+        const typed_ptr* pred = &clause_tp->ptr.se_ptr->car;
+        if (else_stn != NULL && \
+            pred->type == TYPE_SYMBOL && \
+            pred->ptr.idx == else_stn->symbol_idx) {
+            delete_tree_node(clause->children[0]);
+            clause->children[0] = NULL;
+        }
+        node->children[i + 1] = clause;
+        clause_se = s_expr_next(clause_se);
+    }
+    return node;
+}
+
+// Reports whether a form's operator is a reference to a global variable that is
+//   (for now) bound to a built-in, which is returned through op.
+static bool names_builtin(const typed_ptr* operator, \
+                          Environment* env, \
+                          builtin_code* op) {
+    if (operator->type != TYPE_SYMBOL || \
+        (operator->address != ADDRESS_UNRESOLVED && \
+         operator->address != ADDRESS_GLOBAL && \
+         !IS_GLOBAL_SITE(operator->address))) {
+        return false;
+    }
+    Symbol_Node* global = symbol_lookup_index(env->global_env, operator);
+    if (global == NULL || global->type != TYPE_BUILTIN) {
+        return false;
+    }
+    *op = global->value.idx;
+    return true;
+}
+
+static Tree_Node* analyze_form(const typed_ptr* tp, Environment* env) {
+    const s_expr* se = tp->ptr.se_ptr;
+    int length = list_length(se);
+    if (length < 1) {
+        return create_tree_node(TREE_SOURCE, tp, 0);
+    }
+    builtin_code op;
+    if (!names_builtin(&se->car, env, &op)) {
+        return analyze_members(TREE_CALL, tp, length, env);
+    }
+    Tree_Node* node = NULL;
+    switch (op) {
+        case BUILTIN_COND:
+            node = analyze_cond(tp, length - 1, env);
+            break;
+        case BUILTIN_AND: // fall-through
+        case BUILTIN_OR:
+            node = analyze_members(TREE_AND_OR, tp, length, env);
+            break;
+        case BUILTIN_ADD: // fall-through
+        case BUILTIN_MUL: // fall-through
+        case BUILTIN_SUB: // fall-through
+        case BUILTIN_DIV:
+            node = analyze_members(TREE_ARITHMETIC, tp, length, env);
+            break;
+        case BUILTIN_NUMBEREQ: // fall-through
+        case BUILTIN_NUMBERGT: // fall-through
+        case BUILTIN_NUMBERLT: // fall-through
+        case BUILTIN_NUMBERGE: // fall-through
+        case BUILTIN_NUMBERLE:
+            node = analyze_members(TREE_COMPARISON, tp, length, env);
+            break;
+        case BUILTIN_CONS:
+            if (length == 3) {
+                node = analyze_members(TREE_PRIMITIVE, tp, length, env);
+            }
+            break;
+        case BUILTIN_CAR: // fall-through
+        case BUILTIN_CDR: // fall-through
+        case BUILTIN_NULLPRED:
+            if (length == 2) {
+                node = analyze_members(TREE_PRIMITIVE, tp, length, env);
+            }
+            break;
+        default:
+            break;
+    }
+    if (node == NULL) {
+        // the arguments are the built-in's to evaluate (or not), from source
+        node = create_tree_node(TREE_BUILTIN, tp, 1);
+        node->children[0] = analyze(&se->car, env);
+    }
+    node->op = op;
+    return node;
+}
+
+// Builds the tree for the expression tp points to, in an environment whose
+//   global environment is env's. The tree refers to the expression, which must
+//   outlive it; it is freed with delete_tree_node().
+Tree_Node* analyze(const typed_ptr* tp, Environment* env) {
+    switch (tp->type) {
+        case TYPE_ERROR: // fall-through
+        case TYPE_VOID: // fall-through
+        case TYPE_FIXNUM: // fall-through
+        case TYPE_BOOL: // fall-through
+        case TYPE_BUILTIN: // fall-through
+        case TYPE_FUNCTION: // fall-through
+        case TYPE_STRING:
+            return create_tree_node(TREE_CONSTANT, tp, 0);
+        case TYPE_SYMBOL:
+            return create_tree_node(TREE_VARIABLE, tp, 0);
+        case TYPE_S_EXPR:
+            if (tp->ptr.se_ptr != NULL) {
+                return analyze_form(tp, env);
+            }
+            return create_tree_node(TREE_SOURCE, tp, 0);
+        default:
+            return create_tree_node(TREE_SOURCE, tp, 0);
+    }
+}
+
+// The bytecode being emitted, with room to grow.
+typedef struct EMITTER {
+    Bytecode* bytecode;
+    unsigned int code_capacity;
+    unsigned int constants_capacity;
+} Emitter;
+
+static void emit(Emitter* e, unsigned int word) {
+    Bytecode* bc = e->bytecode;
+    if (bc->length == e->code_capacity) {
+        e->code_capacity = (e->code_capacity == 0) ? 16 : 2 * e->code_capacity;
+        bc->code = realloc(bc->code, e->code_capacity * sizeof(unsigned int));
+        if (bc->code == NULL) {
+            fprintf(stderr, "realloc failed in emit()\n");
+            exit(-1);
+        }
+    }
+    bc->code[bc->length++] = word;
+    return;
+}
+
+// Emits an expression's index in the pool, adding it to the pool first.
+static void emit_constant(Emitter* e, const typed_ptr* tp) {
+    Bytecode* bc = e->bytecode;
+    if (bc->constant_count == e->constants_capacity) {
+        e->constants_capacity = (e->constants_capacity == 0) ? \
+                                8 : \
+                                2 * e->constants_capacity;
+        bc->constants = realloc(bc->constants, \
+                                e->constants_capacity * sizeof(typed_ptr*));
+        if (bc->constants == NULL) {
+            fprintf(stderr, "realloc failed in emit_constant()\n");
+            exit(-1);
+        }
+    }
+    bc->constants[bc->constant_count] = tp;
+    emit(e, bc->constant_count++);
+    return;
+}
+
+// Emits a jump target to be filled in later by patch_jumps(). The targets that
+//   are waiting for the same address are chained through their own words: each
+//   holds the position (plus one) of the one emitted before it, and chain that
+//   of the last one emitted.
+static void emit_jump(Emitter* e, unsigned int* chain) {
+    unsigned int position = e->bytecode->length;
+    emit(e, *chain);
+    *chain = position + 1;
+    return;
+}
+
+// Points every jump target in a chain at the next word to be emitted.
+static void patch_jumps(Emitter* e, unsigned int chain) {
+    while (chain != 0) {
+        unsigned int position = chain - 1;
+        chain = e->bytecode->code[position];
+        e->bytecode->code[position] = e->bytecode->length;
+    }
+    return;
+}
+
+static void compile_node(Emitter* e, const Tree_Node* node, bool tail);
+
+// Compiles the children of a node from the given one on, keeping the value of
+//   the last only.
+static void compile_sequence(Emitter* e, \
+                             const Tree_Node* node, \
+                             unsigned int first, \
+                             bool tail) {
+    for (unsigned int i = first; i < node->child_count; i++) {
+        bool last = (i + 1 == node->child_count);
+        compile_node(e, node->children[i], tail && last);
+        if (!last) {
+            emit(e, OP_POP);
+        }
+    }
+    return;
+}
+
+static void compile_cond(Emitter* e, \
+                         const Tree_Node* node, \
+                         bool tail, \
+                         unsigned int* done) {
+    bool has_else = false;
+    for (unsigned int i = 1; i < node->child_count; i++) {
+        const Tree_Node* clause = node->children[i];
+        if (clause->children[0] == NULL) {
+            compile_sequence(e, clause, 1, tail);
+            has_else = true;
+            break;
+        }
+        compile_node(e, clause->children[0], false);
+        if (clause->child_count == 1) {
+            // a true predicate is the value of the cond
+            emit(e, OP_OR);
+            emit_jump(e, done);
+            continue;
+        }
+        unsigned int next_clause = 0;
+        emit(e, OP_BRANCH_FALSE);
+        emit_jump(e, &next_clause);
+        compile_sequence(e, clause, 1, tail);
+        emit(e, OP_JUMP);
+        emit_jump(e, done);
+        patch_jumps(e, next_clause);
+    }
+    if (!has_else) {
+        emit(e, OP_VOID);
+    }
+    return;
+}
+
+// Compiles a call of a built-in that is done inline, once its operator has
+//   been found to be that built-in. The value is left on the stack, or jumped
+//   with to one of the targets in the done chain.
+static void compile_inline(Emitter* e, \
+                           const Tree_Node* node, \
+                           bool tail, \
+                           unsigned int* done) {
+    unsigned int arg_count = node->child_count - 1;
+    if (node->kind == TREE_COND) {
+        compile_cond(e, node, tail, done);
+        return;
+    } else if (node->kind == TREE_AND_OR) {
+        if (arg_count == 0) {
+            emit(e, OP_BOOL);
+            emit(e, node->op == BUILTIN_AND);
+            return;
+        }
+        for (unsigned int i = 1; i < arg_count; i++) {
+            compile_node(e, node->children[i], false);
+            emit(e, (node->op == BUILTIN_AND) ? OP_AND : OP_OR);
+            emit_jump(e, done);
+        }
+        compile_node(e, node->children[arg_count], tail);
+        return;
+    }
+    for (unsigned int i = 1; i <= arg_count; i++) {
+        compile_node(e, node->children[i], false);
+    }
+    switch (node->kind) {
+        case TREE_ARITHMETIC:
+            emit(e, OP_ARITHMETIC);
+            emit(e, node->op);
+            emit(e, arg_count);
+            break;
+        case TREE_COMPARISON:
+            emit(e, OP_COMPARE);
+            emit(e, node->op);
+            emit(e, arg_count);
+            break;
+        default:
+            emit(e, OP_PRIMITIVE);
+            emit(e, node->op);
+            break;
+    }
+    return;
+}
+
+// Compiles an expression; a call in tail position (tail) becomes a tail call.
+static void compile_node(Emitter* e, const Tree_Node* node, bool tail) {
+    unsigned int done = 0;
+    unsigned int fallback = 0;
+    switch (node->kind) {
+        case TREE_CONSTANT:
+            emit(e, OP_CONSTANT);
+            emit_constant(e, node->source);
+            break;
+        case TREE_VARIABLE:
+            if (node->source->address != ADDRESS_UNRESOLVED && \
+                node->source->address != ADDRESS_GLOBAL && \
+                !IS_GLOBAL_SITE(node->source->address)) {
+                emit(e, OP_LOCAL);
+            } else {
+                emit(e, OP_LOAD);
+            }
+            emit_constant(e, node->source);
+            break;
+        case TREE_CALL:
+            compile_node(e, node->children[0], false);
+            emit(e, OP_PREPARE);
+            emit_constant(e, node->source);
+            emit_jump(e, &done);
+            for (unsigned int i = 1; i < node->child_count; i++) {
+                compile_node(e, node->children[i], false);
+            }
+            emit(e, tail ? OP_TAIL_CALL : OP_CALL);
+            emit(e, node->child_count - 1);
+            patch_jumps(e, done);
+            break;
+        case TREE_BUILTIN:
+            emit(e, OP_BUILTIN);
+            emit_constant(e, node->source);
+            emit(e, node->op);
+            break;
+        case TREE_COND: // fall-through
+        case TREE_AND_OR: // fall-through
+        case TREE_ARITHMETIC: // fall-through
+        case TREE_COMPARISON: // fall-through
+        case TREE_PRIMITIVE:
+            emit(e, OP_GUARD);
+            emit_constant(e, node->children[0]->source);
+            emit(e, node->op);
+            emit_jump(e, &fallback);
+            compile_inline(e, node, tail, &done);
+            emit(e, OP_JUMP);
+            emit_jump(e, &done);
+            patch_jumps(e, fallback);
+            emit(e, OP_SOURCE);
+            emit_constant(e, node->source);
+            patch_jumps(e, done);
+            break;
+        default:
+            emit(e, OP_SOURCE);
+            emit_constant(e, node->source);
+            break;
+    }
+    return;
+}
+
+// Compiles a function body, evaluated in environments whose global environment
+//   is env's, to bytecode that leaves its value for OP_RETURN. The bytecode
+//   refers to the body, which must outlive it; it is freed with
+//   delete_bytecode().
+Bytecode* compile(const typed_ptr* body, Environment* env) {
+    Bytecode* bytecode = malloc(sizeof(Bytecode));
+    if (bytecode == NULL) {
+        fprintf(stderr, "malloc failed in compile()\n");
+        exit(-1);
+    }
+    bytecode->code = NULL;
+    bytecode->length = 0;
+    bytecode->constants = NULL;
+    bytecode->constant_count = 0;
+    Emitter e = {.bytecode=bytecode, .code_capacity=0, .constants_capacity=0};
+    Tree_Node* tree = analyze(body, env);
+    compile_node(&e, tree, true);
+    emit(&e, OP_RETURN);
+    delete_tree_node(tree);
+    return bytecode;
+}
+
+// the virtual machine
+
+// An activation is a call of a function whose bytecode is being run: where it
+//   is up to, and the call frame it runs in, which it owns.
+typedef struct VM_ACTIVATION {
+    const Bytecode* bytecode;
+    unsigned int pc;
+    Environment* frame;
+} Vm_Activation;
+
+// The machine's value stack holds the operands of the instructions being run,
+//   and its activation stack the calls that are running; a call made from
+//   bytecode is pushed there, rather than made on the C stack, so how deeply
+//   functions may recurse is bounded only by VM_MAX_DEPTH activations (or
+//   memory). The stacks are shared by every run of the machine, including any
+//   started by a built-in the machine called, which uses them above the part
+//   the run that called it was using, and leaves them as it found them.
+// Such a nested run does use the C stack, though: a built-in evaluates its
+//   arguments with evaluate(), which calls run_body() for any function called
+//   there. So the C stack the runs under way use, measured from where the
+//   outermost of them started (the stack is taken to grow downwards, as it
+//   does on the usual platforms), is bounded by VM_MAX_C_STACK bytes, which
+//   leaves room to spare below the usual 8MB limit.
+typedef struct VM_STACKS {
+    typed_ptr* values;
+    unsigned int values_used;
+    unsigned int values_capacity;
+    Vm_Activation* activations;
+    unsigned int depth;
+    unsigned int activations_capacity;
+    unsigned int runs;
+    uintptr_t stack_base;
+} Vm_Stacks;
+
+#ifndef VM_MAX_DEPTH
+#define VM_MAX_DEPTH (1u << 20)
+#endif
+
+#ifndef VM_MAX_C_STACK
+#define VM_MAX_C_STACK (1L << 22)
+#endif
+
+static Vm_Stacks vm = {.values=NULL, \
+                       .values_used=0, \
+                       .values_capacity=0, \
+                       .activations=NULL, \
+                       .depth=0, \
+                       .activations_capacity=0, \
+                       .runs=0, \
+                       .stack_base=0};
+
+static void vm_push(typed_ptr value) {
+    if (vm.values_used == vm.values_capacity) {
+        vm.values_capacity = (vm.values_capacity == 0) ? \
+                             64 : \
+                             2 * vm.values_capacity;
+        vm.values = realloc(vm.values, vm.values_capacity * sizeof(typed_ptr));
+        if (vm.values == NULL) {
+            fprintf(stderr, "realloc failed in vm_push()\n");
+            exit(-1);
+        }
+    }
+    vm.values[vm.values_used++] = value;
+    return;
+}
+
+static typed_ptr vm_pop(void) {
+    return vm.values[--vm.values_used];
+}
+
+// Pushes an activation for the body of the function a call frame was bound for,
+//   compiling the body first if this is its first call. Returns false, leaving
+//   the frame to the caller, if the stack is already VM_MAX_DEPTH deep.
+static bool vm_enter(Environment* frame) {
+    if (vm.depth == VM_MAX_DEPTH) {
+        return false;
+    }
+    if (vm.depth == vm.activations_capacity) {
+        vm.activations_capacity = (vm.activations_capacity == 0) ? \
+                                  16 : \
+                                  2 * vm.activations_capacity;
+        vm.activations = realloc(vm.activations, \
+                                 vm.activations_capacity * \
+                                 sizeof(Vm_Activation));
+        if (vm.activations == NULL) {
+            fprintf(stderr, "realloc failed in vm_enter()\n");
+            exit(-1);
+        }
+    }
+    Function_Code* code = frame->code;
+    if (code->bytecode == NULL) {
+        code->bytecode = compile(code->body, frame);
+    }
+    Vm_Activation* act = &vm.activations[vm.depth++];
+    act->bytecode = code->bytecode;
+    act->pc = 0;
+    act->frame = frame;
+    return true;
+}
+
+// Evaluates the arguments on top of the value stack into a call frame for the
+//   function below them, popping both. Returns the frame, or NULL (with the
+//   error in err) if the argument count is wrong.
+static Environment* vm_bind(unsigned int arg_count, \
+                            Environment* env, \
+                            typed_ptr* err) {
+    typed_ptr* args = &vm.values[vm.values_used - arg_count];
+    Function_Node* fn = function_lookup_index(env, &args[-1]);
+    Environment* callee = create_call_frame(fn->code, fn->enclosing_env);
+    vm.values_used -= arg_count + 1;
+    if (arg_count != callee->slot_count) {
+        *err = error_tp((arg_count < callee->slot_count) ? \
+                        EVAL_ERROR_FEW_ARGS : \
+                        EVAL_ERROR_MANY_ARGS);
+        for (unsigned int i = 0; i < arg_count; i++) {
+            discard_value(args[i]);
+        }
+        delete_environment(callee);
+        return NULL;
+    }
+    for (unsigned int slot = 0; slot < arg_count; slot++) {
+        callee->slots[slot].type = args[slot].type;
+        callee->slots[slot].value = args[slot].ptr;
+    }
+    return callee;
+}
+
+// Applies an inline built-in (see analyze_form()) to its evaluated arguments,
+//   which it frees.
+static typed_ptr vm_primitive(builtin_code op, typed_ptr* args) {
+    typed_ptr result;
+    switch (op) {
+        case BUILTIN_CONS:
+            result = s_expr_tp(create_s_expr(args[0], args[1]));
+            break;
+        case BUILTIN_CAR: // fall-through
+        case BUILTIN_CDR:
+            if (args[0].type != TYPE_S_EXPR || \
+                is_empty_list(args[0].ptr.se_ptr)) {
+                result = error_tp(EVAL_ERROR_BAD_ARG_TYPE);
+            } else if (op == BUILTIN_CAR) {
+                result = share_value(&args[0].ptr.se_ptr->car);
+            } else {
+                result = share_value(&args[0].ptr.se_ptr->cdr);
+            }
+            discard_value(args[0]);
+            break;
+        case BUILTIN_NULLPRED:
+            result = atom_tp(TYPE_BOOL, \
+                             args[0].type == TYPE_S_EXPR && \
+                             is_empty_list(args[0].ptr.se_ptr));
+            discard_value(args[0]);
+            break;
+        default:
+            result = error_tp(EVAL_ERROR_UNDEF_BUILTIN);
+            break;
+    }
+    return result;
+}
+
+// Folds the evaluated arguments of an inline arithmetic or numeric comparison
+//   built-in, which it frees, as eval_arithmetic() or eval_comparison() would.
+static typed_ptr vm_fold(opcode instruction, \
+                         builtin_code op, \
+                         typed_ptr* args, \
+                         unsigned int arg_count) {
+    typed_ptr result;
+    if (instruction == OP_COMPARE) {
+        result = atom_tp(TYPE_BOOL, true);
+        long last_num = 0;
+        for (unsigned int i = 0; i < arg_count; i++) {
+            result = comparison_step(op, result, args[i], &last_num, i + 1);
+        }
+        return (arg_count < 2) ? error_tp(EVAL_ERROR_FEW_ARGS) : result;
+    }
+    bool inverse_op = (op == BUILTIN_SUB || op == BUILTIN_DIV);
+    long initial = (op == BUILTIN_ADD || op == BUILTIN_SUB) ? 0 : 1;
+    result = atom_tp(TYPE_FIXNUM, initial);
+    for (unsigned int i = 0; i < arg_count; i++) {
+        bool seeds_total = (i == 0 && inverse_op && arg_count > 1);
+        result = arithmetic_step(op, result, args[i], seeds_total);
+    }
+    if (arg_count == 0 && inverse_op) {
+        result = error_tp(EVAL_ERROR_FEW_ARGS);
+    }
+    return result;
+}
+
+// Looks up the operator of a form the bytecode refers to, and reports whether
+//   it names the given built-in.
+static bool vm_guard(const typed_ptr* operator, \
+                     builtin_code op, \
+                     Environment* env) {
+    typed_ptr found = value_lookup_index(env, operator);
+    if (found.type == TYPE_BUILTIN && found.ptr.idx == op) {
+        return true;
+    }
+    discard_value(found);
+    return false;
+}
+
+// How run_body() gets from one instruction to the next: built with gcc, each
+//   instruction jumps straight to the code for the one after it, through a
+//   table of the addresses of their labels (gcc's labels as values), so that
+//   every instruction has its own indirect branch for the processor to
+//   predict. Otherwise, or if VM_SWITCH_DISPATCH is defined (see the
+//   Makefile), each goes back to a switch on the next opcode.
+#if defined(__GNUC__) && !defined(VM_SWITCH_DISPATCH)
+#define VM_THREADED_DISPATCH
+#endif
+
+#ifdef VM_THREADED_DISPATCH
+#define VM_TARGET(op) target_##op
+#define VM_NEXT() goto *dispatch_table[code[pc++]]
+#else
+#define VM_TARGET(op) case op
+#define VM_NEXT() goto dispatch
+#endif
+
+// Evaluates the body of a function in the call frame bound for it (see
+//   enter_function()), on the virtual machine, and then releases the frame (see
+//   release_frame()).
+// Functions and environments made during a long run are collected as it goes:
+//   on a call, if a collection is due, and the run is the only one under way,
+//   started by the only evaluation under way (see evaluations), so that all
+//   the values still needed are on the machine's stacks.
+// Returns the value of the body, or the first error any instruction produced;
+//   an error ends the run at once, releasing the frames of every call still
+//   running in it and freeing the values left on its stack. Starting a run
+//   further than VM_MAX_C_STACK bytes down the C stack from the outermost one
+//   is an EVAL_ERROR_TOO_DEEP error.
+static typed_ptr run_body(Environment* frame) {
+#ifdef VM_THREADED_DISPATCH
+    static void* const dispatch_table[] = { \
+        [OP_CONSTANT]=&&target_OP_CONSTANT, \
+        [OP_LOCAL]=&&target_OP_LOCAL, \
+        [OP_LOAD]=&&target_OP_LOAD, \
+        [OP_SOURCE]=&&target_OP_SOURCE, \
+        [OP_BOOL]=&&target_OP_BOOL, \
+        [OP_VOID]=&&target_OP_VOID, \
+        [OP_GUARD]=&&target_OP_GUARD, \
+        [OP_BUILTIN]=&&target_OP_BUILTIN, \
+        [OP_PREPARE]=&&target_OP_PREPARE, \
+        [OP_CALL]=&&target_OP_CALL, \
+        [OP_TAIL_CALL]=&&target_OP_TAIL_CALL, \
+        [OP_RETURN]=&&target_OP_RETURN, \
+        [OP_POP]=&&target_OP_POP, \
+        [OP_JUMP]=&&target_OP_JUMP, \
+        [OP_BRANCH_FALSE]=&&target_OP_BRANCH_FALSE, \
+        [OP_AND]=&&target_OP_AND, \
+        [OP_OR]=&&target_OP_OR, \
+        [OP_ARITHMETIC]=&&target_OP_ARITHMETIC, \
+        [OP_COMPARE]=&&target_OP_COMPARE, \
+        [OP_PRIMITIVE]=&&target_OP_PRIMITIVE};
+#endif
+    unsigned int base_values = vm.values_used;
+    unsigned int base_depth = vm.depth;
+    char stack_mark;
+    if (vm.runs == 0) {
+        vm.stack_base = (uintptr_t)&stack_mark;
+    }
+    if ((intptr_t)(vm.stack_base - (uintptr_t)&stack_mark) > VM_MAX_C_STACK || \
+        !vm_enter(frame)) {
+        release_frame(frame);
+        return error_tp(EVAL_ERROR_TOO_DEEP);
+    }
+    vm.runs++;
+    const Bytecode* bytecode = vm.activations[vm.depth - 1].bytecode;
+    const unsigned int* code = bytecode->code;
+    const typed_ptr** constants = bytecode->constants;
+    unsigned int pc = 0;
+    Environment* env = frame;
+    typed_ptr result = void_tp();
+    // the value the last instruction produced, which goes on the stack
+    typed_ptr value;
+    VM_NEXT();
+#ifndef VM_THREADED_DISPATCH
+dispatch:
+    switch (code[pc++]) {
+#endif
+        VM_TARGET(OP_CONSTANT):
+            value = share_value(constants[code[pc++]]);
+            goto push;
+        VM_TARGET(OP_LOCAL): {
+            // the slot the reference was resolved to, if it is still there
+            //   (see address_lookup())
+            const typed_ptr* ref = constants[code[pc++]];
+            const Environment* scope = env;
+            unsigned int depth = ADDRESS_DEPTH(ref->address);
+            while (depth > 0 && \
+                   !scope->extended && \
+                   scope->enclosing_env != NULL) {
+                scope = scope->enclosing_env;
+                depth--;
+            }
+            unsigned int slot = ADDRESS_SLOT(ref->address);
+            value.type = TYPE_UNDEF;
+            if (depth == 0 && \
+                slot < scope->slot_count && \
+                scope->slots[slot].symbol_idx == ref->ptr.idx) {
+                value = binding_value(&scope->slots[slot]);
+            }
+            if (value.type != TYPE_UNDEF) {
+                value = share_value(&value);
+            } else {
+                value = value_lookup_index(env, ref);
+            }
+            goto push;
+        }
+        VM_TARGET(OP_LOAD):
+            value = value_lookup_index(env, constants[code[pc++]]);
+            goto push;
+        VM_TARGET(OP_SOURCE):
+            value = evaluate(constants[code[pc++]], env);
+            goto push;
+        VM_TARGET(OP_BOOL):
+            value = atom_tp(TYPE_BOOL, code[pc++]);
+            goto push;
+        VM_TARGET(OP_VOID):
+            value = void_tp();
+            goto push;
+        VM_TARGET(OP_GUARD):
+            if (vm_guard(constants[code[pc]], code[pc + 1], env)) {
+                pc += 3;
+            } else {
+                pc = code[pc + 2];
+            }
+            VM_NEXT();
+        VM_TARGET(OP_BUILTIN): {
+            const typed_ptr* form = constants[code[pc]];
+            builtin_code op = code[pc + 1];
+            pc += 2;
+            if (vm_guard(&form->ptr.se_ptr->car, op, env)) {
+                s_expr subbed_se = {.car=atom_tp(TYPE_BUILTIN, op), \
+                                    .cdr=form->ptr.se_ptr->cdr};
+                value = eval_builtin(&subbed_se, env);
+            } else {
+                value = evaluate(form, env);
+            }
+            goto push;
+        }
+        VM_TARGET(OP_PREPARE): {
+            // the operator, on top of the stack, decides how the form is to be
+            //   evaluated: a built-in is passed it (skipping the code for the
+            //   arguments), and a function is called
+            const typed_ptr* form = constants[code[pc]];
+            typed_ptr callee = vm.values[vm.values_used - 1];
+            if (callee.type == TYPE_FUNCTION && \
+                function_lookup_index(env, &callee) != NULL) {
+                pc += 2;
+                VM_NEXT();
+            }
+            vm_pop();
+            if (callee.type == TYPE_BUILTIN) {
+                s_expr subbed_se = {.car=callee, .cdr=form->ptr.se_ptr->cdr};
+                value = eval_builtin(&subbed_se, env);
+                pc = code[pc + 1];
+            } else if (callee.type == TYPE_FUNCTION) {
+                value = error_tp(EVAL_ERROR_UNDEF_FUNCTION);
+            } else {
+                discard_value(callee);
+                value = error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
+            }
+            goto push;
+        }
+        VM_TARGET(OP_CALL): // fall-through
+        VM_TARGET(OP_TAIL_CALL): {
+            bool tail_call = (code[pc - 1] == OP_TAIL_CALL);
+            Environment* callee = vm_bind(code[pc++], env, &value);
+            if (callee == NULL) {
+                goto push;
+            }
+            if (tail_call) {
+                // the call takes the place of the one making it
+                vm.depth--;
+                release_frame(env);
+            } else {
+                vm.activations[vm.depth - 1].pc = pc;
+            }
+            if (!vm_enter(callee)) {
+                // a tail call never adds to the depth, so is never here
+                release_frame(callee);
+                value = error_tp(EVAL_ERROR_TOO_DEEP);
+                goto push;
+            }
+            if (vm.runs == 1 && \
+                evaluations == 1 && \
+                garbage_collection_due()) {
+                // everything live is on the machine's stacks
+                collect_garbage_with_roots(callee, mark_evaluator_roots);
+            }
+            bytecode = vm.activations[vm.depth - 1].bytecode;
+            code = bytecode->code;
+            constants = bytecode->constants;
+            pc = 0;
+            env = callee;
+            VM_NEXT();
+        }
+        VM_TARGET(OP_RETURN): {
+            result = vm_pop();
+            release_frame(env);
+            vm.depth--;
+            if (vm.depth == base_depth) {
+                vm.runs--;
+                return result;
+            }
+            Vm_Activation* act = &vm.activations[vm.depth - 1];
+            bytecode = act->bytecode;
+            code = bytecode->code;
+            constants = bytecode->constants;
+            pc = act->pc;
+            env = act->frame;
+            value = result;
+            goto push;
+        }
+        VM_TARGET(OP_POP):
+            discard_value(vm_pop());
+            VM_NEXT();
+        VM_TARGET(OP_JUMP):
+            pc = code[pc];
+            VM_NEXT();
+        VM_TARGET(OP_BRANCH_FALSE):
+            value = vm_pop();
+            if (is_false_literal(&value)) {
+                pc = code[pc];
+            } else {
+                discard_value(value);
+                pc++;
+            }
+            VM_NEXT();
+        VM_TARGET(OP_AND): // fall-through
+        VM_TARGET(OP_OR):
+            value = vm.values[vm.values_used - 1];
+            if (is_false_literal(&value) == (code[pc - 1] == OP_AND)) {
+                pc = code[pc];
+            } else {
+                discard_value(vm_pop());
+                pc++;
+            }
+            VM_NEXT();
+        VM_TARGET(OP_ARITHMETIC): // fall-through
+        VM_TARGET(OP_COMPARE): {
+            opcode instruction = code[pc - 1];
+            builtin_code op = code[pc];
+            unsigned int arg_count = code[pc + 1];
+            pc += 2;
+            vm.values_used -= arg_count;
+            typed_ptr* args = &vm.values[vm.values_used];
+            if (arg_count == 2 && \
+                args[0].type == TYPE_FIXNUM && \
+                args[1].type == TYPE_FIXNUM) {
+                // the common case, done directly
+                long last_num = args[0].ptr.idx;
+                if (instruction == OP_ARITHMETIC) {
+                    value = fixnum_step(op, last_num, args[1].ptr.idx);
+                } else {
+                    value = comparison_step(op, \
+                                            atom_tp(TYPE_BOOL, true), \
+                                            args[1], \
+                                            &last_num, \
+                                            2);
+                }
+                goto push;
+            }
+            value = vm_fold(instruction, op, args, arg_count);
+            goto push;
+        }
+        VM_TARGET(OP_PRIMITIVE): {
+            builtin_code op = code[pc++];
+            unsigned int arg_count = (op == BUILTIN_CONS) ? 2 : 1;
+            vm.values_used -= arg_count;
+            value = vm_primitive(op, &vm.values[vm.values_used]);
+            goto push;
+        }
+#ifndef VM_THREADED_DISPATCH
+        default:
+            value = error_tp(EVAL_ERROR_UNDEF_TYPE);
+            goto push;
+    }
+#endif
+push:
+    if (value.type != TYPE_ERROR) {
+        if (vm.values_used == vm.values_capacity) {
+            vm_push(value);
+        } else {
+            vm.values[vm.values_used++] = value;
+        }
+        VM_NEXT();
+    }
+    result = value;
+    while (vm.values_used > base_values) {
+        discard_value(vm_pop());
+    }
+    while (vm.depth > base_depth) {
+        release_frame(vm.activations[--vm.depth].frame);
+    }
+    vm.runs--;
+    return result;
+}
+
+#undef VM_TARGET
+#undef VM_NEXT
+
+// heap-continuation evaluator
+
+// evaluate_cek() evaluates an expression just as evaluate() does, but without
+//   recursing on the C stack. It is a CEK machine: at each step it either
+//   evaluates an expression (the control) in an environment, or hands a value
+//   to the continuation, the work still to be done once that value is known.
+//   The continuation is kept as a stack of frames on the heap, so how deeply a
+//   program may recurse is bounded only by CEK_MAX_DEPTH frames (or memory),
+//   and running past that is an EVAL_ERROR_TOO_DEEP error rather than a crash.
+// Function calls, and the cond, and and or special forms, are taken apart by
+//   the machine itself. The arguments of other built-ins are evaluated by the
+//   machine and then passed to the usual eval_xxx() function, with any list or
+//   symbol value quoted so that evaluating it there is a single step; those
+//   that take no evaluated argument (lambda, quote, exit, and function
+//   definitions) are passed their form as it is.
+#ifndef CEK_MAX_DEPTH
+#define CEK_MAX_DEPTH (1u << 20)
+#endif
+
+typedef enum {CEK_CALL, CEK_COND, CEK_AND_OR, CEK_RETURN} cek_kind;
+
+// CEK_CALL: the operator of form, and then the arguments up to and including
+//   the one in the cell next (at the given position; the operator's is 0),
+//   have been or are being evaluated in env; op is the operator's value (none
+//   while it is being evaluated), and args the argument values so far, ending
+//   at args_tail.
+// CEK_COND: the clause in the cell next of form is being tried in env; body is
+//   NULL while its predicate is being evaluated, and then the cell before the
+//   then-body being evaluated (the clause itself, before the first).
+// CEK_AND_OR: the argument in the cell next of form is being evaluated in env;
+//   op is the and or or built-in.
+// CEK_RETURN: env is the frame of a function call whose body is being
+//   evaluated, to be released when its value is known (see release_frame()).
+typedef struct CEK_FRAME {
+    cek_kind kind;
+    Environment* env;
+    const s_expr* form;
+    const s_expr* next;
+    const s_expr* body;
+    unsigned int position;
+    typed_ptr op;
+    s_expr* args;
+    s_expr* args_tail;
+} Cek_Frame;
+
+typedef struct CEK_STACK {
+    Cek_Frame* frames;
+    unsigned int depth;
+    unsigned int capacity;
+} Cek_Stack;
+
+static unsigned int cek_peak = 0;
+
+// The continuation stack of the outermost evaluate_cek() under way, if it is
+//   the outermost evaluation, and the environment of the expression it is
+//   about to evaluate while it collects garbage (see mark_evaluator_roots()).
+static const Cek_Stack* cek_roots = NULL;
+static Environment* cek_control_env = NULL;
+
+// Pushes the values and environments the evaluator holds on its own stacks as
+//   roots for a collection (see collect_garbage_with_roots()).
+static void mark_evaluator_roots(void) {
+    for (unsigned int i = 0; i < vm.values_used; i++) {
+        mark_root_value(&vm.values[i]);
+    }
+    for (unsigned int i = 0; i < vm.depth; i++) {
+        mark_root_environment(vm.activations[i].frame);
+    }
+    if (cek_roots != NULL) {
+        for (unsigned int i = 0; i < cek_roots->depth; i++) {
+            const Cek_Frame* frame = &cek_roots->frames[i];
+            mark_root_environment(frame->env);
+            if (frame->kind == CEK_CALL) {
+                mark_root_value(&frame->op);
+                if (frame->args != NULL) {
+                    typed_ptr args_tp = s_expr_tp(frame->args);
+                    mark_root_value(&args_tp);
+                }
+            }
+        }
+    }
+    if (cek_control_env != NULL) {
+        mark_root_environment(cek_control_env);
+    }
+    return;
+}
+
+// The deepest the continuation stack grew during the latest evaluate_cek().
+unsigned int cek_peak_depth(void) {
+    return cek_peak;
+}
+
+// Returns the new frame, uninitialized, or NULL if the stack cannot grow.
+static Cek_Frame* cek_push(Cek_Stack* stack, cek_kind kind, Environment* env) {
+    if (stack->depth == stack->capacity) {
+        if (stack->capacity >= CEK_MAX_DEPTH) {
+            return NULL;
+        }
+        unsigned int capacity = (stack->capacity == 0) ? \
+                                64 : \
+                                2 * stack->capacity;
+        if (capacity > CEK_MAX_DEPTH) {
+            capacity = CEK_MAX_DEPTH;
+        }
+        Cek_Frame* frames = realloc(stack->frames, \
+                                    capacity * sizeof(Cek_Frame));
+        if (frames == NULL) {
+            return NULL;
+        }
+        stack->frames = frames;
+        stack->capacity = capacity;
+    }
+    Cek_Frame* frame = &stack->frames[stack->depth++];
+    if (stack->depth > cek_peak) {
+        cek_peak = stack->depth;
+    }
+    frame->kind = kind;
+    frame->env = env;
+    return frame;
+}
+
+// Frees whatever the top frame holds, and pops it.
+static void cek_pop(Cek_Stack* stack) {
+    Cek_Frame* frame = &stack->frames[--stack->depth];
+    if (frame->kind == CEK_CALL && frame->args != NULL) {
+        delete_s_expr_recursive(frame->args, true);
+    } else if (frame->kind == CEK_RETURN) {
+        release_frame(frame->env);
+    }
+    return;
+}
+
+// Whether the machine evaluates any of the arguments of a call to a built-in
+//   other than cond, and and or.
+static bool cek_evaluates_arguments(const s_expr* form, builtin_code op) {
+    switch (op) {
+        case BUILTIN_DEFINE: // fall-through
+        case BUILTIN_SETVAR:
+            return !is_pair(form) && \
+                   !is_empty_list(s_expr_next(form)) && \
+                   s_expr_next(form)->car.type == TYPE_SYMBOL;
+        case BUILTIN_LAMBDA: // fall-through
+        case BUILTIN_QUOTE: // fall-through
+        case BUILTIN_EXIT:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Whether the machine evaluates the argument at the given position of a call
+//   to a built-in of which it evaluates any.
+static bool cek_evaluates_argument(builtin_code op, unsigned int position) {
+    return (op != BUILTIN_DEFINE && op != BUILTIN_SETVAR) || position == 2;
+}
+
+// Appends a value to a call frame's arguments, taking it over. A built-in will
+//   evaluate its arguments itself, so the values of evaluated ones are quoted
+//   where they would not evaluate to themselves.
+static void cek_add_argument(Cek_Frame* call, typed_ptr value, bool evaluated) {
+    if (evaluated && \
+        call->op.type == TYPE_BUILTIN && \
+        (value.type == TYPE_S_EXPR || value.type == TYPE_SYMBOL)) {
+        typed_ptr quoted = s_expr_tp(create_s_expr(value, \
+                                     s_expr_tp(create_empty_s_expr())));
+        value = s_expr_tp(create_s_expr(atom_tp(TYPE_BUILTIN, BUILTIN_QUOTE), \
+                                        quoted));
+    }
+    call->args_tail->car = value;
+    call->args_tail->cdr = s_expr_tp(create_empty_s_expr());
+    call->args_tail = s_expr_next(call->args_tail);
+    return;
+}
+
+// The steps below take the value handed to the top frame of the stack (or, for
+//   the cek_begin_xxx() steps, the operator of a new form), and either leave
+//   the value to hand on to the next frame in *value, returning true, or leave
+//   an expression to evaluate in *tp and *env, returning false.
+
+// Evaluates the then-body of the cond at the top of the stack after the one
+//   in body; the last one is evaluated in the cond's place.
+static bool cek_next_body(Cek_Stack* stack, \
+                          const typed_ptr** tp, \
+                          Environment** env) {
+    Cek_Frame* cond = &stack->frames[stack->depth - 1];
+    const s_expr* body = s_expr_next(cond->body);
+    *tp = &body->car;
+    *env = cond->env;
+    if (is_empty_list(s_expr_next(body))) {
+        cek_pop(stack);
+    } else {
+        cond->body = body;
+    }
+    return false;
+}
+
+// Evaluates the clause of the cond at the top of the stack in its cell next.
+static bool cek_try_clause(Cek_Stack* stack, \
+                           typed_ptr* value, \
+                           const typed_ptr** tp, \
+                           Environment** env) {
+    Cek_Frame* cond = &stack->frames[stack->depth - 1];
+    if (is_empty_list(cond->next)) {
+        cek_pop(stack);
+        *value = void_tp();
+        return true;
+    }
+    s_expr* clause = cond->next->car.ptr.se_ptr;
+    if (is_empty_list(clause)) {
+        *value = error_tp(EVAL_ERROR_BAD_SYNTAX);
+        return true;
+    }
+    Symbol_Node* else_stn = symbol_lookup_name(cond->env->global_env, "else");
+    if (clause->car.type == TYPE_SYMBOL && \
+        clause->car.ptr.idx == else_stn->symbol_idx) {
+        if (!is_empty_list(s_expr_next(cond->next))) {
+            *value = error_tp(EVAL_ERROR_NONTERMINAL_ELSE);
+            return true;
+        } else if (is_empty_list(s_expr_next(clause))) {
+            *value = error_tp(EVAL_ERROR_EMPTY_ELSE);
+            return true;
+        }
+        cond->body = clause;
+        return cek_next_body(stack, tp, env);
+    }
+    cond->body = NULL;
+    *tp = &clause->car;
+    *env = cond->env;
+    return false;
+}
+
+static bool cek_resume_cond(Cek_Stack* stack, \
+                            typed_ptr* value, \
+                            const typed_ptr** tp, \
+                            Environment** env) {
+    Cek_Frame* cond = &stack->frames[stack->depth - 1];
+    if (cond->body != NULL) {
+        discard_value(*value);
+        return cek_next_body(stack, tp, env);
+    } else if (is_false_literal(value)) {
+        cond->next = s_expr_next(cond->next);
+        return cek_try_clause(stack, value, tp, env);
+    }
+    cond->body = cond->next->car.ptr.se_ptr;
+    if (is_empty_list(s_expr_next(cond->body))) {
+        cek_pop(stack);
+        return true;
+    }
+    discard_value(*value);
+    return cek_next_body(stack, tp, env);
+}
+
+static bool cek_begin_cond(Cek_Stack* stack, \
+                           typed_ptr* value, \
+                           const typed_ptr** tp, \
+                           Environment** env) {
+    Cek_Frame* cond = &stack->frames[stack->depth - 1];
+    s_expr subbed_se = {.car=*value, .cdr=cond->form->cdr};
+    typed_ptr args_tp = collect_arguments(&subbed_se, cond->env, 0, -1, false);
+    if (args_tp.type == TYPE_ERROR) {
+        *value = args_tp;
+        return true;
+    }
+    for (s_expr* clause = args_tp.ptr.se_ptr; \
+         !is_empty_list(clause); \
+         clause = s_expr_next(clause)) {
+        if (clause->car.type != TYPE_S_EXPR) {
+            delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
+            *value = error_tp(EVAL_ERROR_BAD_SYNTAX);
+            return true;
+        }
+    }
+    delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
+    cond->kind = CEK_COND;
+    cond->next = s_expr_next(cond->form);
+    return cek_try_clause(stack, value, tp, env);
+}
+
+// Evaluates the argument of the and or or at the top of the stack in its cell
+//   next; the last one is evaluated in the and or or's place.
+static bool cek_next_operand(Cek_Stack* stack, \
+                             typed_ptr* value, \
+                             const typed_ptr** tp, \
+                             Environment** env) {
+    Cek_Frame* and_or = &stack->frames[stack->depth - 1];
+    if (is_empty_list(and_or->next)) {
+        *value = atom_tp(TYPE_BOOL, and_or->op.ptr.idx == BUILTIN_AND);
+        cek_pop(stack);
+        return true;
+    }
+    *tp = &and_or->next->car;
+    *env = and_or->env;
+    if (is_empty_list(s_expr_next(and_or->next))) {
+        cek_pop(stack);
+    }
+    return false;
+}
+
+static bool cek_resume_and_or(Cek_Stack* stack, \
+                              typed_ptr* value, \
+                              const typed_ptr** tp, \
+                              Environment** env) {
+    Cek_Frame* and_or = &stack->frames[stack->depth - 1];
+    bool is_and = (and_or->op.ptr.idx == BUILTIN_AND);
+    if (is_false_literal(value) == is_and) {
+        cek_pop(stack);
+        return true;
+    }
+    discard_value(*value);
+    and_or->next = s_expr_next(and_or->next);
+    return cek_next_operand(stack, value, tp, env);
+}
+
+static bool cek_begin_and_or(Cek_Stack* stack, \
+                             typed_ptr* value, \
+                             const typed_ptr** tp, \
+                             Environment** env) {
+    Cek_Frame* and_or = &stack->frames[stack->depth - 1];
+    s_expr subbed_se = {.car=*value, .cdr=and_or->form->cdr};
+    typed_ptr args_tp = collect_arguments(&subbed_se, \
+                                          and_or->env, \
+                                          0, \
+                                          -1, \
+                                          false);
+    if (args_tp.type == TYPE_ERROR) {
+        *value = args_tp;
+        return true;
+    }
+    delete_s_expr_recursive(args_tp.ptr.se_ptr, false);
+    and_or->kind = CEK_AND_OR;
+    and_or->op = *value;
+    and_or->next = s_expr_next(and_or->form);
+    return cek_next_operand(stack, value, tp, env);
+}
+
+// Calls the function or built-in at the top of the stack, whose arguments
+//   have all been evaluated. A function's body is evaluated in the call's
+//   place; if the call was itself the last thing left to do in another
+//   function's body, the new frame takes the place of that one on the stack.
+static bool cek_apply(Cek_Stack* stack, \
+                      typed_ptr* value, \
+                      const typed_ptr** tp, \
+                      Environment** env) {
+    Cek_Frame* call = &stack->frames[stack->depth - 1];
+    typed_ptr args_tp = s_expr_tp(call->args);
+    if (call->op.type == TYPE_BUILTIN) {
+        s_expr subbed_se = {.car=call->op, .cdr=args_tp};
+        *value = eval_builtin(&subbed_se, call->env);
+        cek_pop(stack);
+        return true;
+    }
+    Function_Node* fn = function_lookup_index(call->env, &call->op);
+    if (fn == NULL) {
+        *value = error_tp(EVAL_ERROR_UNDEF_FUNCTION);
+        return true;
+    }
+    Environment* callee = create_call_frame(fn->code, fn->enclosing_env);
+    *value = bind_args(callee, &args_tp);
+    cek_pop(stack);
+    if (value->type == TYPE_ERROR) {
+        delete_environment(callee);
+        return true;
+    }
+    if (stack->depth > 0 && \
+        stack->frames[stack->depth - 1].kind == CEK_RETURN) {
+        Cek_Frame* caller = &stack->frames[stack->depth - 1];
+        release_frame(caller->env);
+        caller->env = callee;
+    } else if (cek_push(stack, CEK_RETURN, callee) == NULL) {
+        release_frame(callee);
+        *value = error_tp(EVAL_ERROR_TOO_DEEP);
+        return true;
+    }
+    *tp = callee->code->body;
+    *env = callee;
+    return false;
+}
+
+// Moves the call at the top of the stack on to its next argument that is to
+//   be evaluated, adding those that are not as they are, or applies it once
+//   there are no more.
+static bool cek_next_argument(Cek_Stack* stack, \
+                              typed_ptr* value, \
+                              const typed_ptr** tp, \
+                              Environment** env) {
+    Cek_Frame* call = &stack->frames[stack->depth - 1];
+    while (true) {
+        if (is_pair(call->next)) {
+            *value = error_tp(EVAL_ERROR_ILLEGAL_PAIR);
+            return true;
+        }
+        call->next = s_expr_next(call->next);
+        call->position++;
+        if (is_empty_list(call->next)) {
+            return cek_apply(stack, value, tp, env);
+        } else if (call->op.type == TYPE_FUNCTION || \
+                   cek_evaluates_argument(call->op.ptr.idx, call->position)) {
+            *tp = &call->next->car;
+            *env = call->env;
+            return false;
+        }
+        cek_add_argument(call, share_value(&call->next->car), false);
+    }
+}
+
+static bool cek_resume_call(Cek_Stack* stack, \
+                            typed_ptr* value, \
+                            const typed_ptr** tp, \
+                            Environment** env) {
+    Cek_Frame* call = &stack->frames[stack->depth - 1];
+    if (call->op.type != TYPE_NONE) {
+        cek_add_argument(call, *value, true);
+        return cek_next_argument(stack, value, tp, env);
+    } else if (value->type == TYPE_FUNCTION) {
+        call->op = *value;
+    } else if (value->type != TYPE_BUILTIN) {
+        discard_value(*value);
+        *value = error_tp(EVAL_ERROR_CAR_NOT_CALLABLE);
+        return true;
+    } else if (value->ptr.idx == BUILTIN_COND) {
+        return cek_begin_cond(stack, value, tp, env);
+    } else if (value->ptr.idx == BUILTIN_AND || \
+               value->ptr.idx == BUILTIN_OR) {
+        return cek_begin_and_or(stack, value, tp, env);
+    } else if (!cek_evaluates_arguments(call->form, value->ptr.idx)) {
+        s_expr subbed_se = {.car=*value, .cdr=call->form->cdr};
+        *value = eval_builtin(&subbed_se, call->env);
+        cek_pop(stack);
+        return true;
+    } else {
+        call->op = *value;
+    }
+    call->args = create_empty_s_expr();
+    call->args_tail = call->args;
+    return cek_next_argument(stack, value, tp, env);
+}
+
+// Evaluates the expression tp points to in env; see evaluate_cek() above.
+// The value is returned as evaluate() would return it.
+typed_ptr evaluate_cek(const typed_ptr* tp, Environment* env) {
+    Cek_Stack stack = {.frames=NULL, .depth=0, .capacity=0};
+    cek_peak = 0;
+    if (evaluations++ == 0) {
+        cek_roots = &stack;
+    }
+    typed_ptr value;
+    bool have_value = false;
+    while (true) {
+        if (!have_value) {
+            if (cek_roots == &stack && garbage_collection_due()) {
+                // everything live is on the stack, or is env
+                cek_control_env = env;
+                collect_garbage_with_roots(env, mark_evaluator_roots);
+                cek_control_env = NULL;
+            }
+            const s_expr* se = (tp != NULL && tp->type == TYPE_S_EXPR) ? \
+                               tp->ptr.se_ptr : \
+                               NULL;
+            if (se == NULL || \
+                is_empty_list(se) || \
+                se->car.type == TYPE_NONE || \
+                se->cdr.type == TYPE_NONE) {
+                // nothing to take apart, so no recursion either
+                value = evaluate(tp, env);
+                have_value = true;
+            } else {
+                Cek_Frame* call = cek_push(&stack, CEK_CALL, env);
+                if (call == NULL) {
+                    value = error_tp(EVAL_ERROR_TOO_DEEP);
+                    have_value = true;
+                } else {
+                    call->form = se;
+                    call->next = se;
+                    call->position = 0;
+                    call->op = none_tp();
+                    call->args = NULL;
+                    tp = &se->car;
+                    continue;
+                }
+            }
+        }
+        if (value.type == TYPE_ERROR || stack.depth == 0) {
+            break;
+        }
+        switch (stack.frames[stack.depth - 1].kind) {
+            case CEK_CALL:
+                have_value = cek_resume_call(&stack, &value, &tp, &env);
+                break;
+            case CEK_COND:
+                have_value = cek_resume_cond(&stack, &value, &tp, &env);
+                break;
+            case CEK_AND_OR:
+                have_value = cek_resume_and_or(&stack, &value, &tp, &env);
+                break;
+            case CEK_RETURN:
+                cek_pop(&stack);
+                break;
+        }
+    }
+    // an error abandons whatever was left to do
+    while (stack.depth > 0) {
+        cek_pop(&stack);
+    }
+    free(stack.frames);
+    if (cek_roots == &stack) {
+        cek_roots = NULL;
     }
+    evaluations--;
+    return value;
 }
@@ -9,45 +9,106 @@
 #include "fundamentals.h"
 #include "environment.h"
 
-typed_ptr* evaluate(const typed_ptr* tp, Environment* env);
+// A tree is an expression analyzed for compilation (see analyze()): each node
+//   is a form whose shape has been checked, and whose kind says how it is to
+//   be compiled. A node refers to the expression it was built from.
+typedef enum {TREE_CONSTANT, \
+              TREE_VARIABLE, \
+              TREE_SOURCE, \
+              TREE_CALL, \
+              TREE_BUILTIN, \
+              TREE_COND, \
+              TREE_CLAUSE, \
+              TREE_AND_OR, \
+              TREE_ARITHMETIC, \
+              TREE_COMPARISON, \
+              TREE_PRIMITIVE} tree_kind;
+
+typedef struct TREE_NODE {
+    tree_kind kind;
+    const typed_ptr* source;
+    builtin_code op;
+    struct TREE_NODE** children;
+    unsigned int child_count;
+} Tree_Node;
+
+// the instructions of the virtual machine (see run_body()); in the bytecode,
+//   each opcode is followed by its operands:
+//   - a constant (the index of an expression in the pool): OP_CONSTANT,
+//     OP_LOCAL, OP_LOAD, OP_SOURCE
+//   - a constant and a builtin_code: OP_BUILTIN
+//   - a constant, a builtin_code, and a jump target: OP_GUARD
+//   - a constant and a jump target: OP_PREPARE
+//   - an argument count: OP_CALL, OP_TAIL_CALL
+//   - a jump target: OP_JUMP, OP_BRANCH_FALSE, OP_AND, OP_OR
+//   - a builtin_code and an argument count: OP_ARITHMETIC, OP_COMPARE
+//   - a builtin_code: OP_PRIMITIVE
+//   - a truth value: OP_BOOL
+typedef enum {OP_CONSTANT, \
+              OP_LOCAL, \
+              OP_LOAD, \
+              OP_SOURCE, \
+              OP_BOOL, \
+              OP_VOID, \
+              OP_GUARD, \
+              OP_BUILTIN, \
+              OP_PREPARE, \
+              OP_CALL, \
+              OP_TAIL_CALL, \
+              OP_RETURN, \
+              OP_POP, \
+              OP_JUMP, \
+              OP_BRANCH_FALSE, \
+              OP_AND, \
+              OP_OR, \
+              OP_ARITHMETIC, \
+              OP_COMPARE, \
+              OP_PRIMITIVE} opcode;
+
+typed_ptr evaluate(const typed_ptr* tp, Environment* env);
+typed_ptr evaluate_cek(const typed_ptr* tp, Environment* env);
+unsigned int cek_peak_depth(void);
 
 // evaluating different types
 
-typed_ptr* eval_builtin(const s_expr* se, Environment* env);
-typed_ptr* eval_s_expr(const s_expr* se, Environment* env);
-typed_ptr* eval_function(const s_expr* se, Environment* env);
+typed_ptr eval_builtin(const s_expr* se, Environment* env);
+typed_ptr eval_s_expr(const s_expr* se, Environment* env);
+typed_ptr eval_function(const s_expr* se, Environment* env);
 
 // evaluating built-in functions and special forms
 
-typed_ptr* eval_arithmetic(const s_expr* se, Environment* env);
-typed_ptr* eval_comparison(const s_expr* se, Environment* env);
-typed_ptr* eval_define(const s_expr* se, Environment* env);
-typed_ptr* eval_set_variable(const s_expr* se, Environment* env);
-typed_ptr* eval_exit(const s_expr* se, Environment* env);
-typed_ptr* eval_cons(const s_expr* se, Environment* env);
-typed_ptr* eval_car_cdr(const s_expr* se, Environment* env);
-typed_ptr* eval_list_construction(const s_expr* se, Environment* env);
-typed_ptr* eval_and_or(const s_expr* se, Environment* env);
-typed_ptr* eval_not(const s_expr* se, Environment* env);
-typed_ptr* eval_cond(const s_expr* se, Environment* env);
-typed_ptr* eval_list_pred(const s_expr* se, Environment* env);
-typed_ptr* eval_atom_pred(const s_expr* se, Environment* env);
-typed_ptr* eval_null_pred(const s_expr* se, Environment* env);
-typed_ptr* eval_lambda(const s_expr* se, Environment* env);
-typed_ptr* eval_quote(const s_expr* se, Environment* env);
-typed_ptr* eval_string_length(const s_expr* se, Environment* env);
-typed_ptr* eval_string_equals(const s_expr* se, Environment* env);
-typed_ptr* eval_string_append(const s_expr* se, Environment* env);
+typed_ptr eval_arithmetic(const s_expr* se, Environment* env);
+typed_ptr eval_comparison(const s_expr* se, Environment* env);
+typed_ptr eval_define(const s_expr* se, Environment* env);
+typed_ptr eval_set_variable(const s_expr* se, Environment* env);
+typed_ptr eval_exit(const s_expr* se, Environment* env);
+typed_ptr eval_cons(const s_expr* se, Environment* env);
+typed_ptr eval_car_cdr(const s_expr* se, Environment* env);
+typed_ptr eval_list_construction(const s_expr* se, Environment* env);
+typed_ptr eval_and_or(const s_expr* se, Environment* env);
+typed_ptr eval_not(const s_expr* se, Environment* env);
+typed_ptr eval_cond(const s_expr* se, Environment* env);
+typed_ptr eval_list_pred(const s_expr* se, Environment* env);
+typed_ptr eval_atom_pred(const s_expr* se, Environment* env);
+typed_ptr eval_null_pred(const s_expr* se, Environment* env);
+typed_ptr eval_lambda(const s_expr* se, Environment* env);
+typed_ptr eval_quote(const s_expr* se, Environment* env);
+typed_ptr eval_string_length(const s_expr* se, Environment* env);
+typed_ptr eval_string_equals(const s_expr* se, Environment* env);
+typed_ptr eval_string_append(const s_expr* se, Environment* env);
 
 // helper functions
 
+Tree_Node* analyze(const typed_ptr* tp, Environment* env);
+void delete_tree_node(Tree_Node* node);
+Bytecode* compile(const typed_ptr* body, Environment* env);
+
 Symbol_Node* collect_parameters(typed_ptr* tp, Environment* env);
-Symbol_Node* bind_args(Function_Node* fn, typed_ptr* args);
-Environment* make_eval_env(Environment* env, Symbol_Node* bound_args);
-typed_ptr* collect_arguments(const s_expr* se, \
-                             Environment* env, \
-                             int min_args, \
-                             int max_args, \
-                             bool evaluate_all_args);
+typed_ptr bind_args(Environment* frame, typed_ptr* args);
+typed_ptr collect_arguments(const s_expr* se, \
+                            Environment* env, \
+                            int min_args, \
+                            int max_args, \
+                            bool evaluate_all_args);
 
 #endif
@@ -1,14 +1,90 @@
 #include "fundamentals.h"
 
+// Slab allocation
+// typed_ptrs and s-expression cells are small, fixed-size, and created and
+//   destroyed constantly during evaluation, so rather than going through
+//   malloc() and free() for each one, they are carved out of large pages. Each
+//   type of object gets its own slab: cells are handed out from the newest page
+//   by bumping a pointer, and deleted cells are threaded onto a free list (the
+//   link is stored in the dead cell itself) to be reused before the page is.
+// Pages are never returned to the system; a slab only grows to the peak number
+//   of its objects live at once.
+
+#define SLAB_PAGE_CELLS 1024
+
+typedef struct SLAB_FREE_CELL {
+    struct SLAB_FREE_CELL* next;
+} Slab_Free_Cell;
+
+typedef struct SLAB_PAGE {
+    struct SLAB_PAGE* next;
+    char cells[];
+} Slab_Page;
+
+typedef struct SLAB {
+    const char* name;
+    size_t cell_size;
+    Slab_Page* pages;
+    char* bump;
+    char* bump_end;
+    Slab_Free_Cell* free_list;
+    long live;
+} Slab;
+
+static Slab typed_ptr_slab = {.name="typed_ptr", .cell_size=sizeof(typed_ptr)};
+static Slab s_expr_slab = {.name="s_expr", .cell_size=sizeof(s_expr)};
+
+static void* slab_alloc(Slab* slab) {
+    void* cell = NULL;
+    if (slab->free_list != NULL) {
+        cell = slab->free_list;
+        slab->free_list = slab->free_list->next;
+    } else {
+        if (slab->bump == slab->bump_end) {
+            size_t page_bytes = slab->cell_size * SLAB_PAGE_CELLS;
+            Slab_Page* page = malloc(sizeof(Slab_Page) + page_bytes);
+            if (page == NULL) {
+                fprintf(stderr, "malloc failed in %s slab_alloc()\n", \
+                        slab->name);
+                exit(-1);
+            }
+            page->next = slab->pages;
+            slab->pages = page;
+            slab->bump = page->cells;
+            slab->bump_end = page->cells + page_bytes;
+        }
+        cell = slab->bump;
+        slab->bump += slab->cell_size;
+    }
+    slab->live++;
+    return cell;
+}
+
+static void slab_free(Slab* slab, void* cell) {
+    if (cell == NULL) {
+        return;
+    }
+    Slab_Free_Cell* freed = cell;
+    freed->next = slab->free_list;
+    slab->free_list = freed;
+    slab->live--;
+    return;
+}
+
+long live_typed_ptr_count() {
+    return typed_ptr_slab.live;
+}
+
+long live_s_expr_count() {
+    return s_expr_slab.live;
+}
+
 // The returned typed_ptr is the caller's responsibility to free; it can be
 //   safely (shallow) freed without harm to any other object.
 typed_ptr* create_typed_ptr(type type, tp_value ptr) {
-    typed_ptr* new_tp = malloc(sizeof(typed_ptr));
-    if (new_tp == NULL) {
-        fprintf(stderr, "malloc failed in create_typed_ptr()\n");
-        exit(-1);
-    }
+    typed_ptr* new_tp = slab_alloc(&typed_ptr_slab);
     new_tp->type = type;
+    new_tp->address = 0;
     new_tp->ptr = ptr;
     return new_tp;
 }
@@ -45,21 +121,53 @@ typed_ptr* copy_typed_ptr(const typed_ptr* tp) {
     return create_typed_ptr(tp->type, tp->ptr);
 }
 
-// The s-expression returned is the caller's responsibility to free.
-s_expr* create_s_expr(typed_ptr* car, typed_ptr* cdr) {
-    s_expr* new_se = malloc(sizeof(s_expr));
-    if (new_se == NULL) {
-        fprintf(stderr, "malloc failed in create_s_expr()\n");
-        exit(-1);
-    }
+// The following functions build typed_ptrs by value, with no allocation. They
+//   are used for the cars and cdrs of s-expression cells, and for the results
+//   of evaluation.
+typed_ptr none_tp() {
+    return (typed_ptr){.type=TYPE_NONE, .ptr={.idx=0}};
+}
+
+typed_ptr atom_tp(type type, long idx) {
+    return (typed_ptr){.type=type, .ptr={.idx=idx}};
+}
+
+typed_ptr error_tp(interpreter_error err_code) {
+    return atom_tp(TYPE_ERROR, err_code);
+}
+
+typed_ptr void_tp() {
+    return atom_tp(TYPE_VOID, 0);
+}
+
+typed_ptr s_expr_tp(s_expr* se) {
+    return (typed_ptr){.type=TYPE_S_EXPR, .ptr={.se_ptr=se}};
+}
+
+typed_ptr string_tp(String* string) {
+    return (typed_ptr){.type=TYPE_STRING, .ptr={.string=string}};
+}
+
+// Deletes a single typed_ptr, without touching anything it points to.
+void delete_typed_ptr(typed_ptr* tp) {
+    slab_free(&typed_ptr_slab, tp);
+    return;
+}
+
+// The s-expression returned is the caller's responsibility to free. It takes
+//   over the values car and cdr refer to.
+s_expr* create_s_expr(typed_ptr car, typed_ptr cdr) {
+    s_expr* new_se = slab_alloc(&s_expr_slab);
     new_se->car = car;
     new_se->cdr = cdr;
+    new_se->refs = 1;
+    new_se->gc_mark = 0;
     return new_se;
 }
 
 // The s-expression returned is the caller's responsibility to free.
 s_expr* create_empty_s_expr() {
-    return create_s_expr(NULL, NULL);
+    return create_s_expr(none_tp(), none_tp());
 }
 
 s_expr* copy_s_expr(const s_expr* se) {
@@ -69,51 +177,105 @@ s_expr* copy_s_expr(const s_expr* se) {
     s_expr* new_se = create_empty_s_expr();
     s_expr* curr_se = new_se;
     while (!is_empty_list(se)) {
-        curr_se->car = copy_typed_ptr(se->car);
-        if (curr_se->car->type == TYPE_S_EXPR) {
-            curr_se->car->ptr.se_ptr = copy_s_expr(curr_se->car->ptr.se_ptr);
-        } else if (curr_se->car->type == TYPE_STRING) {
-            char* contents = curr_se->car->ptr.string->contents;
-            curr_se->car->ptr.string = create_string(contents);
+        curr_se->car = se->car;
+        if (curr_se->car.type == TYPE_S_EXPR) {
+            curr_se->car.ptr.se_ptr = copy_s_expr(curr_se->car.ptr.se_ptr);
+        } else if (curr_se->car.type == TYPE_STRING) {
+            share_string(curr_se->car.ptr.string);
         } // otherwise it's atomic and a copy of the typed_ptr is enough
-        curr_se->cdr = copy_typed_ptr(se->cdr);
-        if (curr_se->cdr->type == TYPE_S_EXPR) {
-            curr_se->cdr->ptr.se_ptr = create_empty_s_expr();
+        curr_se->cdr = se->cdr;
+        if (curr_se->cdr.type == TYPE_S_EXPR) {
+            curr_se->cdr.ptr.se_ptr = create_empty_s_expr();
             curr_se = s_expr_next(curr_se);
             se = s_expr_next(se);
         } else { // se is a pair, so we're done
+            if (curr_se->cdr.type == TYPE_STRING) {
+                share_string(curr_se->cdr.ptr.string);
+            }
             break;
         }
     }
     return new_se;
 }
 
+// Adds an owner to the s-expression se, which is returned. The list is not
+//   copied, so this is O(1); the new owner must let go of it with
+//   delete_s_expr_recursive() like any other s-expression.
+s_expr* share_s_expr(s_expr* se) {
+    if (se != NULL) {
+        se->refs++;
+    }
+    return se;
+}
+
+// Returns a copy of the value tp points to that the caller owns independently
+//   of tp: atoms are simply copied, while s-expressions and strings are
+//   shared. Either way this is O(1).
+typed_ptr share_value(const typed_ptr* tp) {
+    typed_ptr value = *tp;
+    if (value.type == TYPE_S_EXPR) {
+        share_s_expr(value.ptr.se_ptr);
+    } else if (value.type == TYPE_STRING) {
+        share_string(value.ptr.string);
+    }
+    return value;
+}
+
+// Gives up one reference to the s-expression se. Only once a cell has no other
+//   owners is it actually deleted, along with its car (if it's a string, or if
+//   it's an s-expression and delete_s_expr_cars is set) and its reference to
+//   the next cell in the list.
+// A cell that is still shared keeps the rest of its list alive, so the walk
+//   stops there.
+// Lists can nest as deeply as they are long, so cars are not recursed into
+//   either: a dead cell whose car is a list to delete first is kept on a stack
+//   linked through its car, still holding the rest of its own list in its cdr,
+//   and freed once it is popped (as in delete_string()).
 void delete_s_expr_recursive(s_expr* se, bool delete_s_expr_cars) {
+    s_expr* pending = NULL;
     s_expr* curr = se;
-    while (curr != NULL) {
-        if (delete_s_expr_cars && \
-            curr->car != NULL && \
-            curr->car->type == TYPE_S_EXPR) {
-            delete_s_expr_recursive(curr->car->ptr.se_ptr, true);
-        } else if (curr->car != NULL && curr->car->type == TYPE_STRING) {
-            delete_string(curr->car->ptr.string);
-        }
-        free(curr->car);
-        if (curr->cdr != NULL && curr->cdr->type == TYPE_S_EXPR) {
-            se = s_expr_next(curr);
-        } else {
-            if (curr->cdr != NULL && curr->cdr->type == TYPE_STRING) {
-                delete_string(curr->cdr->ptr.string);
+    while (true) {
+        while (curr != NULL && --curr->refs == 0) {
+            s_expr* next = NULL;
+            if (curr->cdr.type == TYPE_S_EXPR) {
+                next = s_expr_next(curr);
+            } else if (curr->cdr.type == TYPE_STRING) {
+                delete_string(curr->cdr.ptr.string);
             }
-            se = NULL;
+            if (delete_s_expr_cars && curr->car.type == TYPE_S_EXPR) {
+                s_expr* car = curr->car.ptr.se_ptr;
+                if (next != NULL) {
+                    curr->car.ptr.se_ptr = pending;
+                    pending = curr;
+                } else {
+                    delete_s_expr(curr);
+                }
+                curr = car;
+                continue;
+            } else if (curr->car.type == TYPE_STRING) {
+                delete_string(curr->car.ptr.string);
+            }
+            delete_s_expr(curr);
+            curr = next;
+        }
+        if (pending == NULL) {
+            break;
         }
-        free(curr->cdr);
-        free(curr);
-        curr = se;
+        curr = s_expr_next(pending);
+        s_expr* next_pending = pending->car.ptr.se_ptr;
+        delete_s_expr(pending);
+        pending = next_pending;
     }
     return;
 }
 
+// Deletes a single s-expression cell, without touching anything its car or cdr
+//   point to.
+void delete_s_expr(s_expr* se) {
+    slab_free(&s_expr_slab, se);
+    return;
+}
+
 String* create_string(char* contents) {
     String* new_str = malloc(sizeof(String));
     if (new_str == NULL) {
@@ -127,17 +289,139 @@ String* create_string(char* contents) {
         exit(-1);
     }
     memcpy(new_str->contents, contents, sizeof(char) * (new_str->len + 1));
+    new_str->left = NULL;
+    new_str->right = NULL;
+    new_str->refs = 1;
+    return new_str;
+}
+
+// Concatenates two strings in O(1), by building a rope node over them rather
+//   than copying their characters.
+// The rope takes over the caller's references to left and right.
+String* create_rope(String* left, String* right) {
+    String* new_str = malloc(sizeof(String));
+    if (new_str == NULL) {
+        fprintf(stderr, "malloc failed in create_rope()\n");
+        exit(-1);
+    }
+    new_str->len = left->len + right->len;
+    new_str->contents = NULL;
+    new_str->left = left;
+    new_str->right = right;
+    new_str->refs = 1;
     return new_str;
 }
 
+// Copies the characters of str into buffer, which must have room for them.
+// Ropes can be any depth (repeated appending leans them to the left, repeated
+//   prepending to the right), so the walk keeps its own stack of left children
+//   still to be copied rather than recursing; the buffer is filled from the
+//   back.
+static void copy_string_contents(const String* str, char* buffer) {
+    char* end = buffer + str->len;
+    const String** pending = NULL;
+    unsigned int pending_count = 0;
+    unsigned int pending_capacity = 0;
+    while (true) {
+        while (str->contents == NULL) {
+            if (pending_count == pending_capacity) {
+                pending_capacity = (pending_capacity == 0) ? \
+                                   16 : pending_capacity * 2;
+                pending = realloc(pending, \
+                                  sizeof(const String*) * pending_capacity);
+                if (pending == NULL) {
+                    fprintf(stderr, \
+                            "malloc failed in copy_string_contents()\n");
+                    exit(-1);
+                }
+            }
+            pending[pending_count++] = str->left;
+            str = str->right;
+        }
+        end -= str->len;
+        memcpy(end, str->contents, sizeof(char) * str->len);
+        if (pending_count == 0) {
+            break;
+        }
+        str = pending[--pending_count];
+    }
+    free(pending);
+    return;
+}
+
+// Returns the null-terminated characters of str, which must not be modified.
+// A rope is flattened the first time this is called on it, and lets go of its
+//   children; any other owners of the string see the flattened version too.
+char* string_contents(String* str) {
+    if (str->contents == NULL) {
+        char* contents = malloc(sizeof(char) * (str->len + 1));
+        if (contents == NULL) {
+            fprintf(stderr, "malloc failed in string_contents()\n");
+            exit(-1);
+        }
+        copy_string_contents(str, contents);
+        contents[str->len] = '\0';
+        delete_string(str->left);
+        delete_string(str->right);
+        str->contents = contents;
+        str->left = NULL;
+        str->right = NULL;
+    }
+    return str->contents;
+}
+
+// Adds an owner to the string str, which is returned; the contents are not
+//   copied. The new owner must let go of it with delete_string().
+String* share_string(String* str) {
+    str->refs++;
+    return str;
+}
+
+// Copy-on-write for string mutation: gives up the caller's reference to str,
+//   and returns a string with the same contents that the caller is the only
+//   owner of, and so may safely modify. That is str itself if nobody else
+//   shares it, and a fresh copy otherwise.
+String* unshare_string(String* str) {
+    if (str->refs == 1) {
+        return str;
+    }
+    String* copy = create_string(string_contents(str));
+    delete_string(str);
+    return copy;
+}
+
+// Gives up one reference to the string str, deleting it once it has no other
+//   owners; a rope then gives up its references to its children in turn.
+// This doesn't recurse, however deep the rope: a dead rope node whose right
+//   child is still to be let go of is kept on a stack linked through its left
+//   field, and freed once it is popped.
 void delete_string(String* str) {
-    free(str->contents);
-    free(str);
+    String* pending = NULL;
+    while (true) {
+        while (str != NULL && --str->refs == 0) {
+            String* left = str->left;
+            free(str->contents);
+            if (str->right != NULL) {
+                str->left = pending;
+                pending = str;
+            } else {
+                free(str);
+            }
+            str = left;
+        }
+        if (pending == NULL) {
+            break;
+        }
+        str = pending->right;
+        String* next = pending->left;
+        free(pending);
+        pending = next;
+    }
     return;
 }
 
 s_expr* s_expr_next(const s_expr* se) {
-    return se->cdr->ptr.se_ptr;
+    return se->cdr.ptr.se_ptr;
 }
 
 bool is_empty_list(const s_expr* se) {
@@ -145,7 +429,7 @@ bool is_empty_list(const s_expr* se) {
         printf("cannot determine if NULL se is empty list\n");
         exit(-1);
     } else {
-        return (se->car == NULL && se->cdr == NULL);
+        return (se->car.type == TYPE_NONE && se->cdr.type == TYPE_NONE);
     }
 }
 
@@ -158,11 +442,11 @@ bool is_pair(const s_expr* se) {
         printf("cannot determine pair-ness of NULL s-expression\n");
         exit(-1);
     }
-    if (se->car == NULL && se->cdr == NULL) {
+    if (se->car.type == TYPE_NONE && se->cdr.type == TYPE_NONE) {
         return false;
-    } else if (se->cdr == NULL) {
-        printf("malformed s-expression: only cdr is NULL\n");
+    } else if (se->cdr.type == TYPE_NONE) {
+        printf("malformed s-expression: only cdr is empty\n");
         exit(-1);
     }
-    return se->cdr->type != TYPE_S_EXPR;
+    return se->cdr.type != TYPE_S_EXPR;
 }
@@ -17,7 +17,10 @@ typedef enum {TYPE_UNDEF, \
               TYPE_S_EXPR, \
               TYPE_SYMBOL, \
               TYPE_FUNCTION, \
-              TYPE_STRING} type;
+              TYPE_STRING, \
+              // marks an unoccupied car or cdr in an s-expression cell (the
+              //   empty list has neither); never the type of a value
+              TYPE_NONE} type;
 
 // built-in functions and special forms
 
@@ -56,6 +59,9 @@ typedef enum {BUILTIN_ADD, \
               BUILTIN_STRINGEQ, \
               BUILTIN_STRINGAPPEND} builtin_code;
 
+// keep in step with the last builtin_code above
+#define NUM_BUILTINS (BUILTIN_STRINGAPPEND + 1)
+
 // error codes
 
 typedef enum {TEST_ERROR_DUMMY, \
@@ -93,7 +99,8 @@ typedef enum {TEST_ERROR_DUMMY, \
               EVAL_ERROR_CAR_NOT_CALLABLE, \
               EVAL_ERROR_MISSING_PROCEDURE, \
               EVAL_ERROR_BAD_SYNTAX, \
-              EVAL_ERROR_BAD_SYMBOL} interpreter_error;
+              EVAL_ERROR_BAD_SYMBOL, \
+              EVAL_ERROR_TOO_DEEP} interpreter_error;
 
 // s-expressions & typed pointers
 
@@ -106,19 +113,45 @@ typedef union TP_VALUE {
     struct STRING* string;
 } tp_value;
 
+// A symbol that is a variable reference inside a lambda body may carry the
+//   lexical address it was resolved to (see resolve_references()), or else 0.
+//   The address sits in what would otherwise be padding, and is not part of
+//   the symbol's value: it is ignored everywhere but in variable lookup, so
+//   setting it does not change the (otherwise immutable) cell that holds the
+//   symbol.
 typedef struct TYPED_PTR {
     type type;
+    unsigned int address;
     tp_value ptr;
 } typed_ptr;
 
+// s-expression cells are immutable once built, and may be shared by any number
+//   of owners (symbol table entries, function bodies, other cells, evaluation
+//   results). refs counts those owners; a cell is only deleted once its last
+//   owner lets go of it.
+// gc_mark lets the environment collector (see collect_garbage()) visit each
+//   shared cell only once per collection.
+// The car and cdr are stored in the cell itself, so a cell is a single
+//   allocation and walking a list touches one object per element.
 typedef struct S_EXPR {
-    typed_ptr* car;
-    typed_ptr* cdr;
+    typed_ptr car;
+    typed_ptr cdr;
+    int refs;
+    unsigned int gc_mark;
 } s_expr;
 
+// Strings are immutable as well, and shared the same way as s-expression cells:
+//   refs counts their owners. Anything that wants to change a string's
+//   contents must first get a copy of its own (see unshare_string()).
+// A string is either flat, with its characters in contents, or a rope: the
+//   concatenation of the strings left and right, with contents NULL until
+//   something needs them contiguous (see string_contents()).
 typedef struct STRING {
     long len;
     char* contents;
+    struct STRING* left;
+    struct STRING* right;
+    long refs;
 } String;
 
 typed_ptr* create_typed_ptr(type type, tp_value ptr);
@@ -128,13 +161,31 @@ typed_ptr* create_void_tp();
 typed_ptr* create_s_expr_tp(s_expr* se);
 typed_ptr* create_string_tp(String* string);
 typed_ptr* copy_typed_ptr(const typed_ptr* tp);
+void delete_typed_ptr(typed_ptr* tp);
+
+typed_ptr none_tp();
+typed_ptr atom_tp(type type, long idx);
+typed_ptr error_tp(interpreter_error err_code);
+typed_ptr void_tp();
+typed_ptr s_expr_tp(s_expr* se);
+typed_ptr string_tp(String* string);
 
-s_expr* create_s_expr(typed_ptr* car, typed_ptr* cdr);
+s_expr* create_s_expr(typed_ptr car, typed_ptr cdr);
 s_expr* create_empty_s_expr();
 s_expr* copy_s_expr(const s_expr* se);
+s_expr* share_s_expr(s_expr* se);
+typed_ptr share_value(const typed_ptr* tp);
 void delete_s_expr_recursive(s_expr* se, bool delete_s_expr_cars);
+void delete_s_expr(s_expr* se);
+
+long live_typed_ptr_count();
+long live_s_expr_count();
 
 String* create_string(char* contents);
+String* create_rope(String* left, String* right);
+char* string_contents(String* str);
+String* share_string(String* str);
+String* unshare_string(String* str);
 void delete_string(String* str);
 
 s_expr* s_expr_next(const s_expr* se);
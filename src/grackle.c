@@ -6,7 +6,13 @@
 
 #define PROMPT ">>>"
 
-int main() {
+// Run as "grackle --cek" to evaluate with the heap-continuation evaluator (see
+//   evaluate_cek()), which recursion can only exhaust with an error.
+int main(int argc, char* argv[]) {
+    typed_ptr (*evaluator)(const typed_ptr*, Environment*) = evaluate;
+    if (argc > 1 && !strcmp(argv[1], "--cek")) {
+        evaluator = evaluate_cek;
+    }
     bool exit = false;
     char* input = NULL;
     Environment* env = create_environment(0, 0, NULL);
@@ -21,31 +27,30 @@ int main() {
                    !is_empty_list(parse_output->ptr.se_ptr)) {
             for (s_expr* term = parse_output->ptr.se_ptr; \
                  !is_empty_list(term); \
-                 term = term->cdr->ptr.se_ptr) {
-                typed_ptr* eval_output = evaluate(term->car, env);
-                print_typed_ptr(eval_output, env);
+                 term = s_expr_next(term)) {
+                typed_ptr eval_output = evaluator(&term->car, env);
+                print_typed_ptr(&eval_output, env);
                 printf("\n");
-                if (eval_output->type == TYPE_ERROR && \
-                    eval_output->ptr.idx == EVAL_ERROR_EXIT) {
+                if (eval_output.type == TYPE_ERROR && \
+                    eval_output.ptr.idx == EVAL_ERROR_EXIT) {
                     exit = true;
                 }
-                if (eval_output->type == TYPE_S_EXPR) {
-                    delete_s_expr_recursive(eval_output->ptr.se_ptr, true);
-                } else if (eval_output->type == TYPE_STRING) {
-                    delete_string(eval_output->ptr.string);
+                if (eval_output.type == TYPE_S_EXPR) {
+                    delete_s_expr_recursive(eval_output.ptr.se_ptr, true);
+                } else if (eval_output.type == TYPE_STRING) {
+                    delete_string(eval_output.ptr.string);
                 }
-                if (eval_output->type == TYPE_ERROR) {
-                    free(eval_output);
+                if (eval_output.type == TYPE_ERROR) {
                     break;
                 }
-                free(eval_output);
             }
         }
         if (parse_output->type == TYPE_S_EXPR) {
             delete_s_expr_recursive(parse_output->ptr.se_ptr, true);
         }
-        free(parse_output);
+        delete_typed_ptr(parse_output);
         free(input);
+        collect_garbage(env);
     }
     delete_environment(env);
     return 0;
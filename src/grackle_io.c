@@ -74,7 +74,7 @@ void print_typed_ptr(const typed_ptr* tp, const Environment* env) {
             break;
         }
         case TYPE_STRING:
-            printf("\"%s\"", tp->ptr.string->contents);
+            printf("\"%s\"", string_contents(tp->ptr.string));
             break;
         default:
             printf("unrecognized type: %d", tp->type);
@@ -188,6 +188,9 @@ void print_error(const typed_ptr* tp) {
         case EVAL_ERROR_BAD_SYMBOL:
             printf("evaluation: symbol not in symbol table");
             break;
+        case EVAL_ERROR_TOO_DEEP:
+            printf("evaluation: recursion too deep");
+            break;
         default:
             printf("unknown error: error code %ld", tp->ptr.idx);
             break;
@@ -199,20 +202,20 @@ void print_s_expr(const s_expr* se, const Environment* env) {
     if (se == NULL) {
         typed_ptr* err = create_error_tp(EVAL_ERROR_NULL_S_EXPR);
         print_error(err);
-        free(err);
+        delete_typed_ptr(err);
         return;
     }
     printf("'(");
     while (!is_empty_list(se)) {
-        print_typed_ptr(se->car, env);
-        if (se->cdr->type == TYPE_S_EXPR) { // list
-            se = se->cdr->ptr.se_ptr;
+        print_typed_ptr(&se->car, env);
+        if (se->cdr.type == TYPE_S_EXPR) { // list
+            se = se->cdr.ptr.se_ptr;
             if (!is_empty_list(se)) {
                 printf(" ");
             }
         } else { // pair
             printf(" . ");
-            print_typed_ptr(se->cdr, env);
+            print_typed_ptr(&se->cdr, env);
             break;
         }
     }
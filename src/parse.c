@@ -20,9 +20,9 @@ typed_ptr* parse(const char str[], Environment* env) {
     unsigned int string_start = 0;
     char* new_symbol = NULL;
     char* new_string = NULL;
-    Environment* temp_env = create_environment(env->symbol_table->length, \
-                                               env->function_table->length, \
-                                               NULL);
+    // new symbols go straight into the symbol table, and are taken out again
+    //   if the parse fails
+    unsigned int symbols_before = env->symbol_table->length;
     s_expr* head = create_empty_s_expr();
     s_expr_stack_push(&stack, head);
     while (str[curr] && state != PARSE_ERROR) {
@@ -99,7 +99,7 @@ typed_ptr* parse(const char str[], Environment* env) {
                     str[curr] == ')' || \
                     str[curr] == '"') {
                     new_symbol = substring(str, symbol_start, curr);
-                    error = register_symbol(&stack, env, temp_env, new_symbol);
+                    error = register_symbol(&stack, env, new_symbol);
                     free(new_symbol);
                     new_symbol = NULL;
                     if (error != PARSE_ERROR_NONE) {
@@ -132,7 +132,7 @@ typed_ptr* parse(const char str[], Environment* env) {
                 switch (str[curr]) {
                     case '"':
                         new_string = substring(str, string_start + 1, curr);
-                        stack->se->car = create_string_tp(create_string(new_string));
+                        stack->se->car = string_tp(create_string(new_string));
                         free(new_string);
                         new_string = NULL;
                         state = PARSE_READY;
@@ -173,7 +173,7 @@ typed_ptr* parse(const char str[], Environment* env) {
     }
     if (state == PARSE_READ_SYMBOL && stack != NULL) {
         new_symbol = substring(str, symbol_start, curr);
-        error = register_symbol(&stack, env, temp_env, new_symbol);
+        error = register_symbol(&stack, env, new_symbol);
         free(new_symbol);
         new_symbol = NULL;
         if (error != PARSE_ERROR_NONE) {
@@ -190,9 +190,8 @@ typed_ptr* parse(const char str[], Environment* env) {
         state = PARSE_ERROR;
         error = PARSE_ERROR_UNBAL_PAREN;
     }
-    if (state != PARSE_ERROR) {
-        merge_symbol_tables(env->symbol_table, temp_env->symbol_table);
-    } else {
+    if (state == PARSE_ERROR) {
+        truncate_symbol_table(env->symbol_table, symbols_before);
         while (stack != NULL) {
             s_expr_stack* stack_temp = stack;
             stack = stack->next;
@@ -201,33 +200,32 @@ typed_ptr* parse(const char str[], Environment* env) {
         }
         delete_s_expr_recursive(head, true);
     }
-    delete_environment(temp_env);
     return (state == PARSE_ERROR) ? create_error_tp(error) : \
                                     create_s_expr_tp(head);
 }
 
 void init_new_s_expr(s_expr_stack** stack) {
     s_expr_stack_push(stack, create_empty_s_expr());
-    (*stack)->next->se->car = create_s_expr_tp((*stack)->se);
+    (*stack)->next->se->car = s_expr_tp((*stack)->se);
     return;
 }
 
 void extend_s_expr(s_expr_stack** stack) {
     s_expr_stack_push(stack, create_empty_s_expr());
-    (*stack)->next->se->cdr = create_s_expr_tp((*stack)->se);
+    (*stack)->next->se->cdr = s_expr_tp((*stack)->se);
     return;
 }
 
 Parse_State terminate_s_expr(s_expr_stack** stack, interpreter_error* error) {
-    if (*stack == NULL || (*stack)->se->cdr != NULL) {
+    if (*stack == NULL || (*stack)->se->cdr.type != TYPE_NONE) {
         *error = PARSE_ERROR_UNBAL_PAREN;
         return PARSE_ERROR;
     } else {
         if (!is_empty_list((*stack)->se)) {
-            (*stack)->se->cdr = create_s_expr_tp(create_empty_s_expr());
+            (*stack)->se->cdr = s_expr_tp(create_empty_s_expr());
         }
         s_expr_stack_pop(stack);
-        while (*stack != NULL && (*stack)->se->cdr != NULL) {
+        while (*stack != NULL && (*stack)->se->cdr.type != TYPE_NONE) {
             s_expr_stack_pop(stack);
         }
         return (*stack == NULL) ? PARSE_FINISH : PARSE_READY;
@@ -236,9 +234,8 @@ Parse_State terminate_s_expr(s_expr_stack** stack, interpreter_error* error) {
 
 interpreter_error register_symbol(s_expr_stack** stack, \
                                   Environment* env, \
-                                  Environment* temp_env, \
                                   char* name) {
-    typed_ptr* tp = NULL;
+    typed_ptr tp;
     if (string_is_number(name)) {
         errno = 0;
         long value = strtol(name, NULL, 10);
@@ -249,18 +246,19 @@ interpreter_error register_symbol(s_expr_stack** stack, \
         } else if (value == LONG_MAX && errno == ERANGE) {
             return PARSE_ERROR_INT_TOO_HIGH;
         } else {
-            tp = create_atom_tp(TYPE_FIXNUM, value);
+            tp = atom_tp(TYPE_FIXNUM, value);
         }
     } else if (string_is_boolean_literal(name)) {
-        tp = create_atom_tp(TYPE_BOOL, (!strcmp(name, "#t")) ? true : false);
+        tp = atom_tp(TYPE_BOOL, (!strcmp(name, "#t")) ? true : false);
     } else {
         Symbol_Node* found = symbol_lookup_name(env, name);
-        found = (found == NULL) ? symbol_lookup_name(temp_env, name) : found;
         if (found == NULL) {
             typed_ptr undef_tp = {.type=TYPE_UNDEF, .ptr={.idx=0}};
-            tp = install_symbol(temp_env, name, &undef_tp);
+            typed_ptr* installed = install_symbol(env, name, &undef_tp);
+            tp = *installed;
+            delete_typed_ptr(installed);
         } else {
-            tp = create_atom_tp(TYPE_SYMBOL, found->symbol_idx);
+            tp = atom_tp(TYPE_SYMBOL, found->symbol_idx);
         }
     }
     (*stack)->se->car = tp;
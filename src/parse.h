@@ -36,7 +36,6 @@ void extend_s_expr(s_expr_stack** stack);
 Parse_State terminate_s_expr(s_expr_stack** stack, interpreter_error* error);
 interpreter_error register_symbol(s_expr_stack** stack, \
                                   Environment* env, \
-                                  Environment* temp_env, \
                                   char* name);
 char* substring(const char* str, unsigned int start, unsigned int end);
 bool string_is_number(const char str[]);
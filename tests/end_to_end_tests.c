@@ -14,7 +14,7 @@ void e2e_atom_test(char cmd[], type t, long val, test_env* te) {
     typed_ptr* expected = create_atom_tp(t, val);
     bool pass;
     if (output->type == TYPE_S_EXPR) {
-        pass = match_typed_ptrs(output->ptr.se_ptr->car, expected);
+        pass = match_typed_ptrs(&output->ptr.se_ptr->car, expected);
     } else {
         pass = match_typed_ptrs(output, expected);
     }
@@ -23,8 +23,8 @@ void e2e_atom_test(char cmd[], type t, long val, test_env* te) {
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
-    free(expected);
+    delete_typed_ptr(output);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -34,10 +34,10 @@ void e2e_atom_test(char cmd[], type t, long val, test_env* te) {
 void e2e_pair_test(char cmd[], typed_ptr* car, typed_ptr* cdr, test_env* te) {
     printf("test command: %-40s", cmd);
     typed_ptr* output = parse_and_evaluate(cmd, te->env);
-    typed_ptr* expected = create_s_expr_tp(create_s_expr(car, cdr));
+    typed_ptr* expected = create_s_expr_tp(create_s_expr(*car, *cdr));
     bool pass;
     if (output->type == TYPE_S_EXPR) {
-        pass = deep_match_typed_ptrs(output->ptr.se_ptr->car, expected);
+        pass = deep_match_typed_ptrs(&output->ptr.se_ptr->car, expected);
     } else {
         pass = deep_match_typed_ptrs(output, expected);
     }
@@ -46,9 +46,9 @@ void e2e_pair_test(char cmd[], typed_ptr* car, typed_ptr* cdr, test_env* te) {
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
-    free(expected->ptr.se_ptr);
-    free(expected);
+    delete_typed_ptr(output);
+    delete_s_expr(expected->ptr.se_ptr);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -67,7 +67,7 @@ void e2e_s_expr_test(char cmd[], \
     }
     bool pass;
     if (output->type == TYPE_S_EXPR) {
-        pass = deep_match_typed_ptrs(output->ptr.se_ptr->car, expected);
+        pass = deep_match_typed_ptrs(&output->ptr.se_ptr->car, expected);
     } else {
         pass = deep_match_typed_ptrs(output, expected);
     }
@@ -76,9 +76,9 @@ void e2e_s_expr_test(char cmd[], \
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
+    delete_typed_ptr(output);
     delete_s_expr_recursive(expected->ptr.se_ptr, false);
-    free(expected);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -97,14 +97,14 @@ void e2e_multiline_atom_test(char* cmds[], \
         if (output->type == TYPE_S_EXPR) {
             delete_s_expr_recursive(output->ptr.se_ptr, true);
         }
-        free(output);
+        delete_typed_ptr(output);
         printf("              %-40s", cmds[i]);
         output = parse_and_evaluate(cmds[i], te->env);
     }
     typed_ptr* expected = create_atom_tp(t, val);
     bool pass;
     if (output->type == TYPE_S_EXPR) {
-        pass = match_typed_ptrs(output->ptr.se_ptr->car, expected);
+        pass = match_typed_ptrs(&output->ptr.se_ptr->car, expected);
     } else {
         pass = match_typed_ptrs(output, expected);
     }
@@ -113,8 +113,8 @@ void e2e_multiline_atom_test(char* cmds[], \
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
-    free(expected);
+    delete_typed_ptr(output);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -127,7 +127,7 @@ void e2e_string_test(char cmd[], char expected_str[], test_env* te) {
     typed_ptr* expected = create_string_tp(create_string(expected_str));
     bool pass;
     if (output->type == TYPE_S_EXPR) {
-        pass = match_typed_ptrs(output->ptr.se_ptr->car, expected);
+        pass = match_typed_ptrs(&output->ptr.se_ptr->car, expected);
     } else {
         pass = match_typed_ptrs(output, expected);
     }
@@ -136,9 +136,9 @@ void e2e_string_test(char cmd[], char expected_str[], test_env* te) {
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
+    delete_typed_ptr(output);
     delete_string(expected->ptr.string);
-    free(expected);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -166,9 +166,9 @@ void e2e_multi_output_atom_test(char cmd[], \
     } else if (output->type == TYPE_STRING) {
         delete_string(output->ptr.string);
     }
-    free(output);
+    delete_typed_ptr(output);
     delete_s_expr_recursive(expected->ptr.se_ptr, false);
-    free(expected);
+    delete_typed_ptr(expected);
     printf("%s\n", (pass) ? "PASSED" : "FAILED <=");
     te->passed += (pass) ? 1 : 0;
     te->run++;
@@ -201,6 +201,7 @@ void end_to_end_arithmetic_tests(test_env* t_env) {
     e2e_atom_test("(+)", TYPE_FIXNUM, 0, t_env);
     e2e_atom_test("(+ 1 #t)", TYPE_ERROR, EVAL_ERROR_NEED_NUM, t_env);
     e2e_atom_test("(+ 1 (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
+    e2e_atom_test("(+ #t (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
     printf("## - ##\n");
     e2e_atom_test("(- 10 1 2 3)", TYPE_FIXNUM, 4, t_env);
     e2e_atom_test("(- 10 1)", TYPE_FIXNUM, 9, t_env);
@@ -245,6 +246,8 @@ void end_to_end_numerical_comparison_tests(test_env* t_env) {
     e2e_atom_test("(<)", TYPE_ERROR, EVAL_ERROR_FEW_ARGS, t_env);
     e2e_atom_test("(< 1 #t)", TYPE_ERROR, EVAL_ERROR_NEED_NUM, t_env);
     e2e_atom_test("(< 1 (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
+    e2e_atom_test("(< 2 1 #t)", TYPE_BOOL, false, t_env);
+    e2e_atom_test("(< 2 1 (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
     printf("## > ##\n");
     e2e_atom_test("(> 2 1)", TYPE_BOOL, true, t_env);
     e2e_atom_test("(> 3 2 1)", TYPE_BOOL, true, t_env);
@@ -461,6 +464,11 @@ void end_to_end_car_cdr_tests(test_env* t_env) {
     e2e_atom_test("(cdr null)", TYPE_ERROR, EVAL_ERROR_BAD_ARG_TYPE, t_env);
     e2e_atom_test("(car (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
     e2e_atom_test("(cdr (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
+    char* def_shared_list = "(define shared (list 1 2 3))";
+    char* shared_cdr = "(cdr shared)";
+    char* shared_car = "(car shared)";
+    char* shared_lines[] = {def_shared_list, shared_cdr, shared_car};
+    e2e_multiline_atom_test(shared_lines, 3, TYPE_FIXNUM, 1, t_env);
     return;
 }
 
@@ -496,8 +504,8 @@ void end_to_end_cons_tests(test_env* t_env) {
     e2e_atom_test("(cons 1 2 3)", TYPE_ERROR, EVAL_ERROR_MANY_ARGS, t_env);
     e2e_atom_test("(cons (/ 0) 2)", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
     e2e_atom_test("(cons 1 (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
-    free(num_1);
-    free(num_2);
+    delete_typed_ptr(num_1);
+    delete_typed_ptr(num_2);
     return;
 }
 
@@ -511,8 +519,8 @@ void end_to_end_list_tests(test_env* t_env) {
     e2e_s_expr_test("(list (- 3 2) (+ 1 1))", list_test_num_pair, 2, t_env);
     e2e_atom_test("(list (/ 0) 2 3)", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
     e2e_atom_test("(list 1 (/ 0) 3)", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
-    free(num_1);
-    free(num_2);
+    delete_typed_ptr(num_1);
+    delete_typed_ptr(num_2);
     return;
 }
 
@@ -705,12 +713,12 @@ void end_to_end_quote_tests(test_env* t_env) {
     typed_ptr* zero = create_number_tp(0);
     typed_ptr* div_zero_list[] = {divide_sym, zero};
     e2e_s_expr_test("(quote (/ 0))", div_zero_list, 2, t_env);
-    free(one);
-    free(two);
-    free(x_sym);
-    free(add_sym);
-    free(divide_sym);
-    free(zero);
+    delete_typed_ptr(one);
+    delete_typed_ptr(two);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(add_sym);
+    delete_typed_ptr(divide_sym);
+    delete_typed_ptr(zero);
     return;
 }
 
@@ -749,6 +757,32 @@ void end_to_end_string_append_tests(test_env* t_env) {
     e2e_string_test("(string-append \"he\" \"\" \"llo\")", "hello", t_env);
     e2e_atom_test("(string-append 1)", err_t, EVAL_ERROR_BAD_ARG_TYPE, t_env);
     e2e_atom_test("(string-append (/ 0))", err_t, EVAL_ERROR_DIV_ZERO, t_env);
+    // long results are ropes, but behave like any other string
+    char def_s[] = "(define s \"abcdefghijklmnopqrstuvwxyz0123456789\")";
+    char append_s[] = "(set! s (string-append s s \"!\" s))";
+    char s_length[] = "(string-length s)";
+    char* rope_length_lines[] = {def_s, append_s, append_s, s_length};
+    e2e_multiline_atom_test(rope_length_lines, 4, TYPE_FIXNUM, 328, t_env);
+    char def_flat[] = "(define t \"abcdefghijklmnopqrstuvwxyz0123456789" \
+                      "abcdefghijklmnopqrstuvwxyz0123456789\")";
+    char def_half[] = "(define u \"abcdefghijklmnopqrstuvwxyz0123456789\")";
+    char compare[] = "(string=? t (string-append u u) " \
+                     "(string-append u \"\" u))";
+    char* rope_equals_lines[] = {def_flat, def_half, compare};
+    e2e_multiline_atom_test(rope_equals_lines, 3, TYPE_BOOL, true, t_env);
+    // prepending over and over leans a rope the other way, as deep as it is
+    //   long, which is flattened and deleted all the same
+    char def_prepend[] = "(define (prepend n) (cond ((= n 0) s) " \
+                         "(else (set! s (string-append \"ab\" s)) " \
+                         "(prepend (- n 1)))))";
+    char call_prepend[] = "(string-length (prepend 1000000))";
+    char* prepend_lines[] = {def_s, def_prepend, call_prepend};
+    e2e_multiline_atom_test(prepend_lines, 3, TYPE_FIXNUM, 2000036, t_env);
+    char self_compare[] = "(string=? s s)";
+    char* prepend_compare_lines[] = {def_s, call_prepend, self_compare};
+    e2e_multiline_atom_test(prepend_compare_lines, 3, TYPE_BOOL, true, t_env);
+    char* prepend_rebind_lines[] = {call_prepend, def_s, s_length};
+    e2e_multiline_atom_test(prepend_rebind_lines, 3, TYPE_FIXNUM, 36, t_env);
     return;
 }
 
@@ -779,5 +813,375 @@ void end_to_end_scoping_tests(test_env* t_env) {
     char* mutate_a_shadow[] = {define_a_one, scope_mutate_param_a, call_j};
     e2e_multiline_atom_test(mutate_a_shadow, 3, TYPE_FIXNUM, 2, t_env);
     e2e_atom_test("a", TYPE_FIXNUM, 1, t_env);
+    // a closure keeps its environment alive across collections
+    char def_adder[] = "(define (make-adder n) (lambda (x) (+ x n)))";
+    char def_add_five[] = "(define add-five (make-adder 5))";
+    char discard_adder[] = "((make-adder 7) 1)";
+    char call_add_five[] = "(add-five 1)";
+    char* closure_lines[] = {def_adder, \
+                             def_add_five, \
+                             discard_adder, \
+                             call_add_five};
+    e2e_multiline_atom_test(closure_lines, 4, TYPE_FIXNUM, 6, t_env);
+    // a closure stored into an old environment by set! survives
+    char def_holder_maker[] = "(define (make-holder h) (lambda (v) " \
+                              "(cond (#t (define o h) (set! h v) o))))";
+    char def_holder[] = "(define holder (make-holder 0))";
+    char store_in_holder[] = "(holder (lambda (x) (+ x 1)))";
+    char unrelated[] = "(+ 1 1)";
+    char call_stored[] = "((holder 0) 5)";
+    char* holder_lines[] = {def_holder_maker, \
+                            def_holder, \
+                            store_in_holder, \
+                            unrelated, \
+                            call_stored};
+    e2e_multiline_atom_test(holder_lines, 5, TYPE_FIXNUM, 6, t_env);
+    // closures chained as long as the program likes, and lists nested as
+    //   deeply, are traced and freed without recursing on the C stack
+    char def_chain[] = "(define (chain n f) (cond ((= n 0) f) " \
+                       "(else (chain (- n 1) (lambda () (+ 1 (f)))))))";
+    char def_chained[] = "(define chained (chain 100000 (lambda () 0)))";
+    char call_chained[] = "(chained)";
+    char* chain_lines[] = {def_chain, def_chained, unrelated, call_chained};
+    e2e_multiline_atom_test(chain_lines, 4, TYPE_FIXNUM, 100000, t_env);
+    char def_wrap[] = "(define (wrap n acc) (cond ((= n 0) acc) " \
+                      "(else (wrap (- n 1) (list acc)))))";
+    char def_wrapped[] = "(define wrapped (wrap 300000 (quote ())))";
+    char drop_chained[] = "(define chained 0)";
+    char drop_wrapped[] = "(define wrapped 0)";
+    char* wrap_lines[] = {def_wrap, \
+                          def_wrapped, \
+                          unrelated, \
+                          drop_chained, \
+                          drop_wrapped, \
+                          unrelated};
+    e2e_multiline_atom_test(wrap_lines, 6, TYPE_FIXNUM, 2, t_env);
+    // collections are made during a long evaluation too, and leave it every
+    //   function and environment it still needs: those on its stacks, and
+    //   frames whose closures were promoted while the frame was in use
+    char def_mk[] = "(define (mk n) (lambda () n))";
+    char def_churn[] = "(define (churn n) (cond ((= n 0) 0) " \
+                       "(else (mk n) (churn (- n 1)))))";
+    char def_outer[] = "(define (outer n) (cond (#t " \
+                       "(define (get) n) " \
+                       "(define (bump) (set! n (+ n 1))) " \
+                       "(churn 10000) (bump) (churn 10000) get)))";
+    char def_twice[] = "(define (twice n) (cond (#t " \
+                       "(define g (outer n)) (churn 20000) (+ (g) (g)))))";
+    char call_twice[] = "(twice 5)";
+    char* churn_lines[] = {def_mk, def_churn, def_outer, def_twice, call_twice};
+    e2e_multiline_atom_test(churn_lines, 5, TYPE_FIXNUM, 12, t_env);
+    char def_saved[] = "(define saved (outer 40))";
+    char churn_more[] = "(churn 50000)";
+    char call_saved[] = "(saved)";
+    char* saved_lines[] = {def_saved, churn_more, call_saved};
+    e2e_multiline_atom_test(saved_lines, 3, TYPE_FIXNUM, 41, t_env);
+    char def_closures[] = "(define (closures n) (cond ((= n 0) (quote ())) " \
+                          "(else (cons (lambda () n) (closures (- n 1))))))";
+    char def_sum_calls[] = "(define (sum-calls l) (cond ((null? l) 0) " \
+                           "(else (+ ((car l)) (sum-calls (cdr l))))))";
+    char call_sum_calls[] = "(sum-calls (closures 20000))";
+    char* closures_lines[] = {def_closures, def_sum_calls, call_sum_calls};
+    e2e_multiline_atom_test(closures_lines, \
+                            3, \
+                            TYPE_FIXNUM, \
+                            200010000, \
+                            t_env);
+    // references to parameters several closures out
+    char def_curried[] = "(define (curried a) (lambda (b) (lambda (c) " \
+                         "(- a b c))))";
+    char call_curried[] = "(((curried 10) 2) 3)";
+    char* curried_lines[] = {def_curried, call_curried};
+    e2e_multiline_atom_test(curried_lines, 2, TYPE_FIXNUM, 5, t_env);
+    // a define in an inner frame shadows the outer parameter a reference was
+    //   resolved to
+    char def_shadowed[] = "(define (shadowed a) ((lambda (b) " \
+                          "(cond (#t (define a b) a))) 9))";
+    char call_shadowed[] = "(shadowed 1)";
+    char* shadowed_lines[] = {def_shadowed, call_shadowed};
+    e2e_multiline_atom_test(shadowed_lines, 2, TYPE_FIXNUM, 9, t_env);
+    // a lambda made through another name still gets its own frame
+    char def_fn[] = "(define fn lambda)";
+    char def_aliased[] = "(define (aliased x) ((fn (y) (- x y)) 10))";
+    char call_aliased[] = "(aliased 1)";
+    char* aliased_lines[] = {def_fn, def_aliased, call_aliased};
+    e2e_multiline_atom_test(aliased_lines, 3, TYPE_FIXNUM, -9, t_env);
+    e2e_atom_test("((lambda (x x) x) 1 2)", TYPE_FIXNUM, 1, t_env);
+    // a closure sees what it and its siblings set! in the enclosing frame
+    char def_counter[] = "(define (make-counter n) (lambda () " \
+                         "(cond (#t (set! n (+ n 1)) n))))";
+    char def_count[] = "(define count (make-counter 0))";
+    char call_count[] = "(count)";
+    char* counter_lines[] = {def_counter, def_count, call_count, call_count};
+    e2e_multiline_atom_test(counter_lines, 4, TYPE_FIXNUM, 2, t_env);
+    char def_siblings[] = "(define (siblings n) (cond (#t " \
+                          "(define (get) n) " \
+                          "(define (bump) (set! n (+ n 1))) " \
+                          "(bump) (get))))";
+    char call_siblings[] = "(siblings 1)";
+    char* sibling_lines[] = {def_siblings, call_siblings};
+    e2e_multiline_atom_test(sibling_lines, 2, TYPE_FIXNUM, 2, t_env);
+    // ... and what is set! by an operator that only turns out to be set!
+    //   when it is called
+    char def_indirect[] = "(define (indirect s x) (cond (#t " \
+                          "(define f (lambda () x)) (s x 99) (f))))";
+    char call_indirect[] = "(indirect set! 1)";
+    char* indirect_lines[] = {def_indirect, call_indirect};
+    e2e_multiline_atom_test(indirect_lines, 2, TYPE_FIXNUM, 99, t_env);
+    char def_computed[] = "(define (computed x) (cond (#t " \
+                          "(define f (lambda () x)) " \
+                          "((car (list set!)) x 7) (f))))";
+    char call_computed[] = "(computed 1)";
+    char* computed_lines[] = {def_computed, call_computed};
+    e2e_multiline_atom_test(computed_lines, 2, TYPE_FIXNUM, 7, t_env);
+    // ... or by a global that is rebound to set! after the closures were made
+    char def_op[] = "(define (op a b) 0)";
+    char def_pair_of[] = "(define (pair-of x) " \
+                         "(cons (lambda () x) (lambda (v) (op x v))))";
+    char def_p[] = "(define p (pair-of 1))";
+    char rebind_op_set[] = "(define op set!)";
+    char set_through_p[] = "((cdr p) 5)";
+    char call_car_p[] = "((car p))";
+    char* rebound_set_lines[] = {def_op, \
+                                 def_pair_of, \
+                                 def_p, \
+                                 rebind_op_set, \
+                                 set_through_p, \
+                                 call_car_p};
+    e2e_multiline_atom_test(rebound_set_lines, 6, TYPE_FIXNUM, 5, t_env);
+    // a global rebound to define after the code was compiled can still
+    //   shadow a global that a closure refers to
+    char def_shadowing[] = "(define (shadowing) (cond (#t " \
+                           "(define g (lambda () a)) (op a 5) g)))";
+    char call_shadowing[] = "((shadowing))";
+    char rebind_op_define[] = "(define op define)";
+    char* rebound_define_lines[] = {define_a_one, \
+                                    def_op, \
+                                    def_shadowing, \
+                                    call_shadowing, \
+                                    rebind_op_define, \
+                                    call_shadowing};
+    e2e_multiline_atom_test(rebound_define_lines, 6, TYPE_FIXNUM, 5, t_env);
+    // a define made in the enclosing frame after a closure is created is
+    //   still seen by it
+    char def_late[] = "(define (late) (cond (#t " \
+                      "(define (peek) a) (define a 2) (peek))))";
+    char call_late[] = "(late)";
+    char* late_lines[] = {define_a_one, def_late, call_late};
+    e2e_multiline_atom_test(late_lines, 3, TYPE_FIXNUM, 2, t_env);
+    // a global reference sees the variable redefined and set! after it was
+    //   first looked up
+    char def_use_a[] = "(define (use-a) a)";
+    char call_use_a[] = "(use-a)";
+    char define_a_three[] = "(define a 3)";
+    char set_a_four[] = "(set! a 4)";
+    char* redefined_lines[] = {define_a_one, \
+                               def_use_a, \
+                               call_use_a, \
+                               define_a_three, \
+                               call_use_a};
+    e2e_multiline_atom_test(redefined_lines, 5, TYPE_FIXNUM, 3, t_env);
+    char* set_lines[] = {set_a_four, call_use_a};
+    e2e_multiline_atom_test(set_lines, 2, TYPE_FIXNUM, 4, t_env);
+    // ... and a binding made by a define under a name that was not yet bound
+    //   to it when the function was compiled
+    char def_maybe_shadow[] = "(define (maybe-shadow flag) " \
+                              "(cond (#t (cond (flag (def a 5))) a)))";
+    char call_no_shadow[] = "(maybe-shadow #f)";
+    char def_def[] = "(define def define)";
+    char call_shadow[] = "(maybe-shadow #t)";
+    char* shadow_lines[] = {define_a_one, \
+                            def_maybe_shadow, \
+                            call_no_shadow, \
+                            def_def, \
+                            call_shadow};
+    e2e_multiline_atom_test(shadow_lines, 5, TYPE_FIXNUM, 5, t_env);
+    e2e_atom_test("(maybe-shadow #f)", TYPE_FIXNUM, 1, t_env);
+    return;
+}
+
+void end_to_end_tail_call_tests(test_env* t_env) {
+    printf("# tail calls #\n");
+    // calls in tail position, through cond, and, or, and function bodies, run
+    //   in constant stack, so these would overflow it otherwise
+    char def_loop[] = "(define (loop n) (cond ((= n 0) 0) " \
+                      "(else (loop (- n 1)))))";
+    char call_loop[] = "(loop 200000)";
+    char* loop_lines[] = {def_loop, call_loop};
+    e2e_multiline_atom_test(loop_lines, 2, TYPE_FIXNUM, 0, t_env);
+    char def_count[] = "(define (count n acc) (cond ((= n 0) acc) " \
+                       "(else (count (- n 1) (+ acc 1)))))";
+    char call_count[] = "(count 200000 0)";
+    char* count_lines[] = {def_count, call_count};
+    e2e_multiline_atom_test(count_lines, 2, TYPE_FIXNUM, 200000, t_env);
+    char def_even[] = "(define (ev? n) (or (= n 0) (od? (- n 1))))";
+    char def_odd[] = "(define (od? n) (and (> n 0) (ev? (- n 1))))";
+    char call_even[] = "(ev? 200000)";
+    char* even_odd_lines[] = {def_even, def_odd, call_even};
+    e2e_multiline_atom_test(even_odd_lines, 3, TYPE_BOOL, true, t_env);
+    e2e_atom_test("(od? 200000)", TYPE_BOOL, false, t_env);
+    // a tail call through a closure that captured the frame it leaves
+    char def_keep[] = "(define (keep n f) (cond ((= n 0) (f)) " \
+                      "(else (keep (- n 1) (lambda () n)))))";
+    char call_keep[] = "(keep 100000 (lambda () 0))";
+    char* keep_lines[] = {def_keep, call_keep};
+    e2e_multiline_atom_test(keep_lines, 2, TYPE_FIXNUM, 1, t_env);
+    // the last expression of a clause with several is in tail position
+    char def_steps[] = "(define (steps n) (cond ((= n 0) 0) " \
+                       "(else (+ n 1) (steps (- n 1)))))";
+    char call_steps[] = "(steps 200000)";
+    char* steps_lines[] = {def_steps, call_steps};
+    e2e_multiline_atom_test(steps_lines, 2, TYPE_FIXNUM, 0, t_env);
+    // and the values of tail expressions are passed back unchanged
+    e2e_atom_test("(and 1 2 3)", TYPE_FIXNUM, 3, t_env);
+    e2e_atom_test("(or #f #f 4)", TYPE_FIXNUM, 4, t_env);
+    e2e_atom_test("(or #f #f #f)", TYPE_BOOL, false, t_env);
+    e2e_atom_test("((lambda (x) (cond (x x))) 5)", TYPE_FIXNUM, 5, t_env);
+    return;
+}
+
+void end_to_end_compiled_body_tests(test_env* t_env) {
+    printf("# compiled function bodies #\n");
+    // an operator that no longer names the built-in it did when the body was
+    //   analyzed is looked up again
+    char def_add[] = "(define add +)";
+    char def_apply_add[] = "(define (apply-add a b) (add a b))";
+    char call_apply_add[] = "(apply-add 2 5)";
+    char* add_lines[] = {def_add, def_apply_add, call_apply_add};
+    e2e_multiline_atom_test(add_lines, 3, TYPE_FIXNUM, 7, t_env);
+    char redef_add[] = "(define add *)";
+    char* mul_lines[] = {redef_add, call_apply_add};
+    e2e_multiline_atom_test(mul_lines, 2, TYPE_FIXNUM, 10, t_env);
+    char redef_add_fn[] = "(define add (lambda (x y) (- x y)))";
+    char* sub_lines[] = {redef_add_fn, call_apply_add};
+    e2e_multiline_atom_test(sub_lines, 2, TYPE_FIXNUM, -3, t_env);
+    char def_either[] = "(define either or)";
+    char def_or_nine[] = "(define (or-nine x) (either x 9))";
+    char call_or_nine[] = "(or-nine #f)";
+    char* or_lines[] = {def_either, def_or_nine, call_or_nine};
+    e2e_multiline_atom_test(or_lines, 3, TYPE_FIXNUM, 9, t_env);
+    char redef_either[] = "(define either and)";
+    char* and_lines[] = {redef_either, call_or_nine};
+    e2e_multiline_atom_test(and_lines, 2, TYPE_BOOL, false, t_env);
+    // a parameter named after a built-in holds whatever it was passed
+    char def_call_list[] = "(define (call-list list) (list 1))";
+    char call_call_list[] = "(call-list (lambda (x) (+ x 1)))";
+    char* list_lines[] = {def_call_list, call_call_list};
+    e2e_multiline_atom_test(list_lines, 2, TYPE_FIXNUM, 2, t_env);
+    // malformed forms in a body fail just as they do anywhere else
+    char def_bad_cond[] = "(define (bad-cond) (cond 1))";
+    char call_bad_cond[] = "(bad-cond)";
+    char* bad_cond_lines[] = {def_bad_cond, call_bad_cond};
+    e2e_multiline_atom_test(bad_cond_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_BAD_SYNTAX, \
+                            t_env);
+    char def_bad_else[] = "(define (bad-else) (cond (else 1) (#t 2)))";
+    char call_bad_else[] = "(bad-else)";
+    char* bad_else_lines[] = {def_bad_else, call_bad_else};
+    e2e_multiline_atom_test(bad_else_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_NONTERMINAL_ELSE, \
+                            t_env);
+    // arguments are all evaluated before the count is checked
+    char def_two[] = "(define (two a b) a)";
+    char call_two_few[] = "(two 1)";
+    char* few_lines[] = {def_two, call_two_few};
+    e2e_multiline_atom_test(few_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_FEW_ARGS, \
+                            t_env);
+    e2e_atom_test("(two 1 2 3)", TYPE_ERROR, EVAL_ERROR_MANY_ARGS, t_env);
+    e2e_atom_test("(two (/ 0))", TYPE_ERROR, EVAL_ERROR_DIV_ZERO, t_env);
+    char def_call_two[] = "(define (call-two x) (two x (/ 0) x))";
+    char call_call_two[] = "(call-two 1)";
+    char* call_two_lines[] = {def_call_two, call_call_two};
+    e2e_multiline_atom_test(call_two_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_DIV_ZERO, \
+                            t_env);
+    char def_nine[] = "(define (nine a b c d e f g h i) (+ a (* h i)))";
+    char call_nine[] = "(nine 1 2 3 4 5 6 7 8 9)";
+    char* nine_lines[] = {def_nine, call_nine};
+    e2e_multiline_atom_test(nine_lines, 2, TYPE_FIXNUM, 73, t_env);
+    // an error deep in a chain of calls ends them all, and leaves nothing
+    //   behind to get in the way of what comes next
+    char def_inner[] = "(define (inner x) (car x))";
+    char def_outer[] = "(define (outer x) (+ 1 (outer-2 x)))";
+    char def_outer_2[] = "(define (outer-2 x) (cons 2 (inner x)))";
+    char call_outer[] = "(outer 5)";
+    char* outer_lines[] = {def_inner, def_outer, def_outer_2, call_outer};
+    e2e_multiline_atom_test(outer_lines, \
+                            4, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_BAD_ARG_TYPE, \
+                            t_env);
+    e2e_atom_test("(inner (quote (7 8)))", TYPE_FIXNUM, 7, t_env);
+    e2e_atom_test("(outer (quote (7 8)))", \
+                  TYPE_ERROR, \
+                  EVAL_ERROR_NEED_NUM, \
+                  t_env);
+    // the built-ins done inline give way to a redefinition too
+    char def_head[] = "(define head car)";
+    char def_first[] = "(define (first l) (head l))";
+    char call_first[] = "(first (quote (3 4)))";
+    char* head_lines[] = {def_head, def_first, call_first};
+    e2e_multiline_atom_test(head_lines, 3, TYPE_FIXNUM, 3, t_env);
+    char redef_head[] = "(define head (lambda (l) (car (cdr l))))";
+    char* second_lines[] = {redef_head, call_first};
+    e2e_multiline_atom_test(second_lines, 2, TYPE_FIXNUM, 4, t_env);
+    return;
+}
+
+// Calls the virtual machine makes from bytecode, and every call evaluate_cek()
+//   makes, do not recurse on the C stack. Under evaluate(), a call made while a
+//   built-in such as list evaluates its arguments does, so such calls may not
+//   nest as deeply there (see run_body()); these tests run the same with
+//   either, though.
+void end_to_end_deep_recursion_tests(test_env* t_env) {
+    printf("# deep recursion #\n");
+    // recursion that is not in tail position is bounded by the heap, not by
+    //   the C stack
+    char def_build[] = "(define (build n) (cond ((= n 0) (quote ())) " \
+                       "(else (cons n (build (- n 1))))))";
+    char def_len[] = "(define (len l) (cond ((null? l) 0) " \
+                     "(else (+ 1 (len (cdr l))))))";
+    char call_len[] = "(len (build 100000))";
+    char* len_lines[] = {def_build, def_len, call_len};
+    e2e_multiline_atom_test(len_lines, 3, TYPE_FIXNUM, 100000, t_env);
+    // and recursion that never ends is an error, after which evaluation goes
+    //   on as before
+    char def_forever[] = "(define (forever n) (+ 1 (forever n)))";
+    char call_forever[] = "(forever 0)";
+    char* forever_lines[] = {def_forever, call_forever};
+    e2e_multiline_atom_test(forever_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_TOO_DEEP, \
+                            t_env);
+    e2e_atom_test("(len (build 10))", TYPE_FIXNUM, 10, t_env);
+    // ... including recursion through the arguments of a built-in that is
+    //   passed the whole form
+    char def_nest[] = "(define (nest n) (cond ((= n 0) (quote ())) " \
+                      "(else (list (nest (- n 1))))))";
+    char def_depth[] = "(define (depth l) (cond ((null? l) 0) " \
+                       "(else (+ 1 (depth (car l))))))";
+    char call_depth[] = "(depth (nest 1000))";
+    char* nest_lines[] = {def_nest, def_depth, call_depth};
+    e2e_multiline_atom_test(nest_lines, 3, TYPE_FIXNUM, 1000, t_env);
+    char def_forever_list[] = "(define (forever-list n) " \
+                              "(list (forever-list n)))";
+    char call_forever_list[] = "(forever-list 0)";
+    char* forever_list_lines[] = {def_forever_list, call_forever_list};
+    e2e_multiline_atom_test(forever_list_lines, \
+                            2, \
+                            TYPE_ERROR, \
+                            EVAL_ERROR_TOO_DEEP, \
+                            t_env);
+    e2e_atom_test("(depth (nest 10))", TYPE_FIXNUM, 10, t_env);
     return;
 }
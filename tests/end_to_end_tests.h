@@ -40,5 +40,8 @@ void end_to_end_string_equals_tests(test_env* t_env);
 void end_to_end_string_append_tests(test_env* t_env);
 
 void end_to_end_scoping_tests(test_env* t_env);
+void end_to_end_tail_call_tests(test_env* t_env);
+void end_to_end_compiled_body_tests(test_env* t_env);
+void end_to_end_deep_recursion_tests(test_env* t_env);
 
 #endif
@@ -63,6 +63,9 @@ test_env* end_to_end_tests() {
     end_to_end_string_equals_tests(t_env);
     end_to_end_string_append_tests(t_env);
     end_to_end_scoping_tests(t_env);
+    end_to_end_tail_call_tests(t_env);
+    end_to_end_compiled_body_tests(t_env);
+    end_to_end_deep_recursion_tests(t_env);
     // cleanup
     delete_environment(t_env->env);
     t_env->env = NULL;
@@ -75,6 +78,12 @@ int main() {
     printf("\n----------------\n");
     test_env* e2e_test_results = end_to_end_tests();
     printf("\n----------------\n");
+    // the same again, through the heap-continuation evaluator
+    test_evaluator = evaluate_cek;
+    printf("(with evaluate_cek()) ");
+    test_env* cek_test_results = end_to_end_tests();
+    test_evaluator = evaluate;
+    printf("\n----------------\n");
     printf("\ntest results");
     printf("\n------------\n");
     printf("unit tests passed/run: %u/%u\n", \
@@ -83,13 +92,18 @@ int main() {
     printf("end-to-end tests passed/run: %u/%u\n", \
            e2e_test_results->passed, \
            e2e_test_results->run);
+    printf("end-to-end tests with evaluate_cek() passed/run: %u/%u\n", \
+           cek_test_results->passed, \
+           cek_test_results->run);
     printf("\n----------------\n");
     printf("testing complete\n");
     int PASS = 0;
     int FAIL = 64; // 64 is a generic "failure" exit code in sysexits.h
     bool ok = (unit_test_results->passed == unit_test_results->run && \
-               e2e_test_results->passed == e2e_test_results->run);
+               e2e_test_results->passed == e2e_test_results->run && \
+               cek_test_results->passed == cek_test_results->run);
     free(unit_test_results);
     free(e2e_test_results);
+    free(cek_test_results);
     return (ok) ? PASS : FAIL;
 }
@@ -1,6 +1,11 @@
 #include "test_utils.h"
 
+typed_ptr (*test_evaluator)(const typed_ptr* tp, Environment* env) = evaluate;
+
 typed_ptr* parse_and_evaluate(char command[], Environment* env) {
+    // the previous command's results have been dealt with by now, so this is
+    //   the same safe point the REPL collects at
+    collect_garbage(env);
     typed_ptr* parse_output = parse(command, env);
     if (parse_output->type == TYPE_ERROR) {
         return parse_output;
@@ -8,11 +13,12 @@ typed_ptr* parse_and_evaluate(char command[], Environment* env) {
         s_expr* eval_output = create_empty_s_expr();
         for (s_expr* term = parse_output->ptr.se_ptr; \
              !is_empty_list(term); \
-             term = term->cdr->ptr.se_ptr) {
-            s_expr_append(eval_output, evaluate(term->car, env));
+             term = s_expr_next(term)) {
+            typed_ptr result = test_evaluator(&term->car, env);
+            s_expr_append(eval_output, copy_typed_ptr(&result));
         }
         delete_s_expr_recursive(parse_output->ptr.se_ptr, true);
-        free(parse_output);
+        delete_typed_ptr(parse_output);
         return create_s_expr_tp(eval_output);
     }
 }
@@ -21,7 +27,7 @@ bool check_error(const typed_ptr* tp, interpreter_error err) {
     return (tp != NULL && tp->type == TYPE_ERROR && tp->ptr.idx == err);
 }
 
-bool match_typed_ptrs(typed_ptr* first, typed_ptr* second) {
+bool match_typed_ptrs(const typed_ptr* first, const typed_ptr* second) {
     if (first == NULL && second == NULL) {
         return true;
     } else if (first == NULL || second == NULL) {
@@ -34,8 +40,8 @@ bool match_typed_ptrs(typed_ptr* first, typed_ptr* second) {
         if (first->ptr.string->len != second->ptr.string->len) {
             return false;
         } else {
-            return !strcmp(first->ptr.string->contents, \
-                           second->ptr.string->contents);
+            return !strcmp(string_contents(first->ptr.string), \
+                           string_contents(second->ptr.string));
         }
     } else {
         return first->ptr.idx == second->ptr.idx;
@@ -52,27 +58,29 @@ bool match_s_exprs(const s_expr* first, const s_expr* second) {
             return true;
         } else if (is_empty_list(first) || is_empty_list(second)) {
             return false;
-        } else if (first->car == NULL || second->car == NULL) {
+        } else if (first->car.type == TYPE_NONE || \
+                   second->car.type == TYPE_NONE) {
             return false;
-        } else if (first->cdr == NULL || second->cdr == NULL) {
+        } else if (first->cdr.type == TYPE_NONE || \
+                   second->cdr.type == TYPE_NONE) {
             return false;
         } else {
             bool ok = true;
-            if (first->car->type != second->car->type) {
+            if (first->car.type != second->car.type) {
                 return false;
-            } else if (first->car->type == TYPE_S_EXPR) {
-                ok = ok && match_s_exprs(first->car->ptr.se_ptr, \
-                                         second->car->ptr.se_ptr);
+            } else if (first->car.type == TYPE_S_EXPR) {
+                ok = ok && match_s_exprs(first->car.ptr.se_ptr, \
+                                         second->car.ptr.se_ptr);
             } else {
-                ok = ok && match_typed_ptrs(first->car, second->car);
+                ok = ok && match_typed_ptrs(&first->car, &second->car);
             }
-            if (first->cdr->type != second->cdr->type) {
+            if (first->cdr.type != second->cdr.type) {
                 return false;
-            } else if (first->cdr->type == TYPE_S_EXPR) {
-                return ok && match_s_exprs(first->cdr->ptr.se_ptr, \
-                                           second->cdr->ptr.se_ptr);
+            } else if (first->cdr.type == TYPE_S_EXPR) {
+                return ok && match_s_exprs(first->cdr.ptr.se_ptr, \
+                                           second->cdr.ptr.se_ptr);
             } else {
-                return ok && match_typed_ptrs(first->cdr, second->cdr);
+                return ok && match_typed_ptrs(&first->cdr, &second->cdr);
             }
         }
     }
@@ -107,17 +115,22 @@ void print_test_result(bool pass) {
     return;
 }
 
+// The typed_ptr is copied into the new cell, and its shell is freed.
 s_expr* unit_list(typed_ptr* tp) {
-    return create_s_expr(tp, create_s_expr_tp(create_empty_s_expr()));
+    s_expr* se = create_s_expr(*tp, s_expr_tp(create_empty_s_expr()));
+    delete_typed_ptr(tp);
+    return se;
 }
 
+// The typed_ptr is copied into the new cell, and its shell is freed.
 void s_expr_append(s_expr* se, typed_ptr* tp) {
     // assume: se is a valid s-expression
     while (!is_empty_list(se)) {
-        se = se->cdr->ptr.se_ptr;
+        se = s_expr_next(se);
     }
-    se->car = tp;
-    se->cdr = create_s_expr_tp(create_empty_s_expr());
+    se->car = *tp;
+    se->cdr = s_expr_tp(create_empty_s_expr());
+    delete_typed_ptr(tp);
     return;
 }
 
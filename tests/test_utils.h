@@ -16,11 +16,14 @@ typedef struct TEST_ENV {
     unsigned int run;
 } test_env;
 
+// the evaluator parse_and_evaluate() uses: evaluate() unless set otherwise
+extern typed_ptr (*test_evaluator)(const typed_ptr* tp, Environment* env);
+
 typed_ptr* parse_and_evaluate(char command[], Environment* env);
 
 bool check_error(const typed_ptr* tp, interpreter_error err);
 
-bool match_typed_ptrs(typed_ptr* first, typed_ptr* second);
+bool match_typed_ptrs(const typed_ptr* first, const typed_ptr* second);
 bool match_s_exprs(const s_expr* first, const s_expr* second);
 bool deep_match_typed_ptrs(typed_ptr* first, typed_ptr* second);
 
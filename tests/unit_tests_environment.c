@@ -8,11 +8,12 @@ void unit_tests_environment(test_env* te) {
     test_create_symbol_node(te);
     test_create_error_symbol_node(te);
     test_create_symbol_table(te);
-    test_merge_symbol_tables(te);
+    test_truncate_symbol_table(te);
     test_delete_symbol_node_list(te);
     test_create_function_node(te);
     test_create_function_table(te);
     test_create_environment(te);
+    test_create_call_frame(te);
     test_delete_environment(te);
     test_install_symbol_regular_and_blind(te);
     test_install_function(te);
@@ -21,6 +22,8 @@ void unit_tests_environment(test_env* te) {
     test_builtin_lookup_index(te);
     test_value_lookup_index(te);
     test_function_lookup_index(te);
+    test_collect_young_garbage(te);
+    test_collect_all_garbage(te);
     return;
 }
 
@@ -69,7 +72,8 @@ void test_create_symbol_table(test_env* te) {
     if (out == NULL || \
         out->head != NULL || \
         out->length != 0 || \
-        out->offset != 42) {
+        out->offset != 42 || \
+        out->name_index != NULL) {
         pass = false;
     }
     free(out);
@@ -79,82 +83,50 @@ void test_create_symbol_table(test_env* te) {
     return;
 }
 
-void test_merge_symbol_tables(test_env* te) {
-    print_test_announce("merge_symbol_tables()");
-    Symbol_Table* first = create_symbol_table(0);
-    Symbol_Table* second = create_symbol_table(10);
+void test_truncate_symbol_table(test_env* te) {
+    print_test_announce("truncate_symbol_table()");
+    Environment* env = create_environment(0, 0, NULL);
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=TEST_NUM}};
     bool pass = true;
-    // both empty
-    merge_symbol_tables(first, second);
-    if (first == NULL || \
-        second == NULL || \
-        first->head != NULL || \
-        first->length != 0 || \
-        first->offset != 0 || \
-        second->head != NULL) {
-        pass = false;
-    }
-    // first empty
-    Symbol_Node *first_node1, *first_node2, *second_node1, *second_node2;
-    first_node1 = create_symbol_node(0, "x", TYPE_FIXNUM, TEST_NUM_TP_VAL);
-    first_node2 = create_symbol_node(1, "y", TYPE_FIXNUM, TEST_NUM_TP_VAL);
-    second_node1 = create_symbol_node(10, "z", TYPE_FIXNUM, TEST_NUM_TP_VAL);
-    second_node2 = create_symbol_node(11, "w", TYPE_FIXNUM, TEST_NUM_TP_VAL);
-    second->head = second_node1;
-    second_node1->next = second_node2;
-    second->length = 2;
-    merge_symbol_tables(first, second);
-    if (first == NULL || \
-        second == NULL || \
-        first->head != second_node1 || \
-        first->head->next != second_node2 || \
-        first->head->next->next != NULL || \
-        first->length != 2 || \
-        first->offset != 0 || \
-        second->head != NULL || \
-        second->length != 0) {
-        pass = false;
-    }
-    second_node1->next = NULL;
-    first->head = NULL;
-    first->length = 0;
-    // second empty
-    first->head = first_node1;
-    first_node1->next = first_node2;
-    first->length = 2;
-    merge_symbol_tables(first, second);
-    if (first == NULL || \
-        second == NULL || \
-        first->head != first_node1 || \
-        first->head->next != first_node2 || \
-        first->head->next->next != NULL || \
-        first->length != 2 || \
-        first->offset != 0 || \
-        second->head != NULL || \
-        second->length != 0) {
-        pass = false;
-    }
-    // neither empty
-    second->head = second_node1;
-    second_node1->next = second_node2;
-    second->length = 2;
-    merge_symbol_tables(first, second);
-    if (first == NULL || \
-        second == NULL || \
-        first->head != first_node1 || \
-        first->head->next != first_node2 || \
-        first->head->next->next != second_node1 || \
-        first->head->next->next->next != second_node2 || \
-        first->head->next->next->next->next != NULL || \
-        first->length != 4 || \
-        first->offset != 0 || \
-        second->head != NULL || \
-        second->length != 0) {
-        pass = false;
-    }
-    delete_symbol_node_list(first->head);
-    free(first);
-    free(second);
+    // nothing to remove
+    blind_install_symbol(env, "x", &number);
+    truncate_symbol_table(env->symbol_table, 1);
+    if (env->symbol_table->length != 1 || \
+        symbol_lookup_name(env, "x") == NULL) {
+        pass = false;
+    }
+    // removing the newest symbols from a table large enough to be indexed by
+    //   name
+    char name[20];
+    for (unsigned int i = 0; i < 32; i++) {
+        snprintf(name, 20, "sym-%u", i);
+        blind_install_symbol(env, name, &number);
+    }
+    String* str = create_string("test");
+    typed_ptr str_tp = {.type=TYPE_STRING, .ptr={.string=str}};
+    blind_install_symbol(env, "str", &str_tp);
+    unsigned int str_idx = symbol_lookup_name(env, "str")->symbol_idx;
+    typed_ptr str_sym = {.type=TYPE_SYMBOL, .ptr={.idx=str_idx}};
+    truncate_symbol_table(env->symbol_table, 17);
+    if (env->symbol_table->length != 17 || \
+        env->symbol_table->name_index == NULL || \
+        symbol_lookup_name(env, "x") == NULL || \
+        symbol_lookup_name(env, "sym-0") == NULL || \
+        symbol_lookup_name(env, "sym-15") == NULL || \
+        symbol_lookup_name(env, "sym-16") != NULL || \
+        symbol_lookup_name(env, "str") != NULL || \
+        symbol_lookup_index(env, &str_sym) != NULL) {
+        pass = false;
+    }
+    // the numbers of removed symbols are handed out again
+    typed_ptr* reinstalled = install_symbol(env, "new", &number);
+    if (reinstalled->ptr.idx != 17 || \
+        symbol_lookup_index(env, reinstalled) != \
+        symbol_lookup_name(env, "new")) {
+        pass = false;
+    }
+    delete_typed_ptr(reinstalled);
+    delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -189,22 +161,24 @@ void test_create_function_node(test_env* te) {
     params->next = create_symbol_node(1, "y", TYPE_FIXNUM, TEST_NUM_TP_VAL);
     Environment* encl = create_environment(0, 0, NULL);
     typed_ptr* body = create_s_expr_tp(create_empty_s_expr());
-    Function_Node* out = create_function_node(0, "f", params, encl, body);
+    Function_Code* code = create_function_code(params, body);
+    Function_Node* out = create_function_node(0, "f", code, encl);
     bool pass = true;
     if (out == NULL || \
         out->function_idx != 0 || \
         strcmp(out->name, "f") || \
-        out->param_list != params || \
+        out->code != code || \
+        out->code->param_list != params || \
         out->enclosing_env != encl || \
-        out->body != body || \
+        out->code->body != body || \
         out->next != NULL) {
         pass = false;
     }
-    free(out->name);
     delete_symbol_node_list(params);
     delete_environment(encl);
-    free(body->ptr.se_ptr);
-    free(body);
+    delete_s_expr(body->ptr.se_ptr);
+    delete_typed_ptr(body);
+    free(code);
     free(out);
     print_test_result(pass);
     te->passed += pass;
@@ -257,6 +231,89 @@ void test_create_environment(test_env* te) {
     return;
 }
 
+void test_create_call_frame(test_env* te) {
+    print_test_announce("create_call_frame()");
+    bool pass = true;
+    Environment* encl = create_environment(0, 0, NULL);
+    typed_ptr undef = {.type=TYPE_UNDEF, .ptr={.idx=0}};
+    blind_install_symbol(encl, "x", &undef);
+    blind_install_symbol(encl, "y", &undef);
+    blind_install_symbol(encl, "z", &undef);
+    // no parameters
+    Function_Code* code = create_function_code(NULL, \
+                                               create_atom_tp(TYPE_FIXNUM, 1));
+    Environment* out = create_call_frame(code, encl);
+    if (out == NULL || \
+        out->symbol_table == NULL || \
+        out->symbol_table->head != NULL || \
+        out->symbol_table->length != 0 || \
+        out->function_table != NULL || \
+        out->enclosing_env != encl || \
+        out->global_env != encl || \
+        out->env_tracker_next != NULL || \
+        out->code != code || \
+        code->refs != 2 || \
+        out->slot_count != 0 || \
+        out->extended) {
+        pass = false;
+    }
+    delete_environment(out);
+    if (code->refs != 1) {
+        pass = false;
+    }
+    delete_function_code(code);
+    // two parameters, bound in order and named by the code's parameter list,
+    //   whose names are borrowed from the global symbol table
+    char* x_name = symbol_lookup_name(encl, "x")->name;
+    char* y_name = symbol_lookup_name(encl, "y")->name;
+    Symbol_Node* params = create_symbol_node(0, \
+                                             x_name, \
+                                             TYPE_UNDEF, \
+                                             TEST_NUM_TP_VAL);
+    params->next = create_symbol_node(1, \
+                                      y_name, \
+                                      TYPE_UNDEF, \
+                                      TEST_NUM_TP_VAL);
+    code = create_function_code(params, create_atom_tp(TYPE_FIXNUM, 1));
+    out = create_call_frame(code, encl);
+    if (out->slot_count != 2 || \
+        out->symbol_table->length != 2 || \
+        out->symbol_table->head != &out->slots[0] || \
+        out->slots[0].next != &out->slots[1] || \
+        out->slots[1].next != NULL || \
+        out->slots[0].name != params->name || \
+        out->slots[0].symbol_idx != 0 || \
+        out->slots[0].type != TYPE_UNDEF || \
+        out->slots[1].name != params->next->name || \
+        out->slots[1].symbol_idx != 1 || \
+        symbol_lookup_name(out, "y") != &out->slots[1] || \
+        symbol_lookup_name(out, "z") != NULL) {
+        pass = false;
+    }
+    // symbols defined in the frame later are added ahead of its bindings
+    typed_ptr number_64 = {.type=TYPE_FIXNUM, .ptr={.idx=64}};
+    blind_install_symbol(out, "x", &number_64);
+    String* str = create_string("test");
+    typed_ptr str_tp = {.type=TYPE_STRING, .ptr={.string=str}};
+    blind_install_symbol(out, "z", &str_tp);
+    if (!out->extended || \
+        out->symbol_table->length != 3 || \
+        out->symbol_table->head == &out->slots[0] || \
+        out->symbol_table->head->next != &out->slots[0] || \
+        out->slots[0].type != TYPE_FIXNUM || \
+        out->slots[0].value.idx != 64 || \
+        symbol_lookup_name(out, "z") != out->symbol_table->head) {
+        pass = false;
+    }
+    delete_environment(out);
+    delete_function_code(code);
+    delete_environment(encl);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
 // smoke tests & valgrind checks
 void test_delete_environment(test_env* te) {
     print_test_announce("delete_environment()");
@@ -266,8 +323,8 @@ void test_delete_environment(test_env* te) {
     blind_install_symbol(original, "test_atom_1", &number_64);
     blind_install_symbol(original, "test_atom_2", &number_128);
     s_expr* se = create_empty_s_expr();
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 512), create_s_expr_tp(se));
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 256), create_s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 512), s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 256), s_expr_tp(se));
     typed_ptr se_tp = {.type=TYPE_S_EXPR, .ptr={.se_ptr=se}};
     blind_install_symbol(original, "test_se_1", &se_tp);
     String* test_str = create_string("test string");
@@ -276,8 +333,8 @@ void test_delete_environment(test_env* te) {
     Symbol_Node* params = create_symbol_node(0, "x", TYPE_FIXNUM, TEST_NUM_TP_VAL);
     params->next = create_symbol_node(1, "y", TYPE_FIXNUM, TEST_NUM_TP_VAL);
     typed_ptr* body = create_s_expr_tp(create_empty_s_expr());
-    typed_ptr* out = install_function(original, "", params, original, body);
-    free(out);
+    Function_Code* code = create_function_code(params, body);
+    install_function(original, "", code, original);
     Environment* closure_env = create_environment(0, 0, original);
     original->env_tracker_next = closure_env;
     closure_env = create_environment(0, 0, original);
@@ -309,14 +366,14 @@ void test_install_symbol_regular_and_blind(test_env* te) {
         out->ptr.idx != symbol_lookup_name(env, name1)->symbol_idx) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     out = install_symbol(env, name2, &boolean);
     if (out == NULL || \
         out->type != TYPE_SYMBOL || \
         out->ptr.idx != symbol_lookup_name(env, name2)->symbol_idx) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     typed_ptr exit_error = {.type=TYPE_ERROR, .ptr={.idx=EVAL_ERROR_EXIT}};
     blind_install_symbol(env, name3, &exit_error);
     s_expr* se = create_empty_s_expr();
@@ -326,6 +383,7 @@ void test_install_symbol_regular_and_blind(test_env* te) {
         pass = false;
     }
     if (symbol_lookup_name(env, name1) == NULL || \
+        symbol_lookup_name(env, name1)->name == name1 || \
         strcmp(symbol_lookup_name(env, name1)->name, name1) || \
         symbol_lookup_name(env, name1)->type != TYPE_FIXNUM || \
         symbol_lookup_name(env, name1)->value.idx != TEST_NUM) {
@@ -364,7 +422,7 @@ void test_install_symbol_regular_and_blind(test_env* te) {
         out->ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     if (symbol_lookup_name(env, absent_in_global) != NULL || \
         symbol_lookup_name(child, absent_in_global) != NULL) {
         pass = false;
@@ -380,12 +438,13 @@ void test_install_symbol_regular_and_blind(test_env* te) {
         out->ptr.idx != symbol_lookup_name(env, name1)->symbol_idx) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     Symbol_Node* global_lookup = symbol_lookup_name(env, name1);
     Symbol_Node* child_lookup = symbol_lookup_name(child, name1);
     if (child_lookup == NULL || \
         global_lookup == NULL || \
         child_lookup->symbol_idx != global_lookup->symbol_idx || \
+        child_lookup->name != global_lookup->name || \
         child_lookup->type != TYPE_FIXNUM || \
         child_lookup->value.idx != TEST_NUM || \
         global_lookup->type != TYPE_BOOL || \
@@ -403,7 +462,7 @@ void test_install_symbol_regular_and_blind(test_env* te) {
         out->ptr.idx != symbol_lookup_name(env, name1)->symbol_idx) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     global_lookup = symbol_lookup_name(env, name1);
     child_lookup = symbol_lookup_name(child, name1);
     if (child_lookup == NULL || \
@@ -434,19 +493,18 @@ void test_install_function(test_env* te) {
     params = create_symbol_node(0, "x", TYPE_FIXNUM, TEST_NUM_TP_VAL);
     params->next = create_symbol_node(1, "y", TYPE_BOOL, TEST_NUM_TP_VAL);
     typed_ptr* body = create_s_expr_tp(create_empty_s_expr());
-    typed_ptr* out = install_function(env, "f", params, env, body);
+    Function_Code* code = create_function_code(params, body);
+    typed_ptr out = install_function(env, "f", code, env);
     bool pass = true;
-    if (out == NULL || \
-        out->type != TYPE_FUNCTION || \
-        out->ptr.idx != env->function_table->head->function_idx || \
-        function_lookup_index(env, out) == NULL || \
-        strcmp(function_lookup_index(env, out)->name, "f") || \
-        function_lookup_index(env, out)->param_list != params || \
-        function_lookup_index(env, out)->enclosing_env != env || \
-        function_lookup_index(env, out)->body != body) {
+    if (out.type != TYPE_FUNCTION || \
+        out.ptr.idx != env->function_table->head->function_idx || \
+        function_lookup_index(env, &out) == NULL || \
+        strcmp(function_lookup_index(env, &out)->name, "f") || \
+        function_lookup_index(env, &out)->code->param_list != params || \
+        function_lookup_index(env, &out)->enclosing_env != env || \
+        function_lookup_index(env, &out)->code->body != body) {
         pass = false;
     }
-    free(out);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -469,6 +527,7 @@ void test_symbol_lookup_name(test_env* te) {
     blind_install_symbol(env, name3, &exit_error);
     bool pass = true;
     if (symbol_lookup_name(env, name1) == NULL || \
+        symbol_lookup_name(env, name1)->name == name1 || \
         strcmp(symbol_lookup_name(env, name1)->name, name1) || \
         symbol_lookup_name(env, name1)->type != TYPE_FIXNUM || \
         symbol_lookup_name(env, name1)->value.idx != TEST_NUM || \
@@ -498,6 +557,27 @@ void test_symbol_lookup_name(test_env* te) {
         pass = false;
     }
     delete_environment(child);
+    // enough symbols that the table is indexed by name
+    char name[32];
+    for (int i = 0; i < 1000; i++) {
+        sprintf(name, "indexed_symbol_%d", i);
+        number.ptr.idx = i;
+        blind_install_symbol(env, name, &number);
+    }
+    if (env->symbol_table->name_index == NULL || \
+        symbol_lookup_name(env, name1) == NULL || \
+        symbol_lookup_name(env, name1)->type != TYPE_FIXNUM || \
+        symbol_lookup_name(env, absent_name) != NULL) {
+        pass = false;
+    }
+    for (int i = 0; i < 1000; i++) {
+        sprintf(name, "indexed_symbol_%d", i);
+        Symbol_Node* found = symbol_lookup_name(env, name);
+        if (found == NULL || strcmp(found->name, name) || \
+            found->value.idx != i) {
+            pass = false;
+        }
+    }
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -554,11 +634,11 @@ void test_symbol_lookup_index(test_env* te) {
         pass = false;
     }
     delete_environment(child);
-    free(symbol_1);
-    free(symbol_2);
-    free(symbol_3);
-    free(absent_symbol);
-    free(not_a_symbol);
+    delete_typed_ptr(symbol_1);
+    delete_typed_ptr(symbol_2);
+    delete_typed_ptr(symbol_3);
+    delete_typed_ptr(absent_symbol);
+    delete_typed_ptr(not_a_symbol);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -603,6 +683,19 @@ void test_builtin_lookup_index(test_env* te) {
     if (builtin_lookup_index(env, not_a_builtin) != NULL) {
         pass = false;
     }
+    // an alias does not displace the first binding until that is rebound
+    blind_install_symbol(env, "alias_3", bi_ptr_3);
+    if (builtin_lookup_index(env, bi_ptr_3) == NULL || \
+        strcmp(builtin_lookup_index(env, bi_ptr_3)->name, "bi_3")) {
+        pass = false;
+    }
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=TEST_NUM}};
+    typed_ptr* rebound = install_symbol(env, "bi_3", &number);
+    if (builtin_lookup_index(env, bi_ptr_3) == NULL || \
+        strcmp(builtin_lookup_index(env, bi_ptr_3)->name, "alias_3")) {
+        pass = false;
+    }
+    delete_typed_ptr(rebound);
     // tests for nested environment
     Environment* child = create_environment(0, 0, env);
     if (builtin_lookup_index(child, bi_ptr_1) == NULL || \
@@ -619,11 +712,11 @@ void test_builtin_lookup_index(test_env* te) {
         pass = false;
     }
     delete_environment(child);
-    free(bi_ptr_1);
-    free(bi_ptr_2);
-    free(bi_ptr_3);
-    free(bi_ptr_absent);
-    free(not_a_builtin);
+    delete_typed_ptr(bi_ptr_1);
+    delete_typed_ptr(bi_ptr_2);
+    delete_typed_ptr(bi_ptr_3);
+    delete_typed_ptr(bi_ptr_absent);
+    delete_typed_ptr(not_a_builtin);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -654,115 +747,131 @@ void test_value_lookup_index(test_env* te) {
     typed_ptr* absent_symbol = create_atom_tp(TYPE_SYMBOL, 1000);
     typed_ptr* not_a_symbol = create_atom_tp(TYPE_FIXNUM, 1000);
     bool pass = true;
-    typed_ptr* out = value_lookup_index(env, symbol_num);
-    if (out == NULL || \
-        out->type != TYPE_FIXNUM || \
-        out->ptr.idx != TEST_NUM) {
+    typed_ptr out = value_lookup_index(env, symbol_num);
+    if (out.type != TYPE_FIXNUM || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(env, symbol_bool);
-    if (out == NULL || \
-        out->type != TYPE_BOOL || \
-        out->ptr.idx != TEST_NUM) {
+    if (out.type != TYPE_BOOL || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(env, symbol_se);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !is_empty_list(out->ptr.se_ptr) || \
-        out->ptr.se_ptr == se) {
+    if (out.type != TYPE_S_EXPR || \
+        !is_empty_list(out.ptr.se_ptr) || \
+        out.ptr.se_ptr != se) {
         pass = false;
     }
-    free(out->ptr.se_ptr);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     out = value_lookup_index(env, symbol_str);
-    if (out == NULL || \
-        out->type != TYPE_STRING || \
-        strcmp(test_str->contents, out->ptr.string->contents) || \
-        out->ptr.string == test_str) {
+    if (out.type != TYPE_STRING || \
+        strcmp(test_str->contents, out.ptr.string->contents) || \
+        out.ptr.string != test_str) {
         pass = false;
     }
-    delete_string(out->ptr.string);
-    free(out);
+    delete_string(out.ptr.string);
     out = value_lookup_index(env, symbol_undef);
-    if (out == NULL || \
-        out->type != TYPE_ERROR || \
-        out->ptr.idx != EVAL_ERROR_UNDEF_SYM) {
+    if (out.type != TYPE_ERROR || \
+        out.ptr.idx != EVAL_ERROR_UNDEF_SYM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(env, absent_symbol);
-    if (out != NULL) {
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(env, not_a_symbol);
-    if (out != NULL) {
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    free(out);
     // tests for nested environments
     Environment* middle = create_environment(0, 0, env);
     Environment* lowest = create_environment(0, 0, middle);
     blind_install_symbol(middle, name_num, &boolean);
     blind_install_symbol(lowest, name_bool, &number);
     out = value_lookup_index(lowest, symbol_num);
-    if (out == NULL || \
-        out->type != TYPE_BOOL || \
-        out->ptr.idx != TEST_NUM) {
+    if (out.type != TYPE_BOOL || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(lowest, symbol_bool);
-    if (out == NULL || \
-        out->type != TYPE_FIXNUM || \
-        out->ptr.idx != TEST_NUM) {
+    if (out.type != TYPE_FIXNUM || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(middle, symbol_num);
-    if (out == NULL || \
-        out->type != TYPE_BOOL || \
-        out->ptr.idx != TEST_NUM) {
+    if (out.type != TYPE_BOOL || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
     out = value_lookup_index(middle, symbol_bool);
-    if (out == NULL || \
-        out->type != TYPE_BOOL || \
-        out->ptr.idx != TEST_NUM) {
+    if (out.type != TYPE_BOOL || \
+        out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    free(out);
-    if (value_lookup_index(lowest, NULL) != NULL) {
+    out = value_lookup_index(lowest, NULL);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
+        pass = false;
+    }
+    out = value_lookup_index(lowest, absent_symbol);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
+        pass = false;
+    }
+    out = value_lookup_index(lowest, not_a_symbol);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
+        pass = false;
+    }
+    out = value_lookup_index(middle, NULL);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    if (value_lookup_index(lowest, absent_symbol) != NULL) {
+    out = value_lookup_index(middle, absent_symbol);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    if (value_lookup_index(lowest, not_a_symbol) != NULL) {
+    out = value_lookup_index(middle, not_a_symbol);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_BAD_SYMBOL) {
         pass = false;
     }
-    if (value_lookup_index(middle, NULL) != NULL) {
+    // a global reference from a call frame is cached at its site
+    Function_Code* code = create_function_code(NULL, \
+                                               create_atom_tp(TYPE_FIXNUM, 1));
+    code->global_cache = calloc(1, sizeof(Global_Cache_Entry));
+    code->global_cache_count = 1;
+    Environment* frame = create_call_frame(code, env);
+    typed_ptr site_ref = *symbol_num;
+    site_ref.address = GLOBAL_SITE_ADDRESS(0);
+    out = value_lookup_index(frame, &site_ref);
+    if (out.type != TYPE_FIXNUM || \
+        out.ptr.idx != TEST_NUM || \
+        code->global_cache[0].binding != symbol_lookup_index(env, symbol_num)) {
         pass = false;
     }
-    if (value_lookup_index(middle, absent_symbol) != NULL) {
+    // the cached binding sees the variable redefined
+    blind_install_symbol(env, name_num, &boolean);
+    out = value_lookup_index(frame, &site_ref);
+    if (out.type != TYPE_BOOL || out.ptr.idx != TEST_NUM) {
         pass = false;
     }
-    if (value_lookup_index(middle, not_a_symbol) != NULL) {
+    // a binding the frame's code was not known to make is found instead
+    blind_install_symbol(frame, name_num, &number);
+    out = value_lookup_index(frame, &site_ref);
+    if (out.type != TYPE_FIXNUM || \
+        out.ptr.idx != TEST_NUM || \
+        !code_assigns(code, symbol_num->ptr.idx)) {
         pass = false;
     }
+    delete_environment(frame);
+    delete_function_code(code);
     delete_environment(lowest);
     delete_environment(middle);
-    free(symbol_num);
-    free(symbol_bool);
-    free(symbol_se);
-    free(symbol_str);
-    free(symbol_undef);
-    free(absent_symbol);
-    free(not_a_symbol);
+    delete_typed_ptr(symbol_num);
+    delete_typed_ptr(symbol_bool);
+    delete_typed_ptr(symbol_se);
+    delete_typed_ptr(symbol_str);
+    delete_typed_ptr(symbol_undef);
+    delete_typed_ptr(absent_symbol);
+    delete_typed_ptr(not_a_symbol);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -777,14 +886,15 @@ void test_function_lookup_index(test_env* te) {
     params = create_symbol_node(0, "x", TYPE_FIXNUM, (tp_value){.idx=TEST_NUM});
     params->next = create_symbol_node(1, "y", TYPE_BOOL, (tp_value){.idx=TEST_NUM});
     typed_ptr* body = create_s_expr_tp(create_empty_s_expr());
-    typed_ptr* out = install_function(env, "f", params, env, body);
+    Function_Code* code = create_function_code(params, body);
+    typed_ptr out = install_function(env, "f", code, env);
     bool pass = true;
-    if (function_lookup_index(env, out) == NULL || \
-        strcmp(function_lookup_index(env, out)->name, "f") || \
-        function_lookup_index(env, out)->function_idx != out->ptr.idx || \
-        function_lookup_index(env, out)->param_list != params || \
-        function_lookup_index(env, out)->enclosing_env != env || \
-        function_lookup_index(env, out)->body != body) {
+    if (function_lookup_index(env, &out) == NULL || \
+        strcmp(function_lookup_index(env, &out)->name, "f") || \
+        function_lookup_index(env, &out)->function_idx != out.ptr.idx || \
+        function_lookup_index(env, &out)->code->param_list != params || \
+        function_lookup_index(env, &out)->enclosing_env != env || \
+        function_lookup_index(env, &out)->code->body != body) {
         pass = false;
     }
     if (function_lookup_index(env, NULL) != NULL) {
@@ -800,12 +910,12 @@ void test_function_lookup_index(test_env* te) {
     }
     // tests for nested environment
     Environment* child = create_environment(0, 0, env);
-    if (function_lookup_index(child, out) == NULL || \
-        strcmp(function_lookup_index(child, out)->name, "f") || \
-        function_lookup_index(child, out)->function_idx != out->ptr.idx || \
-        function_lookup_index(child, out)->param_list != params || \
-        function_lookup_index(env, out)->enclosing_env != env || \
-        function_lookup_index(env, out)->body != body || \
+    if (function_lookup_index(child, &out) == NULL || \
+        strcmp(function_lookup_index(child, &out)->name, "f") || \
+        function_lookup_index(child, &out)->function_idx != out.ptr.idx || \
+        function_lookup_index(child, &out)->code->param_list != params || \
+        function_lookup_index(env, &out)->enclosing_env != env || \
+        function_lookup_index(env, &out)->code->body != body || \
         function_lookup_index(child, absent_function) != NULL) {
         pass = false;
     }
@@ -816,9 +926,169 @@ void test_function_lookup_index(test_env* te) {
         pass = false;
     }
     delete_environment(child);
-    free(out);
-    free(not_a_function);
-    free(absent_function);
+    delete_typed_ptr(not_a_function);
+    delete_typed_ptr(absent_function);
+    delete_environment(env);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_collect_young_garbage(test_env* te) {
+    print_test_announce("collect_young_garbage()");
+    Environment* env = create_environment(0, 0, NULL);
+    typed_ptr* body;
+    bool pass = true;
+    Environment* kept_env = create_environment(0, 0, env);
+    kept_env->env_tracker_next = env->env_tracker_next;
+    env->env_tracker_next = kept_env;
+    body = create_s_expr_tp(create_empty_s_expr());
+    typed_ptr kept = install_function(env, \
+                                      "kept", \
+                                      create_function_code(NULL, body), \
+                                      kept_env);
+    blind_install_symbol(env, "k", &kept);
+    blind_install_symbol(env, "i", &(typed_ptr){.type=TYPE_UNDEF});
+    collect_young_garbage(env);
+    if (function_lookup_index(env, &kept) == NULL || \
+        !function_lookup_index(env, &kept)->gc_old || \
+        env->env_tracker_next != kept_env || \
+        !kept_env->gc_old) {
+        pass = false;
+    }
+    // a young function only reachable through an old environment, via the
+    //   write barrier
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr late = install_function(env, \
+                                      "late", \
+                                      create_function_code(NULL, body), \
+                                      env);
+    blind_install_symbol(kept_env, "i", &late);
+    if (!kept_env->gc_remembered || env->gc_remembered_next != kept_env) {
+        pass = false;
+    }
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr lost = install_function(env, \
+                                      "lost", \
+                                      create_function_code(NULL, body), \
+                                      env);
+    // old objects survive a minor collection even once they are unreachable
+    blind_install_symbol(env, "k", &(typed_ptr){.type=TYPE_FIXNUM, \
+                                                .ptr={.idx=TEST_NUM}});
+    collect_young_garbage(env);
+    if (function_lookup_index(env, &kept) == NULL || \
+        function_lookup_index(env, &late) == NULL || \
+        !function_lookup_index(env, &late)->gc_old || \
+        function_lookup_index(env, &lost) != NULL || \
+        env->function_table->length != 2 || \
+        env->env_tracker_next != kept_env || \
+        kept_env->gc_remembered || \
+        env->gc_remembered_next != NULL) {
+        pass = false;
+    }
+    collect_all_garbage(env);
+    if (function_lookup_index(env, &kept) != NULL || \
+        function_lookup_index(env, &late) != NULL || \
+        env->function_table->length != 0 || \
+        env->env_tracker_next != NULL) {
+        pass = false;
+    }
+    // the slots of collected functions are reused
+    unsigned int slots_used = env->function_table->slots_used;
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr reused = install_function(env, \
+                                        "reused", \
+                                        create_function_code(NULL, body), \
+                                        env);
+    if (env->function_table->slots_used != slots_used || \
+        function_lookup_index(env, &reused) == NULL || \
+        strcmp(function_lookup_index(env, &reused)->name, "reused")) {
+        pass = false;
+    }
+    delete_environment(env);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_collect_all_garbage(test_env* te) {
+    print_test_announce("collect_all_garbage()");
+    Environment* env = create_environment(0, 0, NULL);
+    typed_ptr* body;
+    bool pass = true;
+    // a closure bound to a global symbol, whose environment binds another
+    //   function
+    Environment* kept_env = create_environment(0, 0, env);
+    kept_env->env_tracker_next = env->env_tracker_next;
+    env->env_tracker_next = kept_env;
+    body = create_s_expr_tp(create_empty_s_expr());
+    typed_ptr kept = install_function(env, \
+                                      "kept", \
+                                      create_function_code(NULL, body), \
+                                      kept_env);
+    blind_install_symbol(env, "k", &kept);
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr inner = install_function(env, \
+                                       "inner", \
+                                       create_function_code(NULL, body), \
+                                       env);
+    blind_install_symbol(env, "i", &(typed_ptr){.type=TYPE_UNDEF});
+    blind_install_symbol(kept_env, "i", &inner);
+    // a closure nothing refers to any more
+    Environment* dropped_env = create_environment(0, 0, env);
+    dropped_env->env_tracker_next = env->env_tracker_next;
+    env->env_tracker_next = dropped_env;
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr dropped = install_function(env, \
+                                         "dropped", \
+                                         create_function_code(NULL, body), \
+                                         dropped_env);
+    // a function only reachable through a list
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr listed = install_function(env, \
+                                        "listed", \
+                                        create_function_code(NULL, body), \
+                                        env);
+    s_expr* list = create_s_expr(listed, \
+                                 s_expr_tp(create_empty_s_expr()));
+    blind_install_symbol(env, "l", &(typed_ptr){.type=TYPE_S_EXPR, \
+                                                .ptr={.se_ptr=list}});
+    collect_all_garbage(env);
+    if (function_lookup_index(env, &kept) == NULL || \
+        function_lookup_index(env, &inner) == NULL || \
+        function_lookup_index(env, &listed) == NULL || \
+        function_lookup_index(env, &dropped) != NULL || \
+        env->function_table->length != 3 || \
+        env->env_tracker_next != kept_env || \
+        kept_env->env_tracker_next != NULL) {
+        pass = false;
+    }
+    // new functions never reuse the number of a live one
+    body = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr fresh = install_function(env, \
+                                       "fresh", \
+                                       create_function_code(NULL, body), \
+                                       env);
+    if (fresh.ptr.idx == kept.ptr.idx || \
+        fresh.ptr.idx == inner.ptr.idx || \
+        fresh.ptr.idx == listed.ptr.idx) {
+        pass = false;
+    }
+    // once the closure is unbound, its environment and everything only it
+    //   could reach go too
+    blind_install_symbol(env, "k", &(typed_ptr){.type=TYPE_FIXNUM, \
+                                                .ptr={.idx=TEST_NUM}});
+    collect_all_garbage(env);
+    if (function_lookup_index(env, &kept) != NULL || \
+        function_lookup_index(env, &inner) != NULL || \
+        function_lookup_index(env, &listed) == NULL || \
+        function_lookup_index(env, &fresh) != NULL || \
+        env->function_table->length != 1 || \
+        env->env_tracker_next != NULL) {
+        pass = false;
+    }
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -9,11 +9,12 @@ void unit_tests_environment(test_env* t_env);
 void test_create_symbol_node(test_env* te);
 void test_create_error_symbol_node(test_env* te);
 void test_create_symbol_table(test_env* te);
-void test_merge_symbol_tables(test_env* te);
+void test_truncate_symbol_table(test_env* te);
 void test_delete_symbol_node_list(test_env* te);
 void test_create_function_node(test_env* te);
 void test_create_function_table(test_env* te);
 void test_create_environment(test_env* te);
+void test_create_call_frame(test_env* te);
 void test_delete_environment(test_env* te);
 void test_install_symbol_regular_and_blind(test_env* te);
 void test_install_function(test_env* te);
@@ -22,5 +23,7 @@ void test_symbol_lookup_index(test_env* te);
 void test_builtin_lookup_index(test_env* te);
 void test_value_lookup_index(test_env* te);
 void test_function_lookup_index(test_env* te);
+void test_collect_young_garbage(test_env* te);
+void test_collect_all_garbage(test_env* te);
 
 #endif
@@ -4,7 +4,6 @@ void unit_tests_evaluate(test_env* te) {
     printf("# evaluate.c #\n");
     test_collect_parameters(te);
     test_bind_args(te);
-    test_make_eval_env(te);
     test_collect_arguments(te);
     test_eval_arithmetic(te);
     test_eval_comparison(te);
@@ -29,31 +28,33 @@ void unit_tests_evaluate(test_env* te) {
     test_eval_s_expr(te);
     test_eval_function(te);
     test_evaluate(te);
+    test_evaluate_cek(te);
+    test_analyze(te);
+    test_compile(te);
     return;
 }
 
 // test helpers
 
 // NOTE: frees cmd AND expected
-bool run_test_expect(typed_ptr* (*function)(const s_expr*, Environment*), \
+bool run_test_expect(typed_ptr (*function)(const s_expr*, Environment*), \
                      s_expr* cmd, \
                      Environment* env, \
                      typed_ptr* expected) {
-    typed_ptr* out = (*function)(cmd, env);
-    bool passed = deep_match_typed_ptrs(out, expected);
+    typed_ptr out = (*function)(cmd, env);
+    bool passed = deep_match_typed_ptrs(&out, expected);
     delete_s_expr_recursive(cmd, true);
-    if (out != NULL && out->type == TYPE_S_EXPR) {
-        delete_s_expr_recursive(out->ptr.se_ptr, true);
-    } else if (out != NULL && out->type == TYPE_STRING) {
-        delete_string(out->ptr.string);
+    if (out.type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(out.ptr.se_ptr, true);
+    } else if (out.type == TYPE_STRING) {
+        delete_string(out.ptr.string);
     }
-    free(out);
     if (expected != NULL && expected->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(expected->ptr.se_ptr, true);
     } else if (expected != NULL && expected->type == TYPE_STRING) {
         delete_string(expected->ptr.string);
     }
-    free(expected);
+    delete_typed_ptr(expected);
     return passed;
 }
 
@@ -128,7 +129,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a list whose middle car is not a symbol
     typed_ptr thousand = {.type=TYPE_FIXNUM, .ptr={.idx=1000}};
     typed_ptr *sym_1, *sym_2, *sym_3;
@@ -149,7 +150,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a list whose last car is not a symbol
     se_tp = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(se_tp->ptr.se_ptr, copy_typed_ptr(sym_1));
@@ -165,10 +166,10 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a pair
-    se_tp = create_s_expr_tp(create_s_expr(copy_typed_ptr(sym_1), \
-                                           copy_typed_ptr(sym_2)));
+    se_tp = create_s_expr_tp(create_s_expr(*sym_1, \
+                                           *sym_2));
     params = collect_parameters(se_tp, env);
     if (params == NULL || \
         params->type != TYPE_ERROR || \
@@ -179,7 +180,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a valid lone symbol
     se_tp = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(se_tp->ptr.se_ptr, copy_typed_ptr(sym_1));
@@ -193,7 +194,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a lone invalid symbol
     se_tp = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(se_tp->ptr.se_ptr, create_atom_tp(TYPE_SYMBOL, 1000));
@@ -207,7 +208,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a list of valid symbols
     se_tp = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(se_tp->ptr.se_ptr, copy_typed_ptr(sym_1));
@@ -229,7 +230,7 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     // pass a list of valid symbols, within a non-global environment
     Environment* child = create_environment(0, 0, env);
     se_tp = create_s_expr_tp(create_empty_s_expr());
@@ -252,12 +253,12 @@ void test_collect_parameters(test_env* te) {
     delete_symbol_node_list(params);
     params = NULL;
     delete_s_expr_recursive(se_tp->ptr.se_ptr, true);
-    free(se_tp);
+    delete_typed_ptr(se_tp);
     delete_environment(child);
     delete_environment(env);
-    free(sym_1);
-    free(sym_2);
-    free(sym_3);
+    delete_typed_ptr(sym_1);
+    delete_typed_ptr(sym_2);
+    delete_typed_ptr(sym_3);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -267,62 +268,60 @@ void test_collect_parameters(test_env* te) {
 void test_bind_args(test_env* te) {
     print_test_announce("bind_args()");
     bool pass = true;
+    Environment* env = create_environment(0, 0, NULL);
     // no params, no args
-    Function_Node* fn_no_params = create_function_node(0, "", NULL, NULL, NULL);
+    Function_Code* fn_no_params = \
+        create_function_code(NULL, create_atom_tp(TYPE_FIXNUM, 1));
     typed_ptr* empty_args = create_s_expr_tp(create_empty_s_expr());
-    Symbol_Node* bound_args = bind_args(fn_no_params, empty_args);
-    if (bound_args != NULL) {
+    Environment* frame = create_call_frame(fn_no_params, env);
+    typed_ptr out = bind_args(frame, empty_args);
+    if (out.type != TYPE_VOID) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // no params, one arg
     typed_ptr* one_arg = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(one_arg->ptr.se_ptr, create_atom_tp(TYPE_FIXNUM, 1000));
-    bound_args = bind_args(fn_no_params, one_arg);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_MANY_ARGS || \
-        bound_args->next != NULL) {
+    frame = create_call_frame(fn_no_params, env);
+    out = bind_args(frame, one_arg);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_MANY_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // one param, no args
     Symbol_Node* one_param = create_symbol_node(0, \
                                                 "x", \
                                                 TYPE_UNDEF, \
                                                 (tp_value){.idx=0});
-    Function_Node* fn_1_param = create_function_node(0, "", one_param, NULL, NULL);
-    bound_args = bind_args(fn_1_param, empty_args);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_FEW_ARGS || \
-        bound_args->next != NULL) {
+    Function_Code* fn_1_param = \
+        create_function_code(one_param, create_atom_tp(TYPE_FIXNUM, 1));
+    frame = create_call_frame(fn_1_param, env);
+    out = bind_args(frame, empty_args);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_FEW_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // one param, one arg
-    bound_args = bind_args(fn_1_param, one_arg);
-    if (bound_args == NULL || \
-        strcmp(bound_args->name, "x") || \
-        bound_args->type != TYPE_FIXNUM || \
-        bound_args->value.idx != 1000 || \
-        bound_args->next != NULL) {
+    frame = create_call_frame(fn_1_param, env);
+    out = bind_args(frame, one_arg);
+    if (out.type != TYPE_VOID || \
+        strcmp(frame->slots[0].name, "x") || \
+        frame->slots[0].type != TYPE_FIXNUM || \
+        frame->slots[0].value.idx != 1000) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // one param, two args
     typed_ptr* two_args = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(two_args->ptr.se_ptr, create_atom_tp(TYPE_FIXNUM, 1000));
     s_expr* se = create_empty_s_expr();
     s_expr_append(two_args->ptr.se_ptr, create_s_expr_tp(se));
-    bound_args = bind_args(fn_1_param, two_args);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_MANY_ARGS || \
-        bound_args->next != NULL) {
+    frame = create_call_frame(fn_1_param, env);
+    out = bind_args(frame, two_args);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_MANY_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // two params, no args
     Symbol_Node* two_params = create_symbol_node(0, \
                                                  "x", \
@@ -332,184 +331,74 @@ void test_bind_args(test_env* te) {
                                           "y", \
                                           TYPE_UNDEF, \
                                           (tp_value){.idx=0});
-    Function_Node* fn_2_params = create_function_node(0, \
-                                                      "", \
-                                                      two_params, \
-                                                      NULL, \
-                                                      NULL);
-    bound_args = bind_args(fn_2_params, empty_args);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_FEW_ARGS || \
-        bound_args->next != NULL) {
+    Function_Code* fn_2_params = \
+        create_function_code(two_params, create_atom_tp(TYPE_FIXNUM, 1));
+    frame = create_call_frame(fn_2_params, env);
+    out = bind_args(frame, empty_args);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_FEW_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // two params, one arg
-    bound_args = bind_args(fn_2_params, one_arg);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_FEW_ARGS || \
-        bound_args->next != NULL) {
+    frame = create_call_frame(fn_2_params, env);
+    out = bind_args(frame, one_arg);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_FEW_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
-    // two params, two args
-    bound_args = bind_args(fn_2_params, two_args);
-    if (bound_args == NULL || \
-        strcmp(bound_args->name, "y") || \
-        bound_args->type != TYPE_S_EXPR || \
-        bound_args->value.se_ptr == se || \
-        !is_empty_list(bound_args->value.se_ptr) || \
-        bound_args->next == NULL || \
-        strcmp(bound_args->next->name, "x") || \
-        bound_args->next->type != TYPE_FIXNUM || \
-        bound_args->next->value.idx != 1000 || \
-        bound_args->next->next != NULL) {
+    delete_environment(frame);
+    // two params, two args (the list is shared with the frame)
+    frame = create_call_frame(fn_2_params, env);
+    out = bind_args(frame, two_args);
+    if (out.type != TYPE_VOID || \
+        strcmp(frame->slots[0].name, "x") || \
+        frame->slots[0].type != TYPE_FIXNUM || \
+        frame->slots[0].value.idx != 1000 || \
+        strcmp(frame->slots[1].name, "y") || \
+        frame->slots[1].type != TYPE_S_EXPR || \
+        frame->slots[1].value.se_ptr != se || \
+        !is_empty_list(frame->slots[1].value.se_ptr) || \
+        se->refs != 2) {
         pass = false;
     }
-    for (Symbol_Node* arg = bound_args; arg != NULL; arg = arg->next) {
-        if (arg->type == TYPE_S_EXPR) {
-            delete_s_expr_recursive(arg->value.se_ptr, true);
-        }
-    }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // two params, three args
     typed_ptr* three_args = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(three_args->ptr.se_ptr, create_atom_tp(TYPE_FIXNUM, 1000));
     s_expr_append(three_args->ptr.se_ptr, create_atom_tp(TYPE_BOOL, true));
     s_expr_append(three_args->ptr.se_ptr, create_number_tp(2000));
-    bound_args = bind_args(fn_2_params, three_args);
-    if (bound_args == NULL || \
-        bound_args->type != TYPE_ERROR || \
-        bound_args->value.idx != EVAL_ERROR_MANY_ARGS || \
-        bound_args->next != NULL) {
+    frame = create_call_frame(fn_2_params, env);
+    out = bind_args(frame, three_args);
+    if (out.type != TYPE_ERROR || out.ptr.idx != EVAL_ERROR_MANY_ARGS) {
         pass = false;
     }
-    delete_symbol_node_list(bound_args);
+    delete_environment(frame);
     // two params, two args (including a string)
     delete_s_expr_recursive(two_args->ptr.se_ptr, true);
     two_args->ptr.se_ptr = unit_list(create_number_tp(1000));
     String* str = create_string("test");
     s_expr_append(two_args->ptr.se_ptr, create_string_tp(str));
-    bound_args = bind_args(fn_2_params, two_args);
-    if (bound_args == NULL || \
-        strcmp(bound_args->name, "y") || \
-        bound_args->type != TYPE_STRING || \
-        strcmp(bound_args->value.string->contents, "test") || \
-        bound_args->value.string == str || \
-        bound_args->next == NULL || \
-        strcmp(bound_args->next->name, "x") || \
-        bound_args->next->type != TYPE_FIXNUM || \
-        bound_args->next->value.idx != 1000 || \
-        bound_args->next->next != NULL) {
+    frame = create_call_frame(fn_2_params, env);
+    out = bind_args(frame, two_args);
+    if (out.type != TYPE_VOID || \
+        frame->slots[0].type != TYPE_FIXNUM || \
+        frame->slots[0].value.idx != 1000 || \
+        frame->slots[1].type != TYPE_STRING || \
+        strcmp(frame->slots[1].value.string->contents, "test") || \
+        frame->slots[1].value.string != str) {
         pass = false;
     }
-    for (Symbol_Node* arg = bound_args; arg != NULL; arg = arg->next) {
-        if (arg->type == TYPE_STRING) {
-            delete_string(arg->value.string);
-        }
-    }
-    delete_symbol_node_list(bound_args);
-    free(fn_no_params->name);
-    free(fn_no_params);
+    delete_environment(frame);
+    delete_function_code(fn_no_params);
     delete_s_expr_recursive(empty_args->ptr.se_ptr, true);
-    free(empty_args);
+    delete_typed_ptr(empty_args);
     delete_s_expr_recursive(one_arg->ptr.se_ptr, true);
-    free(one_arg);
-    delete_symbol_node_list(one_param);
-    free(fn_1_param->name);
-    free(fn_1_param);
+    delete_typed_ptr(one_arg);
+    delete_function_code(fn_1_param);
     delete_s_expr_recursive(two_args->ptr.se_ptr, true);
-    free(two_args);
-    delete_symbol_node_list(two_params);
-    free(fn_2_params->name);
-    free(fn_2_params);
+    delete_typed_ptr(two_args);
+    delete_function_code(fn_2_params);
     delete_s_expr_recursive(three_args->ptr.se_ptr, true);
-    free(three_args);
-    print_test_result(pass);
-    te->passed += pass;
-    te->run++;
-    return;
-}
-
-void test_make_eval_env(test_env* te) {
-    print_test_announce("make_eval_env()");
-    bool pass = true;
-    // empty list of bound args
-    Environment* env = create_environment(0, 0, NULL);
-    blind_install_symbol(env, "x", &undef);
-    blind_install_symbol(env, "y", &undef);
-    blind_install_symbol(env, "z", &undef);
-    Symbol_Node* args = NULL;
-    Environment* out = make_eval_env(env, args);
-    if (out == env || \
-        out->enclosing_env != env || \
-        out->env_tracker_next != NULL || \
-        symbol_lookup_name(env, "x") == NULL || \
-        symbol_lookup_name(env, "x")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "y") == NULL || \
-        symbol_lookup_name(env, "y")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "z") == NULL || \
-        symbol_lookup_name(env, "z")->type != TYPE_UNDEF || \
-        symbol_lookup_name(out, "x") != NULL || \
-        symbol_lookup_name(out, "y") != NULL || \
-        symbol_lookup_name(out, "z") != NULL) {
-        pass = false;
-    }
-    delete_environment(out);
-    // one bound arg
-    args = create_symbol_node(0, "x", TYPE_FIXNUM, (tp_value){.idx=1000});
-    out = make_eval_env(env, args);
-    if (out == env || \
-        out->enclosing_env != env || \
-        out->env_tracker_next != NULL || \
-        symbol_lookup_name(env, "x") == symbol_lookup_name(out, "x") || \
-        symbol_lookup_name(env, "x") == NULL || \
-        symbol_lookup_name(env, "x")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "y") == NULL || \
-        symbol_lookup_name(env, "y")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "z") == NULL || \
-        symbol_lookup_name(env, "z")->type != TYPE_UNDEF || \
-        symbol_lookup_name(out, "x") == NULL || \
-        symbol_lookup_name(out, "x")->type != TYPE_FIXNUM || \
-        symbol_lookup_name(out, "x")->value.idx != 1000 || \
-        symbol_lookup_name(out, "y") != NULL || \
-        symbol_lookup_name(out, "z") != NULL) {
-        pass = false;
-    }
-    delete_environment(out);
-    // two bound args
-    args->value.idx = 2000;
-    s_expr* se = create_empty_s_expr();
-    args->next = create_symbol_node(0, \
-                                    "y", \
-                                    TYPE_S_EXPR, \
-                                    (tp_value){.se_ptr=se});
-    out = make_eval_env(env, args);
-    if (out == env || \
-        out->enclosing_env != env || \
-        out->env_tracker_next != NULL || \
-        symbol_lookup_name(env, "x") == symbol_lookup_name(out, "x") || \
-        symbol_lookup_name(env, "y") == symbol_lookup_name(out, "y") || \
-        symbol_lookup_name(env, "x") == NULL || \
-        symbol_lookup_name(env, "x")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "y") == NULL || \
-        symbol_lookup_name(env, "y")->type != TYPE_UNDEF || \
-        symbol_lookup_name(env, "z") == NULL || \
-        symbol_lookup_name(env, "z")->type != TYPE_UNDEF || \
-        symbol_lookup_name(out, "x") == NULL || \
-        symbol_lookup_name(out, "x")->type != TYPE_FIXNUM || \
-        symbol_lookup_name(out, "x")->value.idx != 2000 || \
-        symbol_lookup_name(out, "y") == NULL || \
-        symbol_lookup_name(out, "y")->type != TYPE_S_EXPR || \
-        symbol_lookup_name(out, "y")->value.se_ptr != se || \
-        !is_empty_list(symbol_lookup_name(out, "y")->value.se_ptr) || \
-        symbol_lookup_name(out, "z") != NULL) {
-        pass = false;
-    }
-    delete_environment(out);
-    delete_symbol_node_list(args);
+    delete_typed_ptr(three_args);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -522,312 +411,245 @@ void test_collect_arguments(test_env* te) {
     bool pass = true;
     Environment* env = create_environment(0, 0, NULL);
     setup_environment(env);
-    s_expr empty_s_expr = {NULL, NULL};
+    s_expr empty_s_expr = {.car=none_tp(), .cdr=none_tp()};
     typed_ptr empty_se_tp = {.type=TYPE_S_EXPR, .ptr={.se_ptr=&empty_s_expr}};
     // arg s-expr is a pair -> error
-    s_expr* call_pair = create_s_expr(create_atom_tp(TYPE_BUILTIN, 0), \
-                                      create_atom_tp(TYPE_FIXNUM, 1000));
-    typed_ptr* out = collect_arguments(call_pair, env, 0, -1, true);
-    if (!check_error(out, EVAL_ERROR_ILLEGAL_PAIR)) {
+    s_expr* call_pair = create_s_expr(atom_tp(TYPE_BUILTIN, 0), \
+                                      atom_tp(TYPE_FIXNUM, 1000));
+    typed_ptr out = collect_arguments(call_pair, env, 0, -1, true);
+    if (!check_error(&out, EVAL_ERROR_ILLEGAL_PAIR)) {
         pass = false;
     }
     delete_s_expr_recursive(call_pair, true);
-    free(out);
     // arg s-expr ends in a pair
     s_expr* call_bad_list = create_empty_s_expr();
     s_expr_append(call_bad_list, create_atom_tp(TYPE_BUILTIN, 0));
-    s_expr_next(call_bad_list)->car = create_atom_tp(TYPE_FIXNUM, 1000);
-    s_expr_next(call_bad_list)->cdr = create_atom_tp(TYPE_FIXNUM, 2000);
+    s_expr_next(call_bad_list)->car = atom_tp(TYPE_FIXNUM, 1000);
+    s_expr_next(call_bad_list)->cdr = atom_tp(TYPE_FIXNUM, 2000);
     out = collect_arguments(call_bad_list, env, 0, -1, true);
-    if (!check_error(out, EVAL_ERROR_ILLEGAL_PAIR)) {
+    if (!check_error(&out, EVAL_ERROR_ILLEGAL_PAIR)) {
         pass = false;
     }
     delete_s_expr_recursive(call_bad_list, true);
-    free(out);
     // empty arg s-expr, with min_args == 0 & max_args == 0
     s_expr* call_no_args = create_empty_s_expr();
     s_expr_append(call_no_args, create_atom_tp(TYPE_BUILTIN, 0));
     out = collect_arguments(call_no_args, env, 0, 0, true);
-    if (!deep_match_typed_ptrs(out, &empty_se_tp) || \
-        out->ptr.se_ptr == s_expr_next(call_no_args)) {
+    if (!deep_match_typed_ptrs(&out, &empty_se_tp) || \
+        out.ptr.se_ptr == s_expr_next(call_no_args)) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     //    -> and without evaluate_all_args
     out = collect_arguments(call_no_args, env, 0, 0, false);
-    if (!deep_match_typed_ptrs(out, &empty_se_tp) || \
-        out->ptr.se_ptr == s_expr_next(call_no_args)) {
+    if (!deep_match_typed_ptrs(&out, &empty_se_tp) || \
+        out.ptr.se_ptr == s_expr_next(call_no_args)) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // empty arg s-expr, with min_args == 0 & max_args > 0
     out = collect_arguments(call_no_args, env, 0, 1, true);
-    if (!deep_match_typed_ptrs(out, &empty_se_tp) || \
-        out->ptr.se_ptr == s_expr_next(call_no_args)) {
+    if (!deep_match_typed_ptrs(&out, &empty_se_tp) || \
+        out.ptr.se_ptr == s_expr_next(call_no_args)) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // empty arg s-expr, with min_args == 0 & max_args < 0
     out = collect_arguments(call_no_args, env, 0, -1, true);
-    if (!deep_match_typed_ptrs(out, &empty_se_tp) || \
-        out->ptr.se_ptr == s_expr_next(call_no_args)) {
+    if (!deep_match_typed_ptrs(&out, &empty_se_tp) || \
+        out.ptr.se_ptr == s_expr_next(call_no_args)) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // empty arg s-expr, with min_args > 0
     out = collect_arguments(call_no_args, env, 1, 1, true);
-    if (!check_error(out, EVAL_ERROR_FEW_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_FEW_ARGS)) {
         pass = false;
     }
-    free(out);
     delete_s_expr_recursive(call_no_args, true);
     // one-elt arg s-expr, with min_args == 0 & max_args == 0
     s_expr* call_one_arg = create_empty_s_expr();
     s_expr_append(call_one_arg, create_atom_tp(TYPE_BUILTIN, 0));
-    typed_ptr* value_1 = create_atom_tp(TYPE_FIXNUM, 1000);
-    s_expr_append(call_one_arg, value_1);
+    s_expr_append(call_one_arg, create_atom_tp(TYPE_FIXNUM, 1000));
     out = collect_arguments(call_one_arg, env, 0, 0, true);
-    if (!check_error(out, EVAL_ERROR_MANY_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_MANY_ARGS)) {
         pass = false;
     }
-    free(out);
     // one-elt arg s-expr, with min_args == 0 & max_args == 1
     out = collect_arguments(call_one_arg, env, 0, 1, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     //    -> and without evaluate_all_args
     out = collect_arguments(call_one_arg, env, 0, 1, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 0 & max_args == 2
     out = collect_arguments(call_one_arg, env, 0, 2, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 0 & max_args == -1
     out = collect_arguments(call_one_arg, env, 0, -1, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 1 & max_args == 1
     out = collect_arguments(call_one_arg, env, 1, 1, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 1 & max_args == 1, with a string
     s_expr* call_one_arg_string = unit_list(create_atom_tp(TYPE_BUILTIN, 0));
     String* str = create_string("test");
     s_expr_append(call_one_arg_string, create_string_tp(str));
     out = collect_arguments(call_one_arg_string, env, 1, 1, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg_string)) || \
-        out->ptr.se_ptr->car->ptr.string == str) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg_string)) || \
+        out.ptr.se_ptr->car.ptr.string != str) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     delete_s_expr_recursive(call_one_arg_string, true);
     // one-elt arg s-expr, with min_args == 1 & max_args == 2
     out = collect_arguments(call_one_arg, env, 1, 2, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 1 & max_args == -1
     out = collect_arguments(call_one_arg, env, 1, -1, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_one_arg)) || \
-        out->ptr.se_ptr->car == value_1) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_one_arg))) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     // one-elt arg s-expr, with min_args == 2 & max_args == 2
     out = collect_arguments(call_one_arg, env, 2, 2, true);
-    if (!check_error(out, EVAL_ERROR_FEW_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_FEW_ARGS)) {
         pass = false;
     }
-    free(out);
     // one-elt arg s-expr, with min_args == 2 & max_args == -1
     out = collect_arguments(call_one_arg, env, 2, -1, true);
-    if (!check_error(out, EVAL_ERROR_FEW_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_FEW_ARGS)) {
         pass = false;
     }
-    free(out);
     delete_s_expr_recursive(call_one_arg, true);
     // two-elt arg s-expr, with min_args == 0 & max_args == 0
     s_expr* call_two_args = create_empty_s_expr();
     s_expr_append(call_two_args, create_atom_tp(TYPE_BUILTIN, 0));
-    value_1 = create_atom_tp(TYPE_FIXNUM, 1000);
-    s_expr_append(call_two_args, value_1);
-    typed_ptr* value_2 = create_s_expr_tp(create_empty_s_expr());
-    s_expr_append(value_2->ptr.se_ptr, create_atom_tp(TYPE_BOOL, true));
-    s_expr_append(call_two_args, value_2);
+    s_expr_append(call_two_args, create_atom_tp(TYPE_FIXNUM, 1000));
+    s_expr* value_2 = create_empty_s_expr();
+    s_expr_append(value_2, create_atom_tp(TYPE_BOOL, true));
+    s_expr_append(call_two_args, create_s_expr_tp(value_2));
     out = collect_arguments(call_two_args, env, 0, 0, false);
-    if (!check_error(out, EVAL_ERROR_MANY_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_MANY_ARGS)) {
         pass = false;
     }
-    free(out);
     // two-elt arg s-expr, with min_args == 0 & max_args == 1
     out = collect_arguments(call_two_args, env, 0, 1, false);
-    if (!check_error(out, EVAL_ERROR_MANY_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_MANY_ARGS)) {
         pass = false;
     }
-    free(out);
     // two-elt arg s-expr, with min_args == 0 & max_args == 2
     out = collect_arguments(call_two_args, env, 0, 2, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 0 & max_args == 3
     out = collect_arguments(call_two_args, env, 0, 3, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 0 & max_args == -1
     out = collect_arguments(call_two_args, env, 0, -1, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 1 & max_args == 1
     out = collect_arguments(call_two_args, env, 1, 1, false);
-    if (!check_error(out, EVAL_ERROR_MANY_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_MANY_ARGS)) {
         pass = false;
     }
-    free(out);
     // two-elt arg s-expr, with min_args == 1 & max_args == 2
     out = collect_arguments(call_two_args, env, 1, 2, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 1 & max_args == 3
     out = collect_arguments(call_two_args, env, 1, 3, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 1 & max_args == -1
     out = collect_arguments(call_two_args, env, 1, -1, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 2 & max_args == 2
     out = collect_arguments(call_two_args, env, 2, 2, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 2 & max_args == 3
     out = collect_arguments(call_two_args, env, 2, 3, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 2 & max_args == -1
     out = collect_arguments(call_two_args, env, 2, -1, false);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, s_expr_next(call_two_args)) || \
-        out->ptr.se_ptr->car == value_1 || \
-        s_expr_next(out->ptr.se_ptr)->car->ptr.se_ptr != value_2->ptr.se_ptr) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, s_expr_next(call_two_args)) || \
+        s_expr_next(out.ptr.se_ptr)->car.ptr.se_ptr != value_2) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, false);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, false);
     // two-elt arg s-expr, with min_args == 3 & max_args == 3
     out = collect_arguments(call_two_args, env, 3, 3, false);
-    if (!check_error(out, EVAL_ERROR_FEW_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_FEW_ARGS)) {
         pass = false;
     }
-    free(out);
     // two-elt arg s-expr, with min_args == 3 & max_args == -1
     out = collect_arguments(call_two_args, env, 3, -1, false);
-    if (!check_error(out, EVAL_ERROR_FEW_ARGS)) {
+    if (!check_error(&out, EVAL_ERROR_FEW_ARGS)) {
         pass = false;
     }
-    free(out);
     delete_s_expr_recursive(call_two_args, true);
     // and with evaluating
     s_expr* addition_arg = create_empty_s_expr();
@@ -849,13 +671,11 @@ void test_collect_arguments(test_env* te) {
     s_expr_append(list_result, create_atom_tp(TYPE_BOOL, true));
     s_expr_append(expected, create_s_expr_tp(list_result));
     out = collect_arguments(call_with_eval, env, 2, 2, true);
-    if (out == NULL || \
-        out->type != TYPE_S_EXPR || \
-        !match_s_exprs(out->ptr.se_ptr, expected)) {
+    if (out.type != TYPE_S_EXPR || \
+        !match_s_exprs(out.ptr.se_ptr, expected)) {
         pass = false;
     }
-    delete_s_expr_recursive(out->ptr.se_ptr, true);
-    free(out);
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
     delete_s_expr_recursive(expected, true);
     // with evaluating but an error
     s_expr* plus_error = create_empty_s_expr();
@@ -864,10 +684,9 @@ void test_collect_arguments(test_env* te) {
     s_expr_append(plus_error, create_atom_tp(TYPE_BOOL, false));
     s_expr_append(call_with_eval, create_s_expr_tp(plus_error));
     out = collect_arguments(call_with_eval, env, 3, 3, true);
-    if (!check_error(out, EVAL_ERROR_NEED_NUM)) {
+    if (!check_error(&out, EVAL_ERROR_NEED_NUM)) {
         pass = false;
     }
-    free(out);
     delete_s_expr_recursive(call_with_eval, true);
     delete_environment(env);
     print_test_result(pass);
@@ -884,18 +703,19 @@ void test_eval_arithmetic(test_env* te) {
     #define NUM_OPS 4
     typed_ptr* arith_ops[NUM_OPS] = {ADD, SUBTRACT, MULTIPLY, DIVIDE};
     // (+ . 1) -> EVAL_ERROR_ILLEGAL_PAIR
-    s_expr* cmd = create_s_expr(ADD, create_number_tp(1));
+    s_expr* cmd = create_s_expr(atom_tp(TYPE_BUILTIN, BUILTIN_ADD), \
+                                atom_tp(TYPE_FIXNUM, 1));
     typed_ptr* expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_arithmetic, cmd, env, expected) && pass;
     // (+ 1 . 2) -> EVAL_ERROR_ILLEGAL_PAIR
-    cmd = create_s_expr(create_number_tp(1), create_number_tp(2));
-    cmd = create_s_expr(ADD, create_s_expr_tp(cmd));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_FIXNUM, 2));
+    cmd = create_s_expr(atom_tp(TYPE_BUILTIN, BUILTIN_ADD), s_expr_tp(cmd));
     expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_arithmetic, cmd, env, expected) && pass;
     // (+ 1 2 . 3) -> EVAL_ERROR_ILLEGAL_PAIR
-    cmd = create_s_expr(create_number_tp(2), create_number_tp(3));
-    cmd = create_s_expr(create_number_tp(1), create_s_expr_tp(cmd));
-    cmd = create_s_expr(ADD, create_s_expr_tp(cmd));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 2), atom_tp(TYPE_FIXNUM, 3));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 1), s_expr_tp(cmd));
+    cmd = create_s_expr(atom_tp(TYPE_BUILTIN, BUILTIN_ADD), s_expr_tp(cmd));
     expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_arithmetic, cmd, env, expected) && pass;
     // (+) -> 0
@@ -1218,7 +1038,7 @@ void test_eval_arithmetic(test_env* te) {
     delete_environment(env);
     delete_s_expr_recursive(add_two_two, true);
     for (unsigned int i = 0; i < NUM_OPS; i++) {
-        free(arith_ops[i]);
+        delete_typed_ptr(arith_ops[i]);
     }
     #undef NUM_OPS
     print_test_result(pass);
@@ -1246,18 +1066,18 @@ void test_eval_comparison(test_env* te) {
     #define NUM_OPS 5
     typed_ptr* compare_ops[NUM_OPS] = {eq_tp, lt_tp, gt_tp, le_tp, ge_tp};
     // (= . 1) -> EVAL_ERROR_ILLEGAL_PAIR
-    s_expr* cmd = create_s_expr(copy_typed_ptr(eq_tp), create_number_tp(1));
+    s_expr* cmd = create_s_expr(*eq_tp, atom_tp(TYPE_FIXNUM, 1));
     typed_ptr* expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_comparison, cmd, env, expected) && pass;
     // (= 1 . 2) -> EVAL_ERROR_ILLEGAL_PAIR
-    cmd = create_s_expr(create_number_tp(1), create_number_tp(2));
-    cmd = create_s_expr(copy_typed_ptr(eq_tp), create_s_expr_tp(cmd));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_FIXNUM, 2));
+    cmd = create_s_expr(*eq_tp, s_expr_tp(cmd));
     expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_comparison, cmd, env, expected) && pass;
     // (= 1 2 . 3) -> EVAL_ERROR_ILLEGAL_PAIR
-    cmd = create_s_expr(create_number_tp(2), create_number_tp(3));
-    cmd = create_s_expr(create_number_tp(1), create_s_expr_tp(cmd));
-    cmd = create_s_expr(copy_typed_ptr(eq_tp), create_s_expr_tp(cmd));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 2), atom_tp(TYPE_FIXNUM, 3));
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 1), s_expr_tp(cmd));
+    cmd = create_s_expr(*eq_tp, s_expr_tp(cmd));
     expected = create_error_tp(EVAL_ERROR_ILLEGAL_PAIR);
     pass = run_test_expect(eval_comparison, cmd, env, expected) && pass;
     // (<compare op>) -> EVAL_ERROR_FEW_ARGS
@@ -1436,11 +1256,11 @@ void test_eval_comparison(test_env* te) {
         expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
         pass = run_test_expect(eval_comparison, cmd, env, expected) && pass;
     }
-    free(eq_tp);
-    free(lt_tp);
-    free(gt_tp);
-    free(le_tp);
-    free(ge_tp);
+    delete_typed_ptr(eq_tp);
+    delete_typed_ptr(lt_tp);
+    delete_typed_ptr(gt_tp);
+    delete_typed_ptr(le_tp);
+    delete_typed_ptr(ge_tp);
     delete_environment(env);
     delete_s_expr_recursive(subtract_three_two, true);
     #undef NUM_OPS
@@ -1500,8 +1320,8 @@ void test_eval_cons(test_env* te) {
     cmd = unit_list(copy_typed_ptr(cons));
     s_expr_append(cmd, create_number_tp(1));
     s_expr_append(cmd, create_atom_tp(TYPE_BOOL, true));
-    expected = create_s_expr_tp(create_s_expr(create_number_tp(1), \
-                                              create_atom_tp(TYPE_BOOL, true)));
+    expected = create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 1), \
+                                              atom_tp(TYPE_BOOL, true)));
     pass = run_test_expect(eval_cons, cmd, env, expected) && pass;
     // (cons 1 #t 2) -> EVAL_ERROR_MANY_ARGS
     cmd = unit_list(copy_typed_ptr(cons));
@@ -1517,15 +1337,15 @@ void test_eval_cons(test_env* te) {
     s_expr_append(subtract_three_one, create_number_tp(1));
     s_expr_append(cmd, create_s_expr_tp(copy_s_expr(subtract_three_one)));
     s_expr_append(cmd, create_atom_tp(TYPE_BOOL, true));
-    expected = create_s_expr_tp(create_s_expr(create_number_tp(2), \
-                                              create_atom_tp(TYPE_BOOL, true)));
+    expected = create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                                              atom_tp(TYPE_BOOL, true)));
     pass = run_test_expect(eval_cons, cmd, env, expected) && pass;
     // (cons #t (- 3 1)) -> '(#t . 2)
     cmd = unit_list(copy_typed_ptr(cons));
     s_expr_append(cmd, create_atom_tp(TYPE_BOOL, true));
     s_expr_append(cmd, create_s_expr_tp(copy_s_expr(subtract_three_one)));
-    expected = create_s_expr_tp(create_s_expr(create_atom_tp(TYPE_BOOL, true), \
-                                              create_number_tp(2)));
+    expected = create_s_expr_tp(create_s_expr(atom_tp(TYPE_BOOL, true), \
+                                              atom_tp(TYPE_FIXNUM, 2)));
     pass = run_test_expect(eval_cons, cmd, env, expected) && pass;
     // (cons TEST_ERROR_DUMMY 1) -> TEST_ERROR_DUMMY
     cmd = unit_list(copy_typed_ptr(cons));
@@ -1565,7 +1385,7 @@ void test_eval_cons(test_env* te) {
     s_expr_append(expected->ptr.se_ptr, create_number_tp(2));
     s_expr_append(expected->ptr.se_ptr, create_number_tp(3));
     pass = run_test_expect(eval_cons, cmd, env, expected) && pass;
-    free(cons);
+    delete_typed_ptr(cons);
     delete_environment(env);
     delete_s_expr_recursive(subtract_three_one, true);
     print_test_result(pass);
@@ -1650,8 +1470,8 @@ void test_eval_car_cdr(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_car_cdr, cmd, env, expected) && pass;
     delete_environment(env);
-    free(car);
-    free(cdr);
+    delete_typed_ptr(car);
+    delete_typed_ptr(cdr);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -1713,7 +1533,7 @@ void test_eval_list_construction(test_env* te) {
     s_expr_append(expected->ptr.se_ptr, create_number_tp(2));
     pass = run_test_expect(eval_list_construction, cmd, env, expected) && pass;
     delete_environment(env);
-    free(list);
+    delete_typed_ptr(list);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -1841,13 +1661,11 @@ void test_eval_and_or(test_env* te) {
     s_expr_append(cmd, create_s_expr_tp(define_x_two));
     expected = create_void_tp();
     pass = run_test_expect(eval_and_or, cmd, env, expected) && pass;
-    typed_ptr* curr_x_val = value_lookup_index(env, x_sym);
-    if (curr_x_val == NULL || \
-        curr_x_val->type != TYPE_FIXNUM || \
-        curr_x_val->ptr.idx != 2) {
+    typed_ptr curr_x_val = value_lookup_index(env, x_sym);
+    if (curr_x_val.type != TYPE_FIXNUM || \
+        curr_x_val.ptr.idx != 2) {
         pass = false;
     }
-    free(curr_x_val);
     // (and (define x 3) #f (define x 4)) -> #f AND SIDE EFFECT x == 3
     cmd = unit_list(copy_typed_ptr(and_builtin));
     s_expr* define_x_three = unit_list(copy_typed_ptr(define_sym));
@@ -1862,12 +1680,10 @@ void test_eval_and_or(test_env* te) {
     expected = create_atom_tp(TYPE_BOOL, false);
     pass = run_test_expect(eval_and_or, cmd, env, expected) && pass;
     curr_x_val = value_lookup_index(env, x_sym);
-    if (curr_x_val == NULL || \
-        curr_x_val->type != TYPE_FIXNUM || \
-        curr_x_val->ptr.idx != 3) {
+    if (curr_x_val.type != TYPE_FIXNUM || \
+        curr_x_val.ptr.idx != 3) {
         pass = false;
     }
-    free(curr_x_val);
     // (and TEST_ERROR_DUMMY #t) -> TEST_ERROR_DUMMY
     cmd = unit_list(copy_typed_ptr(and_builtin));
     s_expr_append(cmd, create_error_tp(TEST_ERROR_DUMMY));
@@ -2005,12 +1821,10 @@ void test_eval_and_or(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_and_or, cmd, env, expected) && pass;
     curr_x_val = value_lookup_index(env, x_sym);
-    if (curr_x_val == NULL || \
-        curr_x_val->type != TYPE_FIXNUM || \
-        curr_x_val->ptr.idx != 6) {
+    if (curr_x_val.type != TYPE_FIXNUM || \
+        curr_x_val.ptr.idx != 6) {
         pass = false;
     }
-    free(curr_x_val);
     // (or (define x 7) (define x 8)) -> <void> AND SIDE EFFECT x == 7
     cmd = unit_list(copy_typed_ptr(or_builtin));
     s_expr* define_x_seven = unit_list(copy_typed_ptr(define_sym));
@@ -2024,12 +1838,10 @@ void test_eval_and_or(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_and_or, cmd, env, expected) && pass;
     curr_x_val = value_lookup_index(env, x_sym);
-    if (curr_x_val == NULL || \
-        curr_x_val->type != TYPE_FIXNUM || \
-        curr_x_val->ptr.idx != 7) {
+    if (curr_x_val.type != TYPE_FIXNUM || \
+        curr_x_val.ptr.idx != 7) {
         pass = false;
     }
-    free(curr_x_val);
     // (or TEST_ERROR_DUMMY #f) -> TEST_ERROR_DUMMY
     cmd = unit_list(copy_typed_ptr(or_builtin));
     s_expr_append(cmd, create_error_tp(TEST_ERROR_DUMMY));
@@ -2055,12 +1867,12 @@ void test_eval_and_or(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_and_or, cmd, env, expected) && pass;
     delete_environment(env);
-    free(and_builtin);
-    free(or_builtin);
-    free(cond_sym);
-    free(define_sym);
-    free(boolpred_sym);
-    free(x_sym);
+    delete_typed_ptr(and_builtin);
+    delete_typed_ptr(or_builtin);
+    delete_typed_ptr(cond_sym);
+    delete_typed_ptr(define_sym);
+    delete_typed_ptr(boolpred_sym);
+    delete_typed_ptr(x_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2131,8 +1943,8 @@ void test_eval_not(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = pass && run_test_expect(eval_not, cmd, env, expected);
     delete_environment(env);
-    free(not_builtin);
-    free(cond_sym);
+    delete_typed_ptr(not_builtin);
+    delete_typed_ptr(cond_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2195,8 +2007,8 @@ void test_eval_list_pred(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_list_pred, cmd, env, expected) && pass;
     delete_environment(env);
-    free(listpred_builtin);
-    free(cons_sym);
+    delete_typed_ptr(listpred_builtin);
+    delete_typed_ptr(cons_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2328,8 +2140,8 @@ void test_eval_atom_pred(test_env* te) {
         pass = run_test_expect(eval_atom_pred, cmd, env, expected) && pass;
     }
     delete_environment(env);
-    free(cons_sym);
-    free(x_sym);
+    delete_typed_ptr(cons_sym);
+    delete_typed_ptr(x_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2396,8 +2208,8 @@ void test_eval_null_pred(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_null_pred, cmd, env, expected) && pass;
     delete_environment(env);
-    free(nullpred_builtin);
-    free(x_sym);
+    delete_typed_ptr(nullpred_builtin);
+    delete_typed_ptr(x_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2468,48 +2280,48 @@ void test_eval_lambda(test_env* te) {
     lone_x = unit_list(copy_typed_ptr(x_sym));
     s_expr_append(cmd, create_s_expr_tp(lone_x));
     typed_ptr* body = create_number_tp(1);
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 0);
-    typed_ptr* out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    typed_ptr out = eval_lambda(cmd, env);
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     Function_Node* resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 1 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list == NULL || \
-        strcmp(resulting_fn->param_list->name, "x") || \
-        resulting_fn->param_list->next != NULL || \
+        resulting_fn->code->param_list == NULL || \
+        strcmp(resulting_fn->code->param_list->name, "x") || \
+        resulting_fn->code->param_list->next != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
     // (lambda () 1) -> <#procedure> + side effects
     cmd = unit_list(copy_typed_ptr(lambda_builtin));
     s_expr_append(cmd, create_s_expr_tp(create_empty_s_expr()));
     body = create_number_tp(1);
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 1);
     out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 2 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list != NULL || \
+        resulting_fn->code->param_list != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
     // (lambda (x y) (+ x y)) -> <#procedure> + side effects
     cmd = unit_list(copy_typed_ptr(lambda_builtin));
     s_expr* x_and_y = unit_list(copy_typed_ptr(x_sym));
@@ -2518,28 +2330,28 @@ void test_eval_lambda(test_env* te) {
     body = create_s_expr_tp(unit_list(ADD));
     s_expr_append(body->ptr.se_ptr, copy_typed_ptr(x_sym));
     s_expr_append(body->ptr.se_ptr, copy_typed_ptr(y_sym));
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 2);
     out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 3 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list == NULL || \
-        strcmp(resulting_fn->param_list->name, "x") || \
-        resulting_fn->param_list->next == NULL || \
-        strcmp(resulting_fn->param_list->next->name, "y") || \
-        resulting_fn->param_list->next->next != NULL || \
+        resulting_fn->code->param_list == NULL || \
+        strcmp(resulting_fn->code->param_list->name, "x") || \
+        resulting_fn->code->param_list->next == NULL || \
+        strcmp(resulting_fn->code->param_list->next->name, "y") || \
+        resulting_fn->code->param_list->next->next != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
     // (lambda (x) (+ x y)) -> <#procedure> + side effects
     cmd = unit_list(copy_typed_ptr(lambda_builtin));
     lone_x = unit_list(copy_typed_ptr(x_sym));
@@ -2547,75 +2359,93 @@ void test_eval_lambda(test_env* te) {
     body = create_s_expr_tp(unit_list(ADD));
     s_expr_append(body->ptr.se_ptr, copy_typed_ptr(x_sym));
     s_expr_append(body->ptr.se_ptr, copy_typed_ptr(y_sym));
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 3);
     out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 4 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list == NULL || \
-        strcmp(resulting_fn->param_list->name, "x") || \
-        resulting_fn->param_list->next != NULL || \
+        resulting_fn->code->param_list == NULL || \
+        strcmp(resulting_fn->code->param_list->name, "x") || \
+        resulting_fn->code->param_list->next != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
     // (lambda () (/ 0)) -> <#procedure> + side effects
     cmd = unit_list(copy_typed_ptr(lambda_builtin));
     s_expr_append(cmd, create_s_expr_tp(create_empty_s_expr()));
     body = create_s_expr_tp(unit_list(DIVIDE));
     s_expr_append(body->ptr.se_ptr, create_number_tp(0));
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 4);
     out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 5 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list != NULL || \
+        resulting_fn->code->param_list != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
     // (lambda () "hello") -> <#procedure> + side effects
     cmd = unit_list(copy_typed_ptr(lambda_builtin));
     s_expr_append(cmd, create_s_expr_tp(create_empty_s_expr()));
     body = create_string_tp(create_string("hello"));
-    s_expr_append(cmd, body);
+    s_expr_append(cmd, copy_typed_ptr(body));
     expected = create_atom_tp(TYPE_FUNCTION, 5);
     out = eval_lambda(cmd, env);
-    if (!match_typed_ptrs(out, expected)) {
+    if (!match_typed_ptrs(&out, expected)) {
         pass = false;
     }
     resulting_fn = function_lookup_index(env, expected);
     if (env->function_table->length != 6 || \
         resulting_fn == NULL || \
         strcmp(resulting_fn->name, "") || \
-        resulting_fn->param_list != NULL || \
+        resulting_fn->code->param_list != NULL || \
         resulting_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(resulting_fn->body, body)) {
+        !deep_match_typed_ptrs(resulting_fn->code->body, body)) {
+        pass = false;
+    }
+    delete_s_expr_recursive(cmd, true);
+    delete_typed_ptr(body);
+    delete_typed_ptr(expected);
+    // (lambda (x) x), twice -> two procedures sharing one code object
+    cmd = unit_list(copy_typed_ptr(lambda_builtin));
+    lone_x = unit_list(copy_typed_ptr(x_sym));
+    s_expr_append(cmd, create_s_expr_tp(lone_x));
+    s_expr_append(cmd, copy_typed_ptr(x_sym));
+    out = eval_lambda(cmd, env);
+    typed_ptr again = eval_lambda(cmd, env);
+    Function_Node* first_fn = function_lookup_index(env, &out);
+    Function_Node* second_fn = function_lookup_index(env, &again);
+    if (env->function_table->length != 8 || \
+        first_fn == NULL || \
+        second_fn == NULL || \
+        first_fn == second_fn || \
+        first_fn->code != second_fn->code || \
+        first_fn->code->refs != 3) {
         pass = false;
     }
     delete_s_expr_recursive(cmd, true);
-    free(expected);
-    free(out);
     delete_environment(env);
-    free(lambda_builtin);
-    free(x_sym);
-    free(y_sym);
+    delete_typed_ptr(lambda_builtin);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(y_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2934,9 +2764,9 @@ void test_eval_cond(test_env* te) {
     expected = create_string_tp(create_string("hello"));
     pass = run_test_expect(eval_cond, cmd, env, expected) && pass;
     delete_environment(env);
-    free(cond_builtin);
-    free(equals_sym);
-    free(else_sym);
+    delete_typed_ptr(cond_builtin);
+    delete_typed_ptr(equals_sym);
+    delete_typed_ptr(else_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -2981,13 +2811,12 @@ void test_eval_define(test_env* te) {
     s_expr_append(cmd, create_number_tp(1));
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
-    typed_ptr* x_value = value_lookup_index(env, x_sym);
+    typed_ptr x_value = value_lookup_index(env, x_sym);
     expected = create_number_tp(1);
-    if (!deep_match_typed_ptrs(x_value, expected)) {
+    if (!deep_match_typed_ptrs(&x_value, expected)) {
         pass = false;
     }
-    free(expected);
-    free(x_value);
+    delete_typed_ptr(expected);
     // (define x (+ 1 1)) -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(define_builtin));
     s_expr_append(cmd, copy_typed_ptr(x_sym));
@@ -2996,11 +2825,10 @@ void test_eval_define(test_env* te) {
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
     expected = create_number_tp(2);
-    if (!deep_match_typed_ptrs(x_value, expected)) {
+    if (!deep_match_typed_ptrs(&x_value, expected)) {
         pass = false;
     }
-    free(expected);
-    free(x_value);
+    delete_typed_ptr(expected);
     // (define x (/ 0)) -> EVAL_ERROR_DIV_ZERO
     cmd = unit_list(copy_typed_ptr(define_builtin));
     s_expr_append(cmd, copy_typed_ptr(x_sym));
@@ -3021,13 +2849,12 @@ void test_eval_define(test_env* te) {
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
     expected = create_string_tp(create_string("hello"));
-    if (!deep_match_typed_ptrs(x_value, expected)) {
+    if (!deep_match_typed_ptrs(&x_value, expected)) {
         pass = false;
     }
     delete_string(expected->ptr.string);
-    free(expected);
-    delete_string(x_value->ptr.string);
-    free(x_value);
+    delete_typed_ptr(expected);
+    delete_string(x_value.ptr.string);
     // (define (x)) -> EVAL_ERROR_FEW_ARGS
     cmd = unit_list(copy_typed_ptr(define_builtin));
     s_expr_append(cmd, create_s_expr_tp(unit_list(copy_typed_ptr(x_sym))));
@@ -3076,16 +2903,15 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    Function_Node* x_fn = function_lookup_index(env, x_value);
+    Function_Node* x_fn = function_lookup_index(env, &x_value);
     if (x_fn == NULL || \
         strcmp(x_fn->name, "x") || \
-        x_fn->param_list != NULL || \
+        x_fn->code->param_list != NULL || \
         x_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(x_fn->body, body)) {
+        !deep_match_typed_ptrs(x_fn->code->body, body)) {
         pass = false;
     }
-    free(x_value);
-    free(body);
+    delete_typed_ptr(body);
     // (define (x) (+ 1 1)) -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(define_builtin));
     fn_name_args = unit_list(copy_typed_ptr(x_sym));
@@ -3094,18 +2920,17 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    x_fn = function_lookup_index(env, x_value);
+    x_fn = function_lookup_index(env, &x_value);
     body = create_s_expr_tp(add_one_one_s_expr(env));
     if (x_fn == NULL || \
         strcmp(x_fn->name, "x") || \
-        x_fn->param_list != NULL || \
+        x_fn->code->param_list != NULL || \
         x_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(x_fn->body, body)) {
+        !deep_match_typed_ptrs(x_fn->code->body, body)) {
         pass = false;
     }
-    free(x_value);
     delete_s_expr_recursive(body->ptr.se_ptr, true);
-    free(body);
+    delete_typed_ptr(body);
     // (define (x <weird symbol number>) 1) -> EVAL_ERROR_BAD_SYMBOL
     cmd = unit_list(copy_typed_ptr(define_builtin));
     fn_name_args = unit_list(copy_typed_ptr(x_sym));
@@ -3127,25 +2952,24 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    x_fn = function_lookup_index(env, x_value);
+    x_fn = function_lookup_index(env, &x_value);
     add_y_z = unit_list(ADD);
     s_expr_append(add_y_z, copy_typed_ptr(y_sym));
     s_expr_append(add_y_z, copy_typed_ptr(z_sym));
     body = create_s_expr_tp(add_y_z);
     if (x_fn == NULL || \
         strcmp(x_fn->name, "x") || \
-        x_fn->param_list == NULL || \
-        strcmp(x_fn->param_list->name, "y") || \
-        x_fn->param_list->next == NULL || \
-        strcmp(x_fn->param_list->next->name, "z") || \
-        x_fn->param_list->next->next != NULL || \
+        x_fn->code->param_list == NULL || \
+        strcmp(x_fn->code->param_list->name, "y") || \
+        x_fn->code->param_list->next == NULL || \
+        strcmp(x_fn->code->param_list->next->name, "z") || \
+        x_fn->code->param_list->next->next != NULL || \
         x_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(x_fn->body, body)) {
+        !deep_match_typed_ptrs(x_fn->code->body, body)) {
         pass = false;
     }
-    free(x_value);
     delete_s_expr_recursive(add_y_z, true);
-    free(body);
+    delete_typed_ptr(body);
     // (define (x) (/ 0)) -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(define_builtin));
     fn_name_args = unit_list(copy_typed_ptr(x_sym));
@@ -3154,18 +2978,17 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    x_fn = function_lookup_index(env, x_value);
+    x_fn = function_lookup_index(env, &x_value);
     body = create_s_expr_tp(divide_zero_s_expr(env));
     if (x_fn == NULL || \
         strcmp(x_fn->name, "x") || \
-        x_fn->param_list != NULL || \
+        x_fn->code->param_list != NULL || \
         x_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(x_fn->body, body)) {
+        !deep_match_typed_ptrs(x_fn->code->body, body)) {
         pass = false;
     }
-    free(x_value);
     delete_s_expr_recursive(body->ptr.se_ptr, true);
-    free(body);
+    delete_typed_ptr(body);
     // (define (x) "hello") -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(define_builtin));
     fn_name_args = unit_list(copy_typed_ptr(x_sym));
@@ -3174,18 +2997,17 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    x_fn = function_lookup_index(env, x_value);
+    x_fn = function_lookup_index(env, &x_value);
     body = create_string_tp(create_string("hello"));
     if (x_fn == NULL || \
         strcmp(x_fn->name, "x") || \
-        x_fn->param_list != NULL || \
+        x_fn->code->param_list != NULL || \
         x_fn->enclosing_env == NULL || \
-        !deep_match_typed_ptrs(x_fn->body, body)) {
+        !deep_match_typed_ptrs(x_fn->code->body, body)) {
         pass = false;
     }
-    free(x_value);
     delete_string(body->ptr.string);
-    free(body);
+    delete_typed_ptr(body);
     // test for a nested environment
     Environment* child = create_environment(0, 0, env);
     cmd = unit_list(copy_typed_ptr(define_builtin));
@@ -3194,24 +3016,20 @@ void test_eval_define(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_define, cmd, child, expected) && pass;
     x_value = value_lookup_index(child, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 1) {
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 1) {
         pass = false;
     }
-    free(x_value);
     x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FUNCTION) {
+    if (x_value.type != TYPE_FUNCTION) {
         pass = false;
     }
-    free(x_value);
     delete_environment(child);
     delete_environment(env);
-    free(define_builtin);
-    free(x_sym);
-    free(y_sym);
-    free(z_sym);
+    delete_typed_ptr(define_builtin);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(y_sym);
+    delete_typed_ptr(z_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3274,13 +3092,11 @@ void test_eval_setvar(test_env* te) {
     s_expr_append(cmd, create_number_tp(1));
     expected = create_void_tp();
     pass = run_test_expect(eval_set_variable, cmd, env, expected) && pass;
-    typed_ptr* x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 1) {
+    typed_ptr x_value = value_lookup_index(env, x_sym);
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 1) {
         pass = false;
     }
-    free(x_value);
     // (set! x (+ 1 1)) [with x defined] -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(setvar_builtin));
     s_expr_append(cmd, copy_typed_ptr(x_sym));
@@ -3288,12 +3104,10 @@ void test_eval_setvar(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_set_variable, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 2) {
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 2) {
         pass = false;
     }
-    free(x_value);
     // (set! x (list 1 2)) [with x defined] -> <void> + side effect
     cmd = unit_list(copy_typed_ptr(setvar_builtin));
     s_expr_append(cmd, copy_typed_ptr(x_sym));
@@ -3303,15 +3117,13 @@ void test_eval_setvar(test_env* te) {
     x_value = value_lookup_index(env, x_sym);
     s_expr* result_list = unit_list(create_number_tp(1));
     s_expr_append(result_list, create_number_tp(2));
-    if (x_value == NULL || \
-        x_value->type != TYPE_S_EXPR || \
-        !match_s_exprs(x_value->ptr.se_ptr, result_list)) {
+    if (x_value.type != TYPE_S_EXPR || \
+        !match_s_exprs(x_value.ptr.se_ptr, result_list)) {
         pass = false;
     }
-    if (x_value != NULL && x_value->type == TYPE_S_EXPR) {
-        delete_s_expr_recursive(x_value->ptr.se_ptr, true);
+    if (x_value.type == TYPE_S_EXPR) {
+        delete_s_expr_recursive(x_value.ptr.se_ptr, true);
     }
-    free(x_value);
     delete_s_expr_recursive(result_list, true);
     // (set! x (/ 0)) [with x defined] -> EVAL_ERROR_DIV_ZERO
     cmd = unit_list(copy_typed_ptr(setvar_builtin));
@@ -3337,15 +3149,13 @@ void test_eval_setvar(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_set_variable, cmd, env, expected) && pass;
     x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_STRING || \
-        strcmp(x_value->ptr.string->contents, "goodbye")) {
+    if (x_value.type != TYPE_STRING || \
+        strcmp(x_value.ptr.string->contents, "goodbye")) {
         pass = false;
     }
-    if (x_value != NULL && x_value->type == TYPE_STRING) {
-        delete_string(x_value->ptr.string);
+    if (x_value.type == TYPE_STRING) {
+        delete_string(x_value.ptr.string);
     }
-    free(x_value);
     // test for a nested environment
     Environment* middle = create_environment(0, 0, env);
     cmd = unit_list(copy_typed_ptr(setvar_builtin));
@@ -3357,12 +3167,10 @@ void test_eval_setvar(test_env* te) {
         pass = false;
     }
     x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 1) {
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 1) {
         pass = false;
     }
-    free(x_value);
     // test for a deeper nested environment
     Environment* lowest = create_environment(0, 0, middle);
     typed_ptr number_three = {.type=TYPE_FIXNUM, .ptr={.idx=3}};
@@ -3376,24 +3184,20 @@ void test_eval_setvar(test_env* te) {
         pass = false;
     }
     x_value = value_lookup_index(middle, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 2) {
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 2) {
         pass = false;
     }
-    free(x_value);
     x_value = value_lookup_index(env, x_sym);
-    if (x_value == NULL || \
-        x_value->type != TYPE_FIXNUM || \
-        x_value->ptr.idx != 1) {
+    if (x_value.type != TYPE_FIXNUM || \
+        x_value.ptr.idx != 1) {
         pass = false;
     }
-    free(x_value);
     delete_environment(lowest);
     delete_environment(middle);
     delete_environment(env);
-    free(setvar_builtin);
-    free(x_sym);
+    delete_typed_ptr(setvar_builtin);
+    delete_typed_ptr(x_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3459,8 +3263,8 @@ void test_eval_quote(test_env* te) {
     expected = create_s_expr_tp(copy_s_expr(subexpr));
     pass = run_test_expect(eval_quote, cmd, env, expected) && pass;
     delete_environment(env);
-    free(quote_builtin);
-    free(x_sym);
+    delete_typed_ptr(quote_builtin);
+    delete_typed_ptr(x_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3509,7 +3313,7 @@ void test_eval_string_length(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_string_length, cmd, env, expected) && pass;
     delete_environment(env);
-    free(strlen_builtin);
+    delete_typed_ptr(strlen_builtin);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3601,7 +3405,7 @@ void test_eval_string_equals(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_string_equals, cmd, env, expected) && pass;
     delete_environment(env);
-    free(streq_builtin);
+    delete_typed_ptr(streq_builtin);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3659,7 +3463,7 @@ void test_eval_string_append(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_string_append, cmd, env, expected) && pass;
     delete_environment(env);
-    free(strappend_builtin);
+    delete_typed_ptr(strappend_builtin);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3735,12 +3539,11 @@ void test_eval_builtin(test_env* te) {
     expected = create_void_tp();
     pass = run_test_expect(eval_builtin, cmd, env, expected) && pass;
     expected = create_number_tp(1);
-    typed_ptr* x_value = value_lookup_index(env, x_sym);
-    if (!match_typed_ptrs(x_value, expected)) {
+    typed_ptr x_value = value_lookup_index(env, x_sym);
+    if (!match_typed_ptrs(&x_value, expected)) {
         pass = false;
     }
-    free(expected);
-    free(x_value);
+    delete_typed_ptr(expected);
     // (set! x 2) -> <void> + side effect
     cmd = unit_list(create_atom_tp(TYPE_BUILTIN, BUILTIN_SETVAR));
     s_expr_append(cmd, copy_typed_ptr(x_sym));
@@ -3749,11 +3552,10 @@ void test_eval_builtin(test_env* te) {
     pass = run_test_expect(eval_builtin, cmd, env, expected) && pass;
     expected = create_number_tp(2);
     x_value = value_lookup_index(env, x_sym);
-    if (!match_typed_ptrs(x_value, expected)) {
+    if (!match_typed_ptrs(&x_value, expected)) {
         pass = false;
     }
-    free(expected);
-    free(x_value);
+    delete_typed_ptr(expected);
     // (exit) -> EVAL_ERROR_EXIT
     cmd = unit_list(create_atom_tp(TYPE_BUILTIN, BUILTIN_EXIT));
     expected = create_error_tp(EVAL_ERROR_EXIT);
@@ -3860,13 +3662,13 @@ void test_eval_builtin(test_env* te) {
     expected = create_atom_tp(TYPE_FUNCTION, 0);
     Function_Node* fn = function_lookup_index(env, expected);
     if (fn == NULL || \
-        fn->param_list != NULL || \
+        fn->code->param_list != NULL || \
         fn->enclosing_env == NULL || \
-        !match_typed_ptrs(fn->body, body)) {
+        !match_typed_ptrs(fn->code->body, body)) {
         pass = false;
     }
-    free(expected);
-    free(body);
+    delete_typed_ptr(expected);
+    delete_typed_ptr(body);
     // (<malformed builtin> 1) -> EVAL_ERROR_UNDEF_BUILTIN
     cmd = unit_list(create_atom_tp(TYPE_BUILTIN, 1000));
     s_expr_append(cmd, create_number_tp(1));
@@ -3878,8 +3680,8 @@ void test_eval_builtin(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_builtin, cmd, env, expected) && pass;
     delete_environment(env);
-    free(x_sym);
-    free(else_sym);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(else_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3903,10 +3705,10 @@ void test_eval_s_expr(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_MISSING_PROCEDURE);
     pass = run_test_expect(eval_s_expr, cmd, env, expected) && pass;
     // <malformed s-expression> -> EVAL_ERROR_MALFORMED_S_EXPR
-    cmd = create_s_expr(create_number_tp(1), NULL);
+    cmd = create_s_expr(atom_tp(TYPE_FIXNUM, 1), none_tp());
     expected = create_error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
     pass = run_test_expect(eval_s_expr, cmd, env, expected) && pass;
-    cmd = create_s_expr(NULL, create_number_tp(1));
+    cmd = create_s_expr(none_tp(), atom_tp(TYPE_FIXNUM, 1));
     expected = create_error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
     pass = run_test_expect(eval_s_expr, cmd, env, expected) && pass;
     // ((/ 0) 1) -> EVAL_ERROR_DIV_ZERO
@@ -3970,8 +3772,8 @@ void test_eval_s_expr(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_s_expr, cmd, env, expected) && pass;
     delete_environment(env);
-    free(x_sym);
-    free(x2_sym);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(x2_sym);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -3982,11 +3784,12 @@ void test_eval_function(test_env* te) {
     print_test_announce("eval_function()");
     Environment* env = create_environment(0, 0, NULL);
     setup_environment(env);
-    typed_ptr *x_sym, *y_sym, *my_fun;
+    typed_ptr *x_sym, *y_sym, *my_fun, *my_maker;
     x_sym = install_symbol(env, "x", &undef);
     y_sym = install_symbol(env, "y", &undef);
     char mf[] = "my-fun";
     my_fun = install_symbol(env, mf, &undef);
+    my_maker = install_symbol(env, "my-maker", &undef);
     bool pass = true;
     // given my-fun, a two-parameter function that doubles its first argument
     //   and prepends it to its second
@@ -4005,6 +3808,7 @@ void test_eval_function(test_env* te) {
     s_expr_append(cmd, create_s_expr_tp(body));
     typed_ptr* expected = create_void_tp();
     run_test_expect(eval_define, cmd, env, expected);
+    typed_ptr my_fun_value = value_lookup_index(env, my_fun);
     // (<undefined function> 1) -> EVAL_ERROR_UNDEF_FUNCTION
     cmd = unit_list(create_atom_tp(TYPE_FUNCTION, 1000));
     s_expr_append(cmd, create_number_tp(1));
@@ -4014,7 +3818,7 @@ void test_eval_function(test_env* te) {
         pass = false;
     }
     // (my-fun (/ 0)) -> EVAL_ERROR_DIV_ZERO
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     s_expr_append(cmd, create_s_expr_tp(divide_zero_s_expr(env)));
     expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
     pass = run_test_expect(eval_function, cmd, env, expected) && pass;
@@ -4022,14 +3826,14 @@ void test_eval_function(test_env* te) {
         pass = false;
     }
     // (my-fun) -> EVAL_ERROR_FEW_ARGS
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     expected = create_error_tp(EVAL_ERROR_FEW_ARGS);
     pass = run_test_expect(eval_function, cmd, env, expected) && pass;
     if (env->env_tracker_next != NULL) {
         pass = false;
     }
     // (my-fun 1) -> EVAL_ERROR_FEW_ARGS
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     s_expr_append(cmd, create_number_tp(1));
     expected = create_error_tp(EVAL_ERROR_FEW_ARGS);
     pass = run_test_expect(eval_function, cmd, env, expected) && pass;
@@ -4037,7 +3841,7 @@ void test_eval_function(test_env* te) {
         pass = false;
     }
     // (my-fun 1 2 3) -> EVAL_ERROR_MANY_ARGS
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     s_expr_append(cmd, create_number_tp(1));
     s_expr_append(cmd, create_number_tp(2));
     s_expr_append(cmd, create_number_tp(3));
@@ -4047,7 +3851,7 @@ void test_eval_function(test_env* te) {
         pass = false;
     }
     // (my-fun 2 (list 8 16)) -> '(4 8 16)
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     s_expr_append(cmd, create_number_tp(2));
     s_expr* list_eight_sixteen = unit_list(LIST_SYM);
     s_expr_append(list_eight_sixteen, create_number_tp(8));
@@ -4057,12 +3861,12 @@ void test_eval_function(test_env* te) {
     s_expr_append(expected->ptr.se_ptr, create_number_tp(8));
     s_expr_append(expected->ptr.se_ptr, create_number_tp(16));
     pass = run_test_expect(eval_function, cmd, env, expected) && pass;
-    if (env->env_tracker_next == NULL || \
-        env->env_tracker_next->env_tracker_next != NULL) {
+    // nothing captured the call's environment, so it is already gone
+    if (env->env_tracker_next != NULL) {
         pass = false;
     }
     // (my-fun #t (list 8 16)) -> EVAL_ERROR_NEED_NUM
-    cmd = unit_list(value_lookup_index(env, my_fun));
+    cmd = unit_list(copy_typed_ptr(&my_fun_value));
     s_expr_append(cmd, create_atom_tp(TYPE_BOOL, true));
     list_eight_sixteen = unit_list(LIST_SYM);
     s_expr_append(list_eight_sixteen, create_number_tp(8));
@@ -4070,23 +3874,58 @@ void test_eval_function(test_env* te) {
     s_expr_append(cmd, create_s_expr_tp(list_eight_sixteen));
     expected = create_error_tp(EVAL_ERROR_NEED_NUM);
     pass = run_test_expect(eval_function, cmd, env, expected) && pass;
-    if (env->env_tracker_next == NULL || \
-        env->env_tracker_next->env_tracker_next == NULL || \
-        env->env_tracker_next->env_tracker_next->env_tracker_next != NULL) {
+    if (env->env_tracker_next != NULL) {
+        pass = false;
+    }
+    // given my-maker, a one-parameter function that returns a closure over it
+    //   (i.e.: (define (my-maker x) (lambda (y) x))     )
+    cmd = unit_list(builtin_tp_from_name(env, "define"));
+    fn_sig = unit_list(copy_typed_ptr(my_maker));
+    s_expr_append(fn_sig, copy_typed_ptr(x_sym));
+    s_expr_append(cmd, create_s_expr_tp(fn_sig));
+    s_expr* lambda = unit_list(LAMBDA_SYM);
+    s_expr_append(lambda, create_s_expr_tp(unit_list(copy_typed_ptr(y_sym))));
+    s_expr_append(lambda, copy_typed_ptr(x_sym));
+    s_expr_append(cmd, create_s_expr_tp(lambda));
+    expected = create_void_tp();
+    run_test_expect(eval_define, cmd, env, expected);
+    typed_ptr my_maker_value = value_lookup_index(env, my_maker);
+    // (my-maker 1) -> <procedure>, which keeps a record of x, in a box it
+    //   shares with the call's own environment; that is freed as usual
+    cmd = unit_list(copy_typed_ptr(&my_maker_value));
+    s_expr_append(cmd, create_number_tp(1));
+    typed_ptr closure = eval_function(cmd, env);
+    Function_Node* closure_fn = function_lookup_index(env, &closure);
+    if (closure_fn == NULL || \
+        !closure_fn->code->flat || \
+        env->env_tracker_next == NULL || \
+        env->env_tracker_next->env_tracker_next != NULL || \
+        !env->env_tracker_next->captured || \
+        closure_fn->enclosing_env != env->env_tracker_next || \
+        closure_fn->enclosing_env->enclosing_env != env || \
+        closure_fn->enclosing_env->slot_count != 1 || \
+        closure_fn->enclosing_env->slots[0].symbol_idx != x_sym->ptr.idx || \
+        !closure_fn->enclosing_env->slots[0].boxed || \
+        closure_fn->enclosing_env->slots[0].value.se_ptr->refs != 1 || \
+        binding_value(&closure_fn->enclosing_env->slots[0]).type != \
+        TYPE_FIXNUM || \
+        binding_value(&closure_fn->enclosing_env->slots[0]).ptr.idx != 1) {
         pass = false;
     }
+    delete_s_expr_recursive(cmd, true);
     delete_environment(env);
-    free(x_sym);
-    free(y_sym);
-    free(my_fun);
+    delete_typed_ptr(x_sym);
+    delete_typed_ptr(y_sym);
+    delete_typed_ptr(my_fun);
+    delete_typed_ptr(my_maker);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
     return;
 }
 
-typed_ptr* wrapper_evaluate(const s_expr* cmd, Environment* env) {
-    return evaluate(cmd->car, env);
+typed_ptr wrapper_evaluate(const s_expr* cmd, Environment* env) {
+    return evaluate(&cmd->car, env);
 }
 
 void test_evaluate(test_env* te) {
@@ -4130,10 +3969,12 @@ void test_evaluate(test_env* te) {
     expected = create_error_tp(EVAL_ERROR_MISSING_PROCEDURE);
     pass = run_test_expect(wrapper_evaluate, cmd, env, expected) && pass;
     // eval[ <malformed s-expression> ] -> EVAL_ERROR_MALFORMED_S_EXPR
-    cmd = unit_list(create_s_expr_tp(create_s_expr(create_number_tp(1), NULL)));
+    cmd = unit_list(create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 1), \
+                                                   none_tp())));
     expected = create_error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
     pass = run_test_expect(wrapper_evaluate, cmd, env, expected) && pass;
-    cmd = unit_list(create_s_expr_tp(create_s_expr(NULL, create_number_tp(1))));
+    cmd = unit_list(create_s_expr_tp(create_s_expr(none_tp(), \
+                                                   atom_tp(TYPE_FIXNUM, 1))));
     expected = create_error_tp(EVAL_ERROR_MALFORMED_S_EXPR);
     pass = run_test_expect(wrapper_evaluate, cmd, env, expected) && pass;
     // eval[ (+ 1 1) ] -> 2
@@ -4156,8 +3997,7 @@ void test_evaluate(test_env* te) {
     cmd = unit_list(create_s_expr_tp(cmd));
     expected = create_atom_tp(TYPE_FIXNUM, 20);
     pass = run_test_expect(wrapper_evaluate, cmd, env, expected) && pass;
-    if (env->env_tracker_next == NULL || \
-        env->env_tracker_next->env_tracker_next != NULL) {
+    if (env->env_tracker_next != NULL) {
         pass = false;
     }
     // eval[ 'x ] (assuming x is defined to be 1) -> 1
@@ -4181,7 +4021,216 @@ void test_evaluate(test_env* te) {
     expected = create_string_tp(create_string("hello"));
     pass = run_test_expect(wrapper_evaluate, cmd, env, expected) && pass;
     delete_environment(env);
-    free(x_sym);
+    delete_typed_ptr(x_sym);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+typed_ptr wrapper_evaluate_cek(const s_expr* cmd, Environment* env) {
+    return evaluate_cek(&cmd->car, env);
+}
+
+void test_evaluate_cek(test_env* te) {
+    print_test_announce("evaluate_cek()");
+    Environment* env = create_environment(0, 0, NULL);
+    setup_environment(env);
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=1}};
+    typed_ptr* x_sym = install_symbol(env, "x", &number);
+    bool pass = true;
+    // eval[ 1 ] -> 1, without using the continuation stack
+    s_expr* cmd = unit_list(create_number_tp(1));
+    typed_ptr* expected = create_number_tp(1);
+    pass = run_test_expect(wrapper_evaluate_cek, cmd, env, expected) && pass;
+    if (cek_peak_depth() != 0) {
+        pass = false;
+    }
+    // eval[ (+ 1 (+ 1 (+ 1 1))) ] -> 4, with a frame for each pending call
+    s_expr* sum = add_one_one_s_expr(env);
+    for (unsigned int i = 0; i < 2; i++) {
+        s_expr* outer = unit_list(ADD);
+        s_expr_append(outer, create_number_tp(1));
+        s_expr_append(outer, create_s_expr_tp(sum));
+        sum = outer;
+    }
+    cmd = unit_list(create_s_expr_tp(sum));
+    expected = create_number_tp(4);
+    pass = run_test_expect(wrapper_evaluate_cek, cmd, env, expected) && pass;
+    if (cek_peak_depth() != 3) {
+        pass = false;
+    }
+    // eval[ (+ 1 (/ 0)) ] -> EVAL_ERROR_DIV_ZERO
+    s_expr* add_quotient = unit_list(ADD);
+    s_expr_append(add_quotient, create_number_tp(1));
+    s_expr_append(add_quotient, create_s_expr_tp(divide_zero_s_expr(env)));
+    cmd = unit_list(create_s_expr_tp(add_quotient));
+    expected = create_error_tp(EVAL_ERROR_DIV_ZERO);
+    pass = run_test_expect(wrapper_evaluate_cek, cmd, env, expected) && pass;
+    // eval[ ((lambda (x) (* x 10)) 2) ] -> 20, with its frame freed
+    cmd = create_empty_s_expr();
+    s_expr* lambda = unit_list(LAMBDA_SYM);
+    s_expr_append(lambda, create_s_expr_tp(unit_list(copy_typed_ptr(x_sym))));
+    s_expr* multiply_x_ten = unit_list(MULTIPLY);
+    s_expr_append(multiply_x_ten, copy_typed_ptr(x_sym));
+    s_expr_append(multiply_x_ten, create_number_tp(10));
+    s_expr_append(lambda, create_s_expr_tp(multiply_x_ten));
+    s_expr_append(cmd, create_s_expr_tp(lambda));
+    s_expr_append(cmd, create_number_tp(2));
+    cmd = unit_list(create_s_expr_tp(cmd));
+    expected = create_atom_tp(TYPE_FIXNUM, 20);
+    pass = run_test_expect(wrapper_evaluate_cek, cmd, env, expected) && pass;
+    if (env->env_tracker_next != NULL) {
+        pass = false;
+    }
+    // eval[ (list 1 2) ] -> (1 2)
+    cmd = unit_list(create_s_expr_tp(list_one_two_s_expr(env)));
+    s_expr* one_two = unit_list(create_number_tp(1));
+    s_expr_append(one_two, create_number_tp(2));
+    expected = create_s_expr_tp(one_two);
+    pass = run_test_expect(wrapper_evaluate_cek, cmd, env, expected) && pass;
+    delete_environment(env);
+    delete_typed_ptr(x_sym);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_analyze(test_env* te) {
+    print_test_announce("analyze()");
+    Environment* env = create_environment(0, 0, NULL);
+    setup_environment(env);
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=1}};
+    typed_ptr* x_sym = install_symbol(env, "x", &number);
+    bool pass = true;
+    // (+ x 1) gets a node of its own, whose children are the operator and the
+    //   arguments, which refer to the form they were built from
+    s_expr* sum = unit_list(symbol_tp_from_name(env, "+"));
+    s_expr_append(sum, copy_typed_ptr(x_sym));
+    s_expr_append(sum, create_number_tp(1));
+    typed_ptr* form = create_s_expr_tp(sum);
+    Tree_Node* tree = analyze(form, env);
+    if (tree->op != BUILTIN_ADD || \
+        tree->child_count != 3 || \
+        tree->children[1]->source != &s_expr_next(sum)->car || \
+        tree->children[2]->child_count != 0) {
+        pass = false;
+    }
+    delete_tree_node(tree);
+    delete_s_expr_recursive(sum, true);
+    delete_typed_ptr(form);
+    // (x x) is a call of whatever x holds when it is executed
+    s_expr* call = unit_list(copy_typed_ptr(x_sym));
+    s_expr_append(call, copy_typed_ptr(x_sym));
+    form = create_s_expr_tp(call);
+    tree = analyze(form, env);
+    if (tree->child_count != 2 || tree->children[0]->source != &call->car) {
+        pass = false;
+    }
+    delete_tree_node(tree);
+    delete_s_expr_recursive(call, true);
+    delete_typed_ptr(form);
+    // (cond (x 1) (else 2)) has a node for each clause, and else no predicate
+    s_expr* cond = unit_list(symbol_tp_from_name(env, "cond"));
+    s_expr* clause = unit_list(copy_typed_ptr(x_sym));
+    s_expr_append(clause, create_number_tp(1));
+    s_expr_append(cond, create_s_expr_tp(clause));
+    clause = unit_list(symbol_tp_from_name(env, "else"));
+    s_expr_append(clause, create_number_tp(2));
+    s_expr_append(cond, create_s_expr_tp(clause));
+    form = create_s_expr_tp(cond);
+    tree = analyze(form, env);
+    if (tree->op != BUILTIN_COND || \
+        tree->child_count != 3 || \
+        tree->children[1]->children[0] == NULL || \
+        tree->children[2]->child_count != 2 || \
+        tree->children[2]->children[0] != NULL) {
+        pass = false;
+    }
+    delete_tree_node(tree);
+    delete_s_expr_recursive(cond, true);
+    delete_typed_ptr(form);
+    // the arguments of a malformed cond, or of quote, are left to the built-in
+    cond = unit_list(symbol_tp_from_name(env, "cond"));
+    s_expr_append(cond, create_number_tp(1));
+    form = create_s_expr_tp(cond);
+    tree = analyze(form, env);
+    if (tree->op != BUILTIN_COND || tree->child_count != 1) {
+        pass = false;
+    }
+    delete_tree_node(tree);
+    delete_s_expr_recursive(cond, true);
+    delete_typed_ptr(form);
+    s_expr* quote = unit_list(symbol_tp_from_name(env, "quote"));
+    s_expr_append(quote, create_s_expr_tp(unit_list(copy_typed_ptr(x_sym))));
+    form = create_s_expr_tp(quote);
+    tree = analyze(form, env);
+    if (tree->op != BUILTIN_QUOTE || tree->child_count != 1) {
+        pass = false;
+    }
+    delete_tree_node(tree);
+    delete_s_expr_recursive(quote, true);
+    delete_typed_ptr(form);
+    delete_typed_ptr(x_sym);
+    delete_environment(env);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_compile(test_env* te) {
+    print_test_announce("compile()");
+    Environment* env = create_environment(0, 0, NULL);
+    setup_environment(env);
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=1}};
+    typed_ptr* x_sym = install_symbol(env, "x", &number);
+    bool pass = true;
+    // (+ x 1) is done inline once + is found to be the built-in, and evaluated
+    //   from its source otherwise
+    s_expr* sum = unit_list(symbol_tp_from_name(env, "+"));
+    s_expr_append(sum, copy_typed_ptr(x_sym));
+    s_expr_append(sum, create_number_tp(1));
+    typed_ptr* body = create_s_expr_tp(sum);
+    Bytecode* bytecode = compile(body, env);
+    unsigned int sum_code[] = {OP_GUARD, 0, BUILTIN_ADD, 13, \
+                               OP_LOAD, 1, \
+                               OP_CONSTANT, 2, \
+                               OP_ARITHMETIC, BUILTIN_ADD, 2, \
+                               OP_JUMP, 15, \
+                               OP_SOURCE, 3, \
+                               OP_RETURN};
+    if (bytecode->length != sizeof(sum_code) / sizeof(unsigned int) || \
+        memcmp(bytecode->code, sum_code, sizeof(sum_code)) != 0 || \
+        bytecode->constant_count != 4 || \
+        bytecode->constants[0] != &sum->car || \
+        bytecode->constants[3] != body) {
+        pass = false;
+    }
+    delete_bytecode(bytecode);
+    delete_s_expr_recursive(sum, true);
+    delete_typed_ptr(body);
+    // (x x) in tail position is a tail call, unless x holds a built-in
+    s_expr* call = unit_list(copy_typed_ptr(x_sym));
+    s_expr_append(call, copy_typed_ptr(x_sym));
+    body = create_s_expr_tp(call);
+    bytecode = compile(body, env);
+    unsigned int call_code[] = {OP_LOAD, 0, \
+                                OP_PREPARE, 1, 9, \
+                                OP_LOAD, 2, \
+                                OP_TAIL_CALL, 1, \
+                                OP_RETURN};
+    if (bytecode->length != sizeof(call_code) / sizeof(unsigned int) || \
+        memcmp(bytecode->code, call_code, sizeof(call_code)) != 0 || \
+        bytecode->constants[1] != body) {
+        pass = false;
+    }
+    delete_bytecode(bytecode);
+    delete_s_expr_recursive(call, true);
+    delete_typed_ptr(body);
+    delete_typed_ptr(x_sym);
+    delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -13,7 +13,6 @@ void unit_tests_evaluate(test_env* te);
 
 void test_collect_parameters(test_env* te);
 void test_bind_args(test_env* te);
-void test_make_eval_env(test_env* te);
 void test_collect_arguments(test_env* te);
 
 void test_eval_arithmetic(test_env* te);
@@ -41,5 +40,8 @@ void test_eval_s_expr(test_env* te);
 void test_eval_function(test_env* te);
 
 void test_evaluate(test_env* te);
+void test_evaluate_cek(test_env* te);
+void test_analyze(test_env* te);
+void test_compile(test_env* te);
 
 #endif
@@ -24,11 +24,19 @@ void unit_tests_fundamentals(test_env* t_env) {
     test_create_s_expr_tp(t_env);
     test_create_string_tp(t_env);
     test_copy_typed_ptr(t_env);
+    test_delete_typed_ptr(t_env);
     test_create_s_expr(t_env);
     test_create_empty_s_expr(t_env);
     test_copy_s_expr(t_env);
+    test_share_s_expr(t_env);
+    test_share_value(t_env);
     test_delete_s_expr_recursive(t_env);
+    test_delete_s_expr(t_env);
     test_create_string(t_env);
+    test_create_rope(t_env);
+    test_string_contents(t_env);
+    test_share_string(t_env);
+    test_unshare_string(t_env);
     test_delete_string(t_env);
     test_s_expr_next(t_env);
     test_is_empty_list(t_env);
@@ -57,7 +65,7 @@ void test_create_typed_ptr(test_env* te) {
                 pass = false;
             }
         }
-        free(out);
+        delete_typed_ptr(out);
     }
     print_test_result(pass);
     te->passed += pass;
@@ -80,7 +88,7 @@ void test_create_atom_tp(test_env* te) {
                 pass = false;
             }
         }
-        free(out);
+        delete_typed_ptr(out);
     }
     print_test_result(pass);
     te->passed += pass;
@@ -95,7 +103,7 @@ void test_create_error_tp(test_env* te) {
     if (!check_error(out, TEST_ERROR_DUMMY)) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -111,7 +119,7 @@ void test_create_void_tp(test_env* te) {
         out->ptr.idx != 0) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -127,7 +135,7 @@ void test_create_s_expr_tp(test_env* te) {
         out->ptr.se_ptr != TEST_S_EXPR_TP_VAL.se_ptr) {
         pass = false;
     }
-    free(out);
+    delete_typed_ptr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -147,7 +155,7 @@ void test_create_string_tp(test_env* te) {
     }
     free(str_obj->contents);
     free(str_obj);
-    free(out);
+    delete_typed_ptr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -166,8 +174,51 @@ void test_copy_typed_ptr(test_env* te) {
     if (match_typed_ptrs(original, copied)) {
         pass = false;
     }
-    free(original);
-    free(copied);
+    delete_typed_ptr(original);
+    delete_typed_ptr(copied);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_delete_typed_ptr(test_env* te) {
+    print_test_announce("delete_typed_ptr()");
+    bool pass = true;
+    long live_before = live_typed_ptr_count();
+    typed_ptr* first = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
+    if (live_typed_ptr_count() != live_before + 1) {
+        pass = false;
+    }
+    delete_typed_ptr(first);
+    if (live_typed_ptr_count() != live_before) {
+        pass = false;
+    }
+    // a deleted typed_ptr is reused before any fresh storage
+    typed_ptr* second = create_atom_tp(TYPE_BOOL, true);
+    if (second != first || \
+        second->type != TYPE_BOOL || \
+        second->ptr.idx != true) {
+        pass = false;
+    }
+    delete_typed_ptr(second);
+    // enough typed_ptrs to span several slab pages are all distinct
+    unsigned int num_tps = 5000;
+    typed_ptr** many = malloc(sizeof(typed_ptr*) * num_tps);
+    for (unsigned int i = 0; i < num_tps; i++) {
+        many[i] = create_atom_tp(TYPE_FIXNUM, i);
+    }
+    for (unsigned int i = 0; i < num_tps; i++) {
+        if (many[i]->type != TYPE_FIXNUM || many[i]->ptr.idx != i) {
+            pass = false;
+        }
+        delete_typed_ptr(many[i]);
+    }
+    free(many);
+    if (live_typed_ptr_count() != live_before) {
+        pass = false;
+    }
+    delete_typed_ptr(NULL); // no-op
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -176,18 +227,16 @@ void test_copy_typed_ptr(test_env* te) {
 
 void test_create_s_expr(test_env* te) {
     print_test_announce("create_s_expr()");
-    typed_ptr* input_car = create_atom_tp(TYPE_FIXNUM, TEST_NUM);
-    typed_ptr* input_cdr = create_atom_tp(TYPE_FIXNUM, 100);
+    typed_ptr input_car = atom_tp(TYPE_FIXNUM, TEST_NUM);
+    typed_ptr input_cdr = atom_tp(TYPE_FIXNUM, 100);
     s_expr* out = create_s_expr(input_car, input_cdr);
     bool pass = true;
     if (out == NULL || \
-        out->car != input_car || \
-        out->cdr != input_cdr) {
+        !match_typed_ptrs(&out->car, &input_car) || \
+        !match_typed_ptrs(&out->cdr, &input_cdr)) {
         pass = false;
     }
-    free(input_car);
-    free(input_cdr);
-    free(out);
+    delete_s_expr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -199,11 +248,11 @@ void test_create_empty_s_expr(test_env* te) {
     s_expr* out = create_empty_s_expr();
     bool pass = true;
     if (out == NULL || \
-        out->car != NULL || \
-        out->cdr != NULL) {
+        out->car.type != TYPE_NONE || \
+        out->cdr.type != TYPE_NONE) {
         pass = false;
     }
-    free(out);
+    delete_s_expr(out);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -227,17 +276,17 @@ void test_copy_s_expr(test_env* te) {
         copied == original) {
         pass = false;
     }
-    free(original);
-    free(copied);
+    delete_s_expr(original);
+    delete_s_expr(copied);
     // copy(pair of atomic typed pointers) -> new pair of atomic typed pointers
     int first_value = 64;
     int second_value = 128;
     int third_value = 256;
     int fourth_value = 512;
-    typed_ptr* first_atom = create_atom_tp(TYPE_FIXNUM, first_value);
-    typed_ptr* second_atom = create_atom_tp(TYPE_FIXNUM, second_value);
-    typed_ptr* third_atom = create_atom_tp(TYPE_FIXNUM, third_value);
-    typed_ptr* fourth_atom = create_atom_tp(TYPE_FIXNUM, fourth_value);
+    typed_ptr first_atom = atom_tp(TYPE_FIXNUM, first_value);
+    typed_ptr second_atom = atom_tp(TYPE_FIXNUM, second_value);
+    typed_ptr third_atom = atom_tp(TYPE_FIXNUM, third_value);
+    typed_ptr fourth_atom = atom_tp(TYPE_FIXNUM, fourth_value);
     original = create_s_expr(first_atom, second_atom);
     copied = copy_s_expr(original);
     typed_ptr* copied_tp = create_s_expr_tp(copied);
@@ -246,12 +295,10 @@ void test_copy_s_expr(test_env* te) {
     }
     delete_s_expr_recursive(original, true);
     delete_s_expr_recursive(copied, true);
-    free(copied_tp);
+    delete_typed_ptr(copied_tp);
     // copy(one-atomic-element list) -> new one-atomic-element list
-    first_atom = create_atom_tp(TYPE_FIXNUM, first_value);
-    second_atom = create_atom_tp(TYPE_FIXNUM, second_value);
     original = create_s_expr(first_atom, \
-                             create_s_expr_tp(create_empty_s_expr()));
+                             s_expr_tp(create_empty_s_expr()));
     copied = copy_s_expr(original);
     copied_tp = create_s_expr_tp(copied);
     if (!match_s_exprs(original, copied)) {
@@ -259,14 +306,13 @@ void test_copy_s_expr(test_env* te) {
     }
     delete_s_expr_recursive(original, true);
     delete_s_expr_recursive(copied, true);
-    free(copied_tp);
+    delete_typed_ptr(copied_tp);
     // copy(multi-atomic-element list) -> new multi-atomic-element list
-    first_atom = create_atom_tp(TYPE_FIXNUM, first_value);
     original = create_empty_s_expr();
-    original = create_s_expr(fourth_atom, create_s_expr_tp(original));
-    original = create_s_expr(third_atom, create_s_expr_tp(original));
-    original = create_s_expr(second_atom, create_s_expr_tp(original));
-    original = create_s_expr(first_atom, create_s_expr_tp(original));
+    original = create_s_expr(fourth_atom, s_expr_tp(original));
+    original = create_s_expr(third_atom, s_expr_tp(original));
+    original = create_s_expr(second_atom, s_expr_tp(original));
+    original = create_s_expr(first_atom, s_expr_tp(original));
     copied = copy_s_expr(original);
     copied_tp = create_s_expr_tp(copied);
     if (!match_s_exprs(original, copied)) {
@@ -274,20 +320,16 @@ void test_copy_s_expr(test_env* te) {
     }
     delete_s_expr_recursive(original, true);
     delete_s_expr_recursive(copied, true);
-    free(copied_tp);
+    delete_typed_ptr(copied_tp);
     // copy(list with list elements) -> deep copy of list elements
-    first_atom = create_atom_tp(TYPE_FIXNUM, first_value);
-    second_atom = create_atom_tp(TYPE_FIXNUM, second_value);
-    third_atom = create_atom_tp(TYPE_FIXNUM, third_value);
-    fourth_atom = create_atom_tp(TYPE_FIXNUM, fourth_value);
     original = create_empty_s_expr();
-    original = create_s_expr(fourth_atom, create_s_expr_tp(original));
-    original = create_s_expr(third_atom, create_s_expr_tp(original));
+    original = create_s_expr(fourth_atom, s_expr_tp(original));
+    original = create_s_expr(third_atom, s_expr_tp(original));
     s_expr* branch = create_empty_s_expr();
-    branch = create_s_expr(second_atom, create_s_expr_tp(branch));
-    branch = create_s_expr(first_atom, create_s_expr_tp(branch));
-    original = create_s_expr(create_s_expr_tp(branch), \
-                             create_s_expr_tp(original));
+    branch = create_s_expr(second_atom, s_expr_tp(branch));
+    branch = create_s_expr(first_atom, s_expr_tp(branch));
+    original = create_s_expr(s_expr_tp(branch), \
+                             s_expr_tp(original));
     copied = copy_s_expr(original);
     if (!match_s_exprs(original, copied)) {
         pass = false;
@@ -310,6 +352,75 @@ void test_copy_s_expr(test_env* te) {
 }
 
 // these will have to remain smoke tests (plus valgrind checks)
+void test_share_s_expr(test_env* te) {
+    print_test_announce("share_s_expr()");
+    bool pass = true;
+    long se_live_before = live_s_expr_count();
+    s_expr* tail = unit_list(create_atom_tp(TYPE_FIXNUM, TEST_NUM));
+    s_expr* list_one = create_s_expr(atom_tp(TYPE_BOOL, true), \
+                                     s_expr_tp(share_s_expr(tail)));
+    s_expr* list_two = create_s_expr(atom_tp(TYPE_BOOL, false), \
+                                     s_expr_tp(share_s_expr(tail)));
+    delete_s_expr_recursive(tail, true);
+    if (s_expr_next(list_one) != s_expr_next(list_two) || \
+        s_expr_next(list_one)->car.ptr.idx != TEST_NUM) {
+        pass = false;
+    }
+    // deleting one list leaves the shared tail intact for the other
+    delete_s_expr_recursive(list_one, true);
+    if (s_expr_next(list_two)->car.type != TYPE_FIXNUM || \
+        s_expr_next(list_two)->car.ptr.idx != TEST_NUM) {
+        pass = false;
+    }
+    delete_s_expr_recursive(list_two, true);
+    if (live_s_expr_count() != se_live_before) {
+        pass = false;
+    }
+    if (share_s_expr(NULL) != NULL) {
+        pass = false;
+    }
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_share_value(test_env* te) {
+    print_test_announce("share_value()");
+    bool pass = true;
+    typed_ptr number = {.type=TYPE_FIXNUM, .ptr={.idx=TEST_NUM}};
+    typed_ptr out = share_value(&number);
+    if (out.type != TYPE_FIXNUM || out.ptr.idx != TEST_NUM) {
+        pass = false;
+    }
+    s_expr* se = unit_list(create_atom_tp(TYPE_FIXNUM, TEST_NUM));
+    typed_ptr se_tp = {.type=TYPE_S_EXPR, .ptr={.se_ptr=se}};
+    out = share_value(&se_tp);
+    if (out.type != TYPE_S_EXPR || out.ptr.se_ptr != se) {
+        pass = false;
+    }
+    delete_s_expr_recursive(out.ptr.se_ptr, true);
+    if (se->car.ptr.idx != TEST_NUM) {
+        pass = false;
+    }
+    delete_s_expr_recursive(se, true);
+    String* str = create_string("test string");
+    typed_ptr str_tp = {.type=TYPE_STRING, .ptr={.string=str}};
+    out = share_value(&str_tp);
+    if (out.type != TYPE_STRING || \
+        out.ptr.string != str || \
+        str->refs != 2 || \
+        strcmp(out.ptr.string->contents, "test string")) {
+        pass = false;
+    }
+    delete_string(out.ptr.string);
+    delete_string(str);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
 void test_delete_s_expr_recursive(test_env* te) {
     print_test_announce("delete_s_expr_recursive()");
     // deleting a NULL se has no effect
@@ -317,18 +428,18 @@ void test_delete_s_expr_recursive(test_env* te) {
     delete_s_expr_recursive(se, true);
     delete_s_expr_recursive(se, false);
     // deleting a pair
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), \
-                       create_atom_tp(TYPE_FIXNUM, 128));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 64), \
+                       atom_tp(TYPE_FIXNUM, 128));
     delete_s_expr_recursive(se, true);
     // deleting a one-atomic-element list
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), \
-                       create_s_expr_tp(create_empty_s_expr()));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 64), \
+                       s_expr_tp(create_empty_s_expr()));
     delete_s_expr_recursive(se, true);
     // deleting a multi-atomic-element list
     se = create_empty_s_expr();
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 256), create_s_expr_tp(se));
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 128), create_s_expr_tp(se));
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), create_s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 256), s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 128), s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 64), s_expr_tp(se));
     delete_s_expr_recursive(se, true);
     // deleting a one-string-element list
     se = unit_list(create_string_tp(create_string("test string 1")));
@@ -338,42 +449,42 @@ void test_delete_s_expr_recursive(test_env* te) {
     s_expr_append(se, create_string_tp(create_string("test string 2")));
     delete_s_expr_recursive(se, true);
     // deleting a string-containing pair
-    se = create_s_expr(create_string_tp(create_string("test string 1")), \
-                       create_string_tp(create_string("test string 2")));
+    se = create_s_expr(string_tp(create_string("test string 1")), \
+                       string_tp(create_string("test string 2")));
     delete_s_expr_recursive(se, true);
     // deleting a one-list-element list
     s_expr* branch = create_empty_s_expr();
-    branch = create_s_expr(create_atom_tp(TYPE_FIXNUM, 256), \
-                           create_s_expr_tp(branch));
-    branch = create_s_expr(create_atom_tp(TYPE_FIXNUM, 128), \
-                           create_s_expr_tp(branch));
-    branch = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), \
-                           create_s_expr_tp(branch));
+    branch = create_s_expr(atom_tp(TYPE_FIXNUM, 256), \
+                           s_expr_tp(branch));
+    branch = create_s_expr(atom_tp(TYPE_FIXNUM, 128), \
+                           s_expr_tp(branch));
+    branch = create_s_expr(atom_tp(TYPE_FIXNUM, 64), \
+                           s_expr_tp(branch));
     se = create_empty_s_expr();
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 1024), create_s_expr_tp(se));
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 512), create_s_expr_tp(se));
-    se = create_s_expr(create_s_expr_tp(branch), create_s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 1024), s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 512), s_expr_tp(se));
+    se = create_s_expr(s_expr_tp(branch), s_expr_tp(se));
     delete_s_expr_recursive(se, true);
     // deleting a multi-list-element list
     s_expr* branch_1 = create_empty_s_expr();
-    branch_1 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 256), \
-                             create_s_expr_tp(branch_1));
-    branch_1 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 128), \
-                             create_s_expr_tp(branch_1));
-    branch_1 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), \
-                             create_s_expr_tp(branch_1));
+    branch_1 = create_s_expr(atom_tp(TYPE_FIXNUM, 256), \
+                             s_expr_tp(branch_1));
+    branch_1 = create_s_expr(atom_tp(TYPE_FIXNUM, 128), \
+                             s_expr_tp(branch_1));
+    branch_1 = create_s_expr(atom_tp(TYPE_FIXNUM, 64), \
+                             s_expr_tp(branch_1));
     s_expr* branch_2 = create_empty_s_expr();
-    branch_2 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 2048), \
-                             create_s_expr_tp(branch_2));
-    branch_2 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 1024), \
-                             create_s_expr_tp(branch_2));
-    branch_2 = create_s_expr(create_atom_tp(TYPE_FIXNUM, 512), \
-                             create_s_expr_tp(branch_2));
+    branch_2 = create_s_expr(atom_tp(TYPE_FIXNUM, 2048), \
+                             s_expr_tp(branch_2));
+    branch_2 = create_s_expr(atom_tp(TYPE_FIXNUM, 1024), \
+                             s_expr_tp(branch_2));
+    branch_2 = create_s_expr(atom_tp(TYPE_FIXNUM, 512), \
+                             s_expr_tp(branch_2));
     se = create_empty_s_expr();
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 8192), create_s_expr_tp(se));
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 4096), create_s_expr_tp(se));
-    se = create_s_expr(create_s_expr_tp(branch_2), create_s_expr_tp(se));
-    se = create_s_expr(create_s_expr_tp(branch_1), create_s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 8192), s_expr_tp(se));
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 4096), s_expr_tp(se));
+    se = create_s_expr(s_expr_tp(branch_2), s_expr_tp(se));
+    se = create_s_expr(s_expr_tp(branch_1), s_expr_tp(se));
     delete_s_expr_recursive(se, true);
     print_test_result(true);
     te->passed++; // if it runs (and produces no valgrind errors) it passes
@@ -381,6 +492,40 @@ void test_delete_s_expr_recursive(test_env* te) {
     return;
 }
 
+void test_delete_s_expr(test_env* te) {
+    print_test_announce("delete_s_expr()");
+    bool pass = true;
+    long se_live_before = live_s_expr_count();
+    long tp_live_before = live_typed_ptr_count();
+    s_expr* cdr = create_empty_s_expr();
+    s_expr* first = create_s_expr(atom_tp(TYPE_FIXNUM, TEST_NUM), \
+                                  s_expr_tp(cdr));
+    if (live_s_expr_count() != se_live_before + 2 || \
+        live_typed_ptr_count() != tp_live_before) {
+        pass = false;
+    }
+    delete_s_expr(first); // does not touch the cdr's s-expression
+    if (live_s_expr_count() != se_live_before + 1 || !is_empty_list(cdr)) {
+        pass = false;
+    }
+    // a deleted s-expression is reused before any fresh storage
+    s_expr* second = create_empty_s_expr();
+    if (second != first || !is_empty_list(second)) {
+        pass = false;
+    }
+    delete_s_expr(second);
+    delete_s_expr(cdr);
+    if (live_s_expr_count() != se_live_before || \
+        live_typed_ptr_count() != tp_live_before) {
+        pass = false;
+    }
+    delete_s_expr(NULL); // no-op
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
 void test_create_string(test_env* te) {
     print_test_announce("create_string()");
     bool pass = true;
@@ -399,6 +544,113 @@ void test_create_string(test_env* te) {
     return;
 }
 
+void test_create_rope(test_env* te) {
+    print_test_announce("create_rope()");
+    bool pass = true;
+    String* left = create_string("test ");
+    String* right = create_string("string");
+    String* out = create_rope(left, share_string(right));
+    if (out == NULL || \
+        out->len != 11 || \
+        out->contents != NULL || \
+        out->left != left || \
+        out->right != right || \
+        out->refs != 1 || \
+        right->refs != 2) {
+        pass = false;
+    }
+    delete_string(out);
+    if (right->refs != 1) {
+        pass = false;
+    }
+    delete_string(right);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_string_contents(test_env* te) {
+    print_test_announce("string_contents()");
+    bool pass = true;
+    String* flat = create_string("test string");
+    if (string_contents(flat) != flat->contents || \
+        strcmp(string_contents(flat), "test string")) {
+        pass = false;
+    }
+    // ((a . (b . c)) . d)
+    String* inner = create_rope(create_string("b"), create_string("c"));
+    String* left = create_rope(create_string("a"), inner);
+    String* rope = create_rope(left, share_string(flat));
+    String* shared = share_string(rope);
+    if (strcmp(string_contents(rope), "abctest string") || \
+        rope->len != 14 || \
+        rope->left != NULL || \
+        rope->right != NULL || \
+        flat->refs != 1 || \
+        shared->contents != rope->contents) {
+        pass = false;
+    }
+    delete_string(shared);
+    delete_string(rope);
+    delete_string(flat);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_share_string(test_env* te) {
+    print_test_announce("share_string()");
+    bool pass = true;
+    String* str = create_string("test string");
+    String* out = share_string(str);
+    if (out != str || str->refs != 2) {
+        pass = false;
+    }
+    // deleting one owner leaves the string intact for the other
+    delete_string(str);
+    if (out->refs != 1 || strcmp(out->contents, "test string")) {
+        pass = false;
+    }
+    delete_string(out);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
+void test_unshare_string(test_env* te) {
+    print_test_announce("unshare_string()");
+    bool pass = true;
+    // a string with a single owner is already safe to modify
+    String* str = create_string("test string");
+    String* out = unshare_string(str);
+    if (out != str || out->refs != 1) {
+        pass = false;
+    }
+    // a shared string is copied, and the original loses an owner
+    share_string(str);
+    out = unshare_string(str);
+    if (out == str || \
+        out->refs != 1 || \
+        str->refs != 1 || \
+        out->len != str->len || \
+        strcmp(out->contents, str->contents)) {
+        pass = false;
+    }
+    out->contents[0] = 'b';
+    if (strcmp(str->contents, "test string")) {
+        pass = false;
+    }
+    delete_string(out);
+    delete_string(str);
+    print_test_result(pass);
+    te->passed += pass;
+    te->run++;
+    return;
+}
+
 // smoke & Valgrind test
 void test_delete_string(test_env* te) {
     print_test_announce("delete_string()");
@@ -417,20 +669,20 @@ void test_s_expr_next(test_env* te) {
     int second_value = 128;
     int third_value = 256;
     int fourth_value = 512;
-    typed_ptr* first_atom = create_atom_tp(TYPE_FIXNUM, first_value);
-    typed_ptr* second_atom = create_atom_tp(TYPE_FIXNUM, second_value);
-    typed_ptr* third_atom = create_atom_tp(TYPE_FIXNUM, third_value);
-    typed_ptr* fourth_atom = create_atom_tp(TYPE_FIXNUM, fourth_value);
-    typed_ptr* atom_list[] = {first_atom, second_atom, third_atom, fourth_atom};
+    typed_ptr first_atom = atom_tp(TYPE_FIXNUM, first_value);
+    typed_ptr second_atom = atom_tp(TYPE_FIXNUM, second_value);
+    typed_ptr third_atom = atom_tp(TYPE_FIXNUM, third_value);
+    typed_ptr fourth_atom = atom_tp(TYPE_FIXNUM, fourth_value);
+    typed_ptr atom_list[] = {first_atom, second_atom, third_atom, fourth_atom};
     s_expr* se = create_empty_s_expr();
-    se = create_s_expr(fourth_atom, create_s_expr_tp(se));
-    se = create_s_expr(third_atom, create_s_expr_tp(se));
-    se = create_s_expr(second_atom, create_s_expr_tp(se));
-    se = create_s_expr(first_atom, create_s_expr_tp(se));
+    se = create_s_expr(fourth_atom, s_expr_tp(se));
+    se = create_s_expr(third_atom, s_expr_tp(se));
+    se = create_s_expr(second_atom, s_expr_tp(se));
+    se = create_s_expr(first_atom, s_expr_tp(se));
     bool pass = true;
     s_expr* curr_se = se;
     for (unsigned int idx = 0; idx < 4; idx++) {
-        if (!match_typed_ptrs(curr_se->car, atom_list[idx])) {
+        if (!match_typed_ptrs(&curr_se->car, &atom_list[idx])) {
             pass = false;
         }
         curr_se = s_expr_next(curr_se);
@@ -452,13 +704,12 @@ void test_is_empty_list(test_env* te) {
     if (!is_empty_list(se)) {
         pass = false;
     }
-    se->car = create_atom_tp(TYPE_FIXNUM, 64);
-    se->cdr = create_atom_tp(TYPE_FIXNUM, 128);
+    se->car = atom_tp(TYPE_FIXNUM, 64);
+    se->cdr = atom_tp(TYPE_FIXNUM, 128);
     if (is_empty_list(se)) {
         pass = false;
     }
-    free(se->cdr);
-    se->cdr = create_s_expr_tp(create_empty_s_expr());
+    se->cdr = s_expr_tp(create_empty_s_expr());
     if (is_empty_list(se)) {
         pass = false;
     }
@@ -489,7 +740,7 @@ void test_is_false_literal(test_env* te) {
     if (is_false_literal(tp)) {
         pass = false;
     }
-    free(tp);
+    delete_typed_ptr(tp);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -503,14 +754,13 @@ void test_is_pair(test_env* te) {
     if (is_pair(se)) {
         pass = false;
     }
-    free(se);
-    se = create_s_expr(create_atom_tp(TYPE_FIXNUM, 64), \
-                       create_atom_tp(TYPE_FIXNUM, 128));
+    delete_s_expr(se);
+    se = create_s_expr(atom_tp(TYPE_FIXNUM, 64), \
+                       atom_tp(TYPE_FIXNUM, 128));
     if (!is_pair(se)) {
         pass = false;
     }
-    free(se->cdr);
-    se->cdr = create_s_expr_tp(create_empty_s_expr());
+    se->cdr = s_expr_tp(create_empty_s_expr());
     if (is_pair(se)) {
         pass = false;
     }
@@ -13,11 +13,19 @@ void test_create_void_tp(test_env* te);
 void test_create_s_expr_tp(test_env* te);
 void test_create_string_tp(test_env* te);
 void test_copy_typed_ptr(test_env* te);
+void test_delete_typed_ptr(test_env* te);
 void test_create_s_expr(test_env* te);
 void test_create_empty_s_expr(test_env* te);
 void test_copy_s_expr(test_env* te);
+void test_share_s_expr(test_env* te);
+void test_share_value(test_env* te);
 void test_delete_s_expr_recursive(test_env* te);
+void test_delete_s_expr(test_env* te);
 void test_create_string(test_env* te);
+void test_create_rope(test_env* te);
+void test_string_contents(test_env* te);
+void test_share_string(test_env* te);
+void test_unshare_string(test_env* te);
 void test_delete_string(test_env* te);
 void test_s_expr_next(test_env* te);
 void test_is_empty_list(test_env* te);
@@ -25,7 +25,7 @@ void test_create_s_expr_stack(test_env* te) {
         stack->next != NULL) {
         pass = false;
     }
-    free(se);
+    delete_s_expr(se);
     free(stack);
     print_test_result(pass);
     te->passed += pass;
@@ -63,8 +63,8 @@ void test_s_expr_stack_push_pop(test_env* te) {
     if (stack != NULL) {
         pass = false;
     }
-    free(se_1);
-    free(se_2);
+    delete_s_expr(se_1);
+    delete_s_expr(se_2);
     // freeing the stack nodes was taken care of by s_expr_stack_pop()
     print_test_result(pass);
     te->passed += pass;
@@ -83,14 +83,13 @@ void test_init_new_s_expr(test_env* te) {
         stack->next == NULL || \
         stack->next->se != se_1 || \
         stack->next->next != NULL || \
-        stack->next->se->car == NULL || \
-        stack->next->se->car->ptr.se_ptr != stack->se || \
-        stack->next->se->cdr != NULL) {
+        stack->next->se->car.type == TYPE_NONE || \
+        stack->next->se->car.ptr.se_ptr != stack->se || \
+        stack->next->se->cdr.type != TYPE_NONE) {
         pass = false;
     }
-    free(stack->se);
-    free(se_1->car);
-    free(se_1);
+    delete_s_expr(stack->se);
+    delete_s_expr(se_1);
     free(stack->next);
     free(stack);
     print_test_result(pass);
@@ -110,14 +109,13 @@ void test_extend_s_expr(test_env* te) {
         stack->next == NULL || \
         stack->next->se != se_1 || \
         stack->next->next != NULL || \
-        stack->next->se->car != NULL || \
-        stack->next->se->cdr == NULL || \
-        stack->next->se->cdr->ptr.se_ptr != stack->se) {
+        stack->next->se->car.type != TYPE_NONE || \
+        stack->next->se->cdr.type == TYPE_NONE || \
+        stack->next->se->cdr.ptr.se_ptr != stack->se) {
         pass = false;
     }
-    free(stack->se);
-    free(se_1->cdr);
-    free(se_1);
+    delete_s_expr(stack->se);
+    delete_s_expr(se_1);
     free(stack->next);
     free(stack);
     print_test_result(pass);
@@ -139,15 +137,14 @@ void test_terminate_s_expr(test_env* te) {
     }
     err = PARSE_ERROR_NONE;
     // passing in a stack with a pair on top -> parse error
-    s_expr* se = create_s_expr(NULL, create_atom_tp(TYPE_FIXNUM, 1000));
+    s_expr* se = create_s_expr(none_tp(), atom_tp(TYPE_FIXNUM, 1000));
     s_expr_stack_push(&stack, se);
     out = terminate_s_expr(&stack, &err);
     if (out != PARSE_ERROR || \
         err != PARSE_ERROR_UNBAL_PAREN) {
         pass = false;
     }
-    free(se->cdr);
-    free(se);
+    delete_s_expr(se);
     free(stack);
     stack = NULL;
     err = PARSE_ERROR_NONE;
@@ -161,23 +158,22 @@ void test_terminate_s_expr(test_env* te) {
         !is_empty_list(se)) {
         pass = false;
     }
-    free(se);
+    delete_s_expr(se);
     // passing in stack of one partial s-expr -> finish s-expr, parse is done
-    typed_ptr* test_atom = create_atom_tp(TYPE_FIXNUM, 1000);
-    se = create_s_expr(test_atom, NULL);
+    typed_ptr test_atom = atom_tp(TYPE_FIXNUM, 1000);
+    se = create_s_expr(test_atom, none_tp());
     s_expr_stack_push(&stack, se);
     out = terminate_s_expr(&stack, &err);
     if (stack != NULL || \
         out != PARSE_FINISH || \
         err != PARSE_ERROR_NONE || \
-        !match_typed_ptrs(se->car, test_atom) || \
-        se->cdr == NULL || \
-        !is_empty_list(se->cdr->ptr.se_ptr)) {
+        !match_typed_ptrs(&se->car, &test_atom) || \
+        se->cdr.type == TYPE_NONE || \
+        !is_empty_list(se->cdr.ptr.se_ptr)) {
         pass = false;
     }
     delete_s_expr_recursive(se, true);
     // passing in stack of a nested s-expr -> return to spine, parse can proceed
-    test_atom = create_atom_tp(TYPE_FIXNUM, 1000);
     se = create_empty_s_expr();
     s_expr_stack_push(&stack, se);
     init_new_s_expr(&stack);
@@ -188,13 +184,13 @@ void test_terminate_s_expr(test_env* te) {
         err != PARSE_ERROR_NONE || \
         stack->next != NULL || \
         stack->se != se || \
-        se->car == NULL || \
-        se->car->ptr.se_ptr->car != test_atom || \
-        se->cdr != NULL) {
+        se->car.type == TYPE_NONE || \
+        !match_typed_ptrs(&se->car.ptr.se_ptr->car, &test_atom) || \
+        se->cdr.type != TYPE_NONE) {
         pass = false;
     }
     s_expr_stack_pop(&stack);
-    se->cdr = create_s_expr_tp(create_empty_s_expr());
+    se->cdr = s_expr_tp(create_empty_s_expr());
     delete_s_expr_recursive(se, true);
     print_test_result(pass);
     te->passed += pass;
@@ -205,7 +201,6 @@ void test_terminate_s_expr(test_env* te) {
 void test_register_symbol(test_env* te) {
     print_test_announce("register_symbol()");
     Environment* env = create_environment(0, 0, NULL);
-    Environment* temp_env = create_environment(10, 0, NULL);
     s_expr_stack* stack = NULL;
     s_expr_stack_push(&stack, create_empty_s_expr());
     bool pass = true;
@@ -215,10 +210,10 @@ void test_register_symbol(test_env* te) {
     snprintf(symbol_num_low, 100, "%ld", LONG_MIN);
     symbol_num_low[strlen(symbol_num_low) + 1] = '\0';
     symbol_num_low[strlen(symbol_num_low)] = '0';
-    out = register_symbol(&stack, env, temp_env, symbol_num_low);
+    out = register_symbol(&stack, env, symbol_num_low);
     if (out != PARSE_ERROR_INT_TOO_LOW || \
         stack->se == NULL || \
-        stack->se->car != NULL) {
+        stack->se->car.type != TYPE_NONE) {
         pass = false;
     }
     // passing a number too large
@@ -226,107 +221,92 @@ void test_register_symbol(test_env* te) {
     snprintf(symbol_num_high, 100, "%ld", LONG_MAX);
     symbol_num_high[strlen(symbol_num_high) + 1] = '\0';
     symbol_num_high[strlen(symbol_num_high)] = '0';
-    out = register_symbol(&stack, env, temp_env, symbol_num_high);
+    out = register_symbol(&stack, env, symbol_num_high);
     if (out != PARSE_ERROR_INT_TOO_HIGH || \
         stack->se == NULL || \
-        stack->se->car != NULL) {
+        stack->se->car.type != TYPE_NONE) {
         pass = false;
     }
     // passing a valid number
     char literal_num[] = "1000";
-    out = register_symbol(&stack, env, temp_env, literal_num);
+    out = register_symbol(&stack, env, literal_num);
     typed_ptr* expected_tp = create_number_tp(1000);
     if (out != PARSE_ERROR_NONE || \
         stack->se == NULL || \
-        stack->se->car == NULL || \
-        !match_typed_ptrs(stack->se->car, expected_tp) || \
-        symbol_lookup_name(env, literal_num) != NULL || \
-        symbol_lookup_name(temp_env, literal_num) != NULL) {
+        stack->se->car.type == TYPE_NONE || \
+        !match_typed_ptrs(&stack->se->car, expected_tp) || \
+        symbol_lookup_name(env, literal_num) != NULL) {
         pass = false;
     }
-    free(stack->se->car);
-    stack->se->car = NULL;
-    free(expected_tp);
+    stack->se->car = none_tp();
+    delete_typed_ptr(expected_tp);
     // passing boolean literals
     char literal_bool_true[] = "#t";
-    out = register_symbol(&stack, env, temp_env, literal_bool_true);
+    out = register_symbol(&stack, env, literal_bool_true);
     expected_tp = create_atom_tp(TYPE_BOOL, true);
     if (out != PARSE_ERROR_NONE || \
         stack->se == NULL || \
-        stack->se->car == NULL || \
-        !match_typed_ptrs(stack->se->car, expected_tp) || \
-        symbol_lookup_name(env, literal_bool_true) != NULL || \
-        symbol_lookup_name(temp_env, literal_bool_true) != NULL) {
+        stack->se->car.type == TYPE_NONE || \
+        !match_typed_ptrs(&stack->se->car, expected_tp) || \
+        symbol_lookup_name(env, literal_bool_true) != NULL) {
         pass = false;
     }
-    free(stack->se->car);
-    stack->se->car = NULL;
-    free(expected_tp);
+    stack->se->car = none_tp();
+    delete_typed_ptr(expected_tp);
     char literal_bool_false[] = "#f";
-    out = register_symbol(&stack, env, temp_env, literal_bool_false);
+    out = register_symbol(&stack, env, literal_bool_false);
     expected_tp = create_atom_tp(TYPE_BOOL, false);
     if (out != PARSE_ERROR_NONE || \
         stack->se == NULL || \
-        stack->se->car == NULL || \
-        !match_typed_ptrs(stack->se->car, expected_tp) || \
-        symbol_lookup_name(env, literal_bool_false) != NULL || \
-        symbol_lookup_name(temp_env, literal_bool_false) != NULL) {
+        stack->se->car.type == TYPE_NONE || \
+        !match_typed_ptrs(&stack->se->car, expected_tp) || \
+        symbol_lookup_name(env, literal_bool_false) != NULL) {
         pass = false;
     }
-    free(stack->se->car);
-    stack->se->car = NULL;
-    free(expected_tp);
+    stack->se->car = none_tp();
+    delete_typed_ptr(expected_tp);
     // passing a symbol already in env
     char symbol_env[] = "in-env";
     typed_ptr thousand = {.type=TYPE_FIXNUM, .ptr={.idx=1000}};
     typed_ptr* symbol_env_tp = install_symbol(env, symbol_env, &thousand);
-    out = register_symbol(&stack, env, temp_env, symbol_env);
+    out = register_symbol(&stack, env, symbol_env);
     if (out != PARSE_ERROR_NONE || \
         stack->se == NULL || \
-        stack->se->car == NULL || \
-        !match_typed_ptrs(stack->se->car, symbol_env_tp) || \
-        symbol_lookup_name(temp_env, symbol_env) != NULL) {
-        pass = false;
-    }
-    free(symbol_env_tp);
-    free(stack->se->car);
-    stack->se->car = NULL;
-    // passing a symbol already in temp_env
-    char symbol_temp_env[] = "in-temp-env";
-    typed_ptr* symbol_temp_env_tp = install_symbol(temp_env, \
-                                                   symbol_temp_env, \
-                                                   &thousand);
-    out = register_symbol(&stack, env, temp_env, symbol_temp_env);
-    if (out != PARSE_ERROR_NONE || \
-        stack->se == NULL || \
-        stack->se->car == NULL || \
-        !match_typed_ptrs(stack->se->car, symbol_temp_env_tp) || \
-        symbol_lookup_name(env, symbol_temp_env) != NULL) {
+        stack->se->car.type == TYPE_NONE || \
+        !match_typed_ptrs(&stack->se->car, symbol_env_tp) || \
+        env->symbol_table->length != 1) {
         pass = false;
     }
-    free(symbol_temp_env_tp);
-    free(stack->se->car);
-    stack->se->car = NULL;
-    // passing a symbol in neither environment
+    delete_typed_ptr(symbol_env_tp);
+    stack->se->car = none_tp();
+    // passing a symbol not yet in env
     char symbol_absent[] = "absent";
-    out = register_symbol(&stack, env, temp_env, symbol_absent);
-    Symbol_Node* sn_from_string = symbol_lookup_name(temp_env, symbol_absent);
-    Symbol_Node* sn_from_index = symbol_lookup_index(temp_env, stack->se->car);
+    out = register_symbol(&stack, env, symbol_absent);
+    Symbol_Node* sn_from_string = symbol_lookup_name(env, symbol_absent);
+    Symbol_Node* sn_from_index = symbol_lookup_index(env, &stack->se->car);
     if (out != PARSE_ERROR_NONE || \
         stack->se == NULL || \
-        stack->se->car == NULL || \
-        symbol_lookup_name(env, symbol_absent) != NULL || \
+        stack->se->car.type != TYPE_SYMBOL || \
+        env->symbol_table->length != 2 || \
         sn_from_string == NULL || \
         sn_from_string != sn_from_index || \
         strcmp(sn_from_index->name, symbol_absent) || \
         sn_from_index->type != TYPE_UNDEF) {
         pass = false;
     }
-    free(stack->se->car);
-    free(stack->se);
+    // passing the same new symbol again gives the same symbol number
+    typed_ptr absent_tp = stack->se->car;
+    stack->se->car = none_tp();
+    out = register_symbol(&stack, env, symbol_absent);
+    if (out != PARSE_ERROR_NONE || \
+        stack->se == NULL || \
+        !match_typed_ptrs(&stack->se->car, &absent_tp) || \
+        env->symbol_table->length != 2) {
+        pass = false;
+    }
+    delete_s_expr(stack->se);
     free(stack);
     delete_environment(env);
-    delete_environment(temp_env);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -486,8 +466,8 @@ bool test_parse_output(const char cmd[], typed_ptr* expected) {
     if (expected->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(expected->ptr.se_ptr, true);
     }
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     delete_environment(env);
     return pass;
 }
@@ -599,8 +579,8 @@ void test_parse(test_env* te) {
     sublist = create_empty_s_expr();
     s_expr_append(sublist, create_atom_tp(TYPE_SYMBOL, 0));
     s_expr_append(sublist, create_atom_tp(TYPE_SYMBOL, 0));
-    sublist = create_s_expr(create_s_expr_tp(sublist), \
-                            create_s_expr_tp(create_empty_s_expr()));
+    sublist = create_s_expr(s_expr_tp(sublist), \
+                            s_expr_tp(create_empty_s_expr()));
     s_expr_append(sublist, create_atom_tp(TYPE_SYMBOL, 0));
     expected = create_s_expr_tp(create_empty_s_expr());
     s_expr_append(expected->ptr.se_ptr, create_s_expr_tp(sublist));
@@ -645,7 +625,7 @@ void test_parse(test_env* te) {
     if (out != NULL && out->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(out->ptr.se_ptr, true);
     }
-    free(out);
+    delete_typed_ptr(out);
     // "()"
     out = parse("()", env);
     if (env->symbol_table->length != 0 || \
@@ -655,7 +635,7 @@ void test_parse(test_env* te) {
     if (out != NULL && out->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(out->ptr.se_ptr, true);
     }
-    free(out);
+    delete_typed_ptr(out);
     // "(a)"
     out = parse("(a)", env);
     if (env->symbol_table->length != 1 || \
@@ -666,7 +646,7 @@ void test_parse(test_env* te) {
     if (out != NULL && out->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(out->ptr.se_ptr, true);
     }
-    free(out);
+    delete_typed_ptr(out);
     // "(a b)"
     out = parse("(a b)", env);
     if (env->symbol_table->length != 2 || \
@@ -679,7 +659,7 @@ void test_parse(test_env* te) {
     if (out != NULL && out->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(out->ptr.se_ptr, true);
     }
-    free(out);
+    delete_typed_ptr(out);
     // "(a b c"
     out = parse("(a b c", env);
     if (env->symbol_table->length != 2 || \
@@ -692,7 +672,7 @@ void test_parse(test_env* te) {
     if (out != NULL && out->type == TYPE_S_EXPR) {
         delete_s_expr_recursive(out->ptr.se_ptr, true);
     }
-    free(out);
+    delete_typed_ptr(out);
     // '("str1" d "str2"e "str)3" f"str\"4")'
     char str_test[] = "(\"str1\" a \"str2\"b \"str)3\" c\"str\\\"4\")";
     s_expr* expected_se = unit_list(create_string_tp(create_string("str1")));
@@ -27,19 +27,19 @@ void test_check_error(test_env* te) {
     if (check_error(tp, TEST_ERROR_DUMMY)) {
         pass = false;
     }
-    free(tp);
+    delete_typed_ptr(tp);
     // check(<error>, <different error>) -> false
     tp = create_error_tp(TEST_ERROR_DUMMY);
     if (check_error(tp, PARSE_ERROR_NONE)) {
         pass = false;
     }
-    free(tp);
+    delete_typed_ptr(tp);
     // check(<error>, <same error>) -> false
     tp = create_error_tp(TEST_ERROR_DUMMY);
     if (!check_error(tp, TEST_ERROR_DUMMY)) {
         pass = false;
     }
-    free(tp);
+    delete_typed_ptr(tp);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -57,79 +57,79 @@ void test_match_typed_ptrs(test_env* te) {
     first = create_number_tp(1);
     second = NULL;
     pass = !match_typed_ptrs(first, second) && pass;
-    free(first);
+    delete_typed_ptr(first);
     // match(NULL, <something>) -> false
     first = NULL;
     second = create_number_tp(1);
     pass = !match_typed_ptrs(first, second) && pass;
-    free(second);
+    delete_typed_ptr(second);
     // match(<number>, <bool>) -> false
     first = create_number_tp(1);
     second = create_atom_tp(TYPE_BOOL, 1);
     pass = !match_typed_ptrs(first, second) && pass;
-    free(first);
-    free(second);
+    delete_typed_ptr(first);
+    delete_typed_ptr(second);
     // match(<s-expr>, <same s-expr>) -> true
     first = create_s_expr_tp(unit_list(create_number_tp(1)));
     second = create_s_expr_tp(first->ptr.se_ptr);
     pass = match_typed_ptrs(first, second) && pass;
     delete_s_expr_recursive(first->ptr.se_ptr, true);
-    free(first);
-    free(second);
+    delete_typed_ptr(first);
+    delete_typed_ptr(second);
     // match(<s-expr>, <copied s-expr>) -> false
     first = create_s_expr_tp(unit_list(create_number_tp(1)));
     second = create_s_expr_tp(unit_list(create_number_tp(1)));
     pass = !match_typed_ptrs(first, second) && pass;
     delete_s_expr_recursive(first->ptr.se_ptr, true);
-    free(first);
+    delete_typed_ptr(first);
     delete_s_expr_recursive(second->ptr.se_ptr, true);
-    free(second);
+    delete_typed_ptr(second);
     // match(<number>, <copied number>) -> true
     first = create_number_tp(1);
     second = create_number_tp(1);
     pass = match_typed_ptrs(first, second) && pass;
-    free(first);
-    free(second);
+    delete_typed_ptr(first);
+    delete_typed_ptr(second);
     // match("", "") -> true
     first = create_string_tp(create_string(""));
     second = create_string_tp(create_string(""));
     pass = match_typed_ptrs(first, second) && pass;
     delete_string(first->ptr.string);
-    free(first);
+    delete_typed_ptr(first);
     delete_string(second->ptr.string);
-    free(second);
+    delete_typed_ptr(second);
     // match("", "hello") -> false
     first = create_string_tp(create_string(""));
     second = create_string_tp(create_string("hello"));
     pass = !match_typed_ptrs(first, second) && pass;
     delete_string(first->ptr.string);
-    free(first);
+    delete_typed_ptr(first);
     delete_string(second->ptr.string);
-    free(second);
+    delete_typed_ptr(second);
     // match("hello", "hello world") -> false
     first = create_string_tp(create_string("hello"));
     second = create_string_tp(create_string("hello world"));
     pass = !match_typed_ptrs(first, second) && pass;
     delete_string(first->ptr.string);
-    free(first);
+    delete_typed_ptr(first);
     delete_string(second->ptr.string);
-    free(second);
+    delete_typed_ptr(second);
     // match("hello", "world") -> false
     first = create_string_tp(create_string("hello"));
     second = create_string_tp(create_string("world"));
     pass = !match_typed_ptrs(first, second) && pass;
     delete_string(first->ptr.string);
-    free(first);
+    delete_typed_ptr(first);
     delete_string(second->ptr.string);
-    free(second);
+    delete_typed_ptr(second);
     // match("hello", "hello") -> true
     first = create_string_tp(create_string("hello"));
     second = create_string_tp(create_string("hello"));
     pass = match_typed_ptrs(first, second) && pass;
     delete_string(first->ptr.string);
-    free(first);
+    delete_typed_ptr(first);
     delete_string(second->ptr.string);
-    free(second);
+    delete_typed_ptr(second);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -173,24 +173,24 @@ void test_match_s_exprs(test_env* te) {
     delete_s_expr_recursive(second, true);
     // match('(1), <NULL car>) -> false
     first = unit_list(create_number_tp(1));
-    second = create_s_expr(NULL, create_number_tp(1));
+    second = create_s_expr(none_tp(), atom_tp(TYPE_FIXNUM, 1));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match(<NULL car>, '(1)) -> false
-    first = create_s_expr(NULL, create_number_tp(1));
+    first = create_s_expr(none_tp(), atom_tp(TYPE_FIXNUM, 1));
     second = unit_list(create_number_tp(1));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match('(1), <NULL cdr>) -> false
     first = unit_list(create_number_tp(1));
-    second = create_s_expr(create_number_tp(1), NULL);
+    second = create_s_expr(atom_tp(TYPE_FIXNUM, 1), none_tp());
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match(<NULL cdr>, '(1)) -> false
-    first = create_s_expr(create_number_tp(1), NULL);
+    first = create_s_expr(atom_tp(TYPE_FIXNUM, 1), none_tp());
     second = unit_list(create_number_tp(1));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
@@ -202,14 +202,14 @@ void test_match_s_exprs(test_env* te) {
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match('(1 . 1), '(1 . #t)) -> false
-    first = create_s_expr(create_number_tp(1), create_number_tp(1));
-    second = create_s_expr(create_number_tp(1), create_atom_tp(TYPE_BOOL, 1));
+    first = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_FIXNUM, 1));
+    second = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_BOOL, 1));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match('(1 . 2), '(1 . 2)) -> true
-    first = create_s_expr(create_number_tp(1), create_number_tp(2));
-    second = create_s_expr(create_number_tp(1), create_number_tp(2));
+    first = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_FIXNUM, 2));
+    second = create_s_expr(atom_tp(TYPE_FIXNUM, 1), atom_tp(TYPE_FIXNUM, 2));
     pass = match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
@@ -244,15 +244,17 @@ void test_match_s_exprs(test_env* te) {
     s_expr_append(first, create_number_tp(2));
     s_expr_append(first, create_number_tp(3));
     second = unit_list(create_number_tp(1));
-    s_expr_append(second, create_s_expr_tp(create_s_expr(create_number_tp(2), \
-                                                         create_number_tp(3))));
+    s_expr_append(second, \
+                  create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                                                 atom_tp(TYPE_FIXNUM, 3))));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match('(1 2 . 3), '(1 2 3)) -> false
     first = unit_list(create_number_tp(1));
-    s_expr_append(first, create_s_expr_tp(create_s_expr(create_number_tp(2), \
-                                                        create_number_tp(3))));
+    s_expr_append(first, \
+                  create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                                                 atom_tp(TYPE_FIXNUM, 3))));
     second = unit_list(create_number_tp(1));
     s_expr_append(second, create_number_tp(2));
     s_expr_append(second, create_number_tp(3));
@@ -261,11 +263,13 @@ void test_match_s_exprs(test_env* te) {
     delete_s_expr_recursive(second, true);
     // match('(1 2 . 3), '(1 2 . 3)) -> true
     first = unit_list(create_number_tp(1));
-    s_expr_append(first, create_s_expr_tp(create_s_expr(create_number_tp(2), \
-                                                        create_number_tp(3))));
+    s_expr_append(first, \
+                  create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                                                 atom_tp(TYPE_FIXNUM, 3))));
     second = unit_list(create_number_tp(1));
-    s_expr_append(second, create_s_expr_tp(create_s_expr(create_number_tp(2), \
-                                                         create_number_tp(3))));
+    s_expr_append(second, \
+                  create_s_expr_tp(create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                                                 atom_tp(TYPE_FIXNUM, 3))));
     pass = match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
@@ -287,33 +291,33 @@ void test_match_s_exprs(test_env* te) {
     delete_s_expr_recursive(second, true);
     // match('((1 2 3) (4 5 6)), '((1 2 3) (4 5 6))) -> true
     first = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(first, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(6));
     second = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(second, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(6));
     pass = match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
     // match('((1 2 3) (4 5 6)), '((1 10 3) (4 5 6))) -> false
     first = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(first, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(6));
     second = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(10));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(10));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(second, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(6));
     pass = !match_s_exprs(first, second) && pass;
     delete_s_expr_recursive(first, true);
     delete_s_expr_recursive(second, true);
@@ -334,70 +338,70 @@ void test_deep_match_typed_ptrs(test_env* te) {
     first_tp = create_number_tp(1);
     second_tp = NULL;
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     // match(NULL, <something>) -> false
     first_tp = NULL;
     second_tp = create_number_tp(1);
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match(1, #t) -> false
     first_tp = create_number_tp(1);
     second_tp = create_atom_tp(TYPE_BOOL, 1);
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
-    free(first_tp);
-    free(second_tp);
+    delete_typed_ptr(first_tp);
+    delete_typed_ptr(second_tp);
     // match(1, 2) -> false
     first_tp = create_number_tp(1);
     second_tp = create_number_tp(2);
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
-    free(first_tp);
-    free(second_tp);
+    delete_typed_ptr(first_tp);
+    delete_typed_ptr(second_tp);
     // match(1, 1) -> true
     first_tp = create_number_tp(1);
     second_tp = create_number_tp(1);
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
-    free(first_tp);
-    free(second_tp);
+    delete_typed_ptr(first_tp);
+    delete_typed_ptr(second_tp);
     // match("", "") -> true
     first_tp = create_string_tp(create_string(""));
     second_tp = create_string_tp(create_string(""));
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_string(first_tp->ptr.string);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_string(second_tp->ptr.string);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match("", "hello") -> false
     first_tp = create_string_tp(create_string(""));
     second_tp = create_string_tp(create_string("hello"));
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_string(first_tp->ptr.string);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_string(second_tp->ptr.string);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match("hello", "hello world") -> false
     first_tp = create_string_tp(create_string("hello"));
     second_tp = create_string_tp(create_string("hello world"));
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_string(first_tp->ptr.string);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_string(second_tp->ptr.string);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match("hello", "world") -> false
     first_tp = create_string_tp(create_string("hello"));
     second_tp = create_string_tp(create_string("world"));
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_string(first_tp->ptr.string);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_string(second_tp->ptr.string);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match("hello", "hello") -> true
     first_tp = create_string_tp(create_string("hello"));
     second_tp = create_string_tp(create_string("hello"));
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_string(first_tp->ptr.string);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_string(second_tp->ptr.string);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match('(), '()) -> true
     s_expr* first = create_empty_s_expr();
     s_expr* second = create_empty_s_expr();
@@ -405,9 +409,9 @@ void test_deep_match_typed_ptrs(test_env* te) {
     second_tp = create_s_expr_tp(second);
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_s_expr_recursive(first, true);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_s_expr_recursive(second, true);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match('(1 2 3 "hello"), '(1 2 3 "hello")) -> true
     first = unit_list(create_number_tp(1));
     s_expr_append(first, create_number_tp(2));
@@ -421,49 +425,49 @@ void test_deep_match_typed_ptrs(test_env* te) {
     second_tp = create_s_expr_tp(second);
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_s_expr_recursive(first, true);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_s_expr_recursive(second, true);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match('((1 2 3) (4 5 6)), '((1 2 3) (4 5 6))) -> true
     first = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(first, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(6));
     first_tp = create_s_expr_tp(first);
     second = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(second, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(6));
     second_tp = create_s_expr_tp(second);
     pass = deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_s_expr_recursive(first, true);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_s_expr_recursive(second, true);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     // match('((1 2 3) (4 5 6)), '((1 10 3) (4 5 6))) -> false
     first = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(2));
-    s_expr_append(first->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(2));
+    s_expr_append(first->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(first, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(first)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(first)->car.ptr.se_ptr, create_number_tp(6));
     first_tp = create_s_expr_tp(first);
     second = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(10));
-    s_expr_append(second->car->ptr.se_ptr, create_number_tp(3));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(10));
+    s_expr_append(second->car.ptr.se_ptr, create_number_tp(3));
     s_expr_append(second, create_s_expr_tp(unit_list(create_number_tp(4))));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(5));
-    s_expr_append(s_expr_next(second)->car->ptr.se_ptr, create_number_tp(6));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(5));
+    s_expr_append(s_expr_next(second)->car.ptr.se_ptr, create_number_tp(6));
     second_tp = create_s_expr_tp(second);
     pass = !deep_match_typed_ptrs(first_tp, second_tp) && pass;
     delete_s_expr_recursive(first, true);
-    free(first_tp);
+    delete_typed_ptr(first_tp);
     delete_s_expr_recursive(second, true);
-    free(second_tp);
+    delete_typed_ptr(second_tp);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -475,15 +479,15 @@ void test_unit_list(test_env* te) {
     bool pass = true;
     // unit_list(create_number_tp(1)) -> '(1)
     s_expr* out = unit_list(create_number_tp(1));
-    s_expr* expected = create_s_expr(create_number_tp(1), \
-                                     create_s_expr_tp(create_empty_s_expr()));
+    s_expr* expected = create_s_expr(atom_tp(TYPE_FIXNUM, 1), \
+                                     s_expr_tp(create_empty_s_expr()));
     pass = match_s_exprs(out, expected) && pass;
     delete_s_expr_recursive(out, true);
     delete_s_expr_recursive(expected, true);
     // unit_list(create_s_expr_tp(unit_list(1))) -> '((1))
     out = unit_list(create_s_expr_tp(unit_list(create_number_tp(1))));
-    expected = create_s_expr(create_s_expr_tp(unit_list(create_number_tp(1))), \
-                             create_s_expr_tp(create_empty_s_expr()));
+    expected = create_s_expr(s_expr_tp(unit_list(create_number_tp(1))), \
+                             s_expr_tp(create_empty_s_expr()));
     pass = match_s_exprs(out, expected) && pass;
     delete_s_expr_recursive(out, true);
     delete_s_expr_recursive(expected, true);
@@ -513,9 +517,9 @@ void test_s_expr_append(test_env* te) {
     // append('(1), 2) -> '(1 2)
     out = unit_list(create_number_tp(1));
     s_expr_append(out, create_number_tp(2));
-    expected = create_s_expr(create_number_tp(2), \
-                             create_s_expr_tp(create_empty_s_expr()));
-    expected = create_s_expr(create_number_tp(1), create_s_expr_tp(expected));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 2), \
+                             s_expr_tp(create_empty_s_expr()));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 1), s_expr_tp(expected));
     pass = match_s_exprs(out, expected) && pass;
     delete_s_expr_recursive(out, true);
     delete_s_expr_recursive(expected, true);
@@ -524,11 +528,11 @@ void test_s_expr_append(test_env* te) {
     s_expr_append(out, create_number_tp(2));
     s_expr_append(out, create_number_tp(3));
     s_expr_append(out, create_number_tp(4));
-    expected = create_s_expr(create_number_tp(4), \
-                             create_s_expr_tp(create_empty_s_expr()));
-    expected = create_s_expr(create_number_tp(3), create_s_expr_tp(expected));
-    expected = create_s_expr(create_number_tp(2), create_s_expr_tp(expected));
-    expected = create_s_expr(create_number_tp(1), create_s_expr_tp(expected));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 4), \
+                             s_expr_tp(create_empty_s_expr()));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 3), s_expr_tp(expected));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 2), s_expr_tp(expected));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 1), s_expr_tp(expected));
     pass = match_s_exprs(out, expected) && pass;
     delete_s_expr_recursive(out, true);
     delete_s_expr_recursive(expected, true);
@@ -538,10 +542,10 @@ void test_s_expr_append(test_env* te) {
     s_expr* sublist = unit_list(create_number_tp(3));
     s_expr_append(sublist, create_number_tp(4));
     s_expr_append(out, create_s_expr_tp(sublist));
-    expected = create_s_expr(create_s_expr_tp(copy_s_expr(sublist)), \
-                             create_s_expr_tp(create_empty_s_expr()));
-    expected = create_s_expr(create_number_tp(2), create_s_expr_tp(expected));
-    expected = create_s_expr(create_number_tp(1), create_s_expr_tp(expected));
+    expected = create_s_expr(s_expr_tp(copy_s_expr(sublist)), \
+                             s_expr_tp(create_empty_s_expr()));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 2), s_expr_tp(expected));
+    expected = create_s_expr(atom_tp(TYPE_FIXNUM, 1), s_expr_tp(expected));
     pass = match_s_exprs(out, expected) && pass;
     delete_s_expr_recursive(out, true);
     delete_s_expr_recursive(expected, true);
@@ -558,20 +562,20 @@ void test_create_number_tp(test_env* te) {
     typed_ptr* out = create_number_tp(-10);
     typed_ptr* expected = create_typed_ptr(TYPE_FIXNUM, (tp_value){.idx=-10});
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     // 0
     out = create_number_tp(0);
     expected = create_typed_ptr(TYPE_FIXNUM, (tp_value){.idx=0});
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     // 10
     out = create_number_tp(10);
     expected = create_typed_ptr(TYPE_FIXNUM, (tp_value){.idx=10});
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     print_test_result(pass);
     te->passed += pass;
     te->run++;
@@ -594,18 +598,18 @@ void test_builtin_tp_from_name(test_env* te) {
     typed_ptr* out = builtin_tp_from_name(env, "test_builtin");
     typed_ptr* expected = create_atom_tp(TYPE_BUILTIN, 1000);
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     // get("test_number") -> NULL
     out = builtin_tp_from_name(env, "test_number");
     expected = NULL;
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
+    delete_typed_ptr(out);
     // get("test_absent") -> NULL
     out = builtin_tp_from_name(env, "test_absent");
     expected = NULL;
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
+    delete_typed_ptr(out);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;
@@ -629,19 +633,19 @@ void test_symbol_tp_from_name(test_env* te) {
     typed_ptr* out = symbol_tp_from_name(env, "test_builtin");
     typed_ptr* expected = create_atom_tp(TYPE_SYMBOL, 0);
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     // get("test_number") -> (TYPE_SYMBOL, 1)
     out = symbol_tp_from_name(env, "test_number");
     expected = create_atom_tp(TYPE_SYMBOL, 1);
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
-    free(expected);
+    delete_typed_ptr(out);
+    delete_typed_ptr(expected);
     // get("test_absent") -> NULL
     out = symbol_tp_from_name(env, "test_absent");
     expected = NULL;
     pass = match_typed_ptrs(out, expected) && pass;
-    free(out);
+    delete_typed_ptr(out);
     delete_environment(env);
     print_test_result(pass);
     te->passed += pass;